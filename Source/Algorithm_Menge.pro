@@ -9,6 +9,7 @@ QT       += core gui
 CONFIG += c++14
 
 QT += charts
+QT += concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -71,10 +72,15 @@ SOURCES += \
     menge_dialog_parameter_settings.cpp \
     machine_learning_interface.cpp \
     logger.cpp \
+    random_streams.cpp \
     dialog_algorithm_settings.cpp \
     dialog_start_algorithm.cpp \
     dialog_compare_learning_methods.cpp \
     timetable_tabu_search.cpp \
+    timetable_evaluator.cpp \
+    timetable_simulated_annealing.cpp \
+    training_data_store.cpp \
+    boosted_trees.cpp \
     timetable_instance_generator.cpp \
     dialog_instance_generator.cpp \
     C:/Users/hendr/Downloads/dlib-19.10/dlib-19.10/dlib/all/source.cpp \
@@ -92,10 +98,17 @@ HEADERS += \
     menge_dialog_parameter_settings.h \
     machine_learning_interface.h \
     logger.h \
+    random_streams.h \
     dialog_algorithm_settings.h \
     dialog_start_algorithm.h \
     dialog_compare_learning_methods.h \
     timetable_tabu_search.h \
+    timetable_evaluator.h \
+    timetable_search_strategy.h \
+    timetable_simulated_annealing.h \
+    training_data_store.h \
+    boosted_trees.h \
+    data_hash.h \
     timetable_instance_generator.h \
     dialog_instance_generator.h \
     scenario.h
@@ -0,0 +1,363 @@
+#include "boosted_trees.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <dlib/serialize.h>
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cstdint>
+
+namespace
+{
+    // Sum of the residuals and number of samples in a bin of a node
+    struct bin_statistics
+    {
+        double sum = 0.0;
+        int count = 0;
+    };
+
+    // Best split of a node on a feature: the samples with a bin <= 'bin' go to the left child (-1 if there is no useful split)
+    struct split
+    {
+        double gain = 0.0;
+        int feature = 0;
+        int bin = -1;
+    };
+
+    // Score of a node for the squared error with an L2-regularized leaf value: G^2 / (n + lambda)
+    double node_score(double sum, int count, double lambda)
+    {
+        return sum * sum / (count + lambda);
+    }
+
+    // Cut points of a feature (strictly increasing, at most nb_bins - 1): all distinct values if there are few of them,
+    // the quantiles otherwise. A value v falls into the bin with the number of cut points smaller than v, such that
+    // 'bin <= k' is equivalent to 'v <= cut point k'.
+    std::vector<double> cut_points(std::vector<double> values, int nb_bins)
+    {
+        std::sort(values.begin(), values.end());
+        std::vector<double> distinct_values(values);
+        distinct_values.erase(std::unique(distinct_values.begin(), distinct_values.end()), distinct_values.end());
+        if(static_cast<int>(distinct_values.size()) <= nb_bins)
+            return std::vector<double>(distinct_values.begin(), distinct_values.end() - 1);
+
+        std::vector<double> cuts;
+        const std::size_t nb_values = values.size();
+        for(int k = 1; k < nb_bins; ++k)
+        {
+            const double value = values[k * nb_values / nb_bins];
+            if(value < values.back() && (cuts.empty() || value > cuts.back()))
+                cuts.push_back(value);
+        }
+        return cuts;
+    }
+
+    // Run f(0), ..., f(n-1) on the global thread pool (the calling thread takes part), or sequentially if the work is small
+    template<typename F>
+    void for_each_index(int n, bool concurrent, const F& f)
+    {
+        if(!concurrent)
+        {
+            for(int i = 0; i < n; ++i)
+                f(i);
+            return;
+        }
+
+        std::vector<int> indices(std::max(n, 0));
+        std::iota(indices.begin(), indices.end(), 0);
+        QtConcurrent::blockingMap(indices, [&](int& i) { f(i); });
+    }
+
+    // Minimum number of (sample, feature) pairs for which the histograms are accumulated concurrently
+    constexpr long concurrent_work = 20000;
+}
+
+
+
+namespace ml
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    double boosted_trees::operator()(const dlib::matrix<double,0,1>& x) const
+    {
+        const int nb_internal = (1 << _depth) - 1;
+        const int *features = _features.data();
+        const double *thresholds = _thresholds.data();
+        const double *leaves = _leaves.data();
+
+        double value = _base;
+        for(int t = 0; t < _nb_trees; ++t, features += nb_internal, thresholds += nb_internal, leaves += nb_internal + 1)
+        {
+            int node = 0;
+            for(int level = 0; level < _depth; ++level)
+                node = 2 * node + 1 + (x(features[node]) > thresholds[node]);
+            value += leaves[node - nb_internal];
+        }
+        return value;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    double boosted_trees::lower_bound() const
+    {
+        const std::size_t nb_leaves = std::size_t(1) << _depth;
+        double bound = _base;
+        for(int t = 0; t < _nb_trees; ++t)
+            bound += *std::min_element(_leaves.begin() + t * nb_leaves, _leaves.begin() + (t + 1) * nb_leaves);
+        return bound;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void serialize(const boosted_trees& item, std::ostream& out)
+    {
+        const int version = 1;
+        dlib::serialize(version, out);
+
+        const boosted_trees_parameters& parameters = item._parameters;
+        dlib::serialize(parameters.nb_trees, out);
+        dlib::serialize(parameters.depth, out);
+        dlib::serialize(parameters.learning_rate, out);
+        dlib::serialize(parameters.lambda, out);
+        dlib::serialize(parameters.min_samples_leaf, out);
+        dlib::serialize(parameters.nb_bins, out);
+
+        dlib::serialize(item._nb_trees, out);
+        dlib::serialize(item._depth, out);
+        dlib::serialize(item._base, out);
+        dlib::serialize(item._features, out);
+        dlib::serialize(item._thresholds, out);
+        dlib::serialize(item._leaves, out);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void deserialize(boosted_trees& item, std::istream& in)
+    {
+        int version = 0;
+        dlib::deserialize(version, in);
+        if(version != 1)
+            throw dlib::serialization_error("Unexpected version found while deserializing ml::boosted_trees.");
+
+        boosted_trees_parameters& parameters = item._parameters;
+        dlib::deserialize(parameters.nb_trees, in);
+        dlib::deserialize(parameters.depth, in);
+        dlib::deserialize(parameters.learning_rate, in);
+        dlib::deserialize(parameters.lambda, in);
+        dlib::deserialize(parameters.min_samples_leaf, in);
+        dlib::deserialize(parameters.nb_bins, in);
+
+        dlib::deserialize(item._nb_trees, in);
+        dlib::deserialize(item._depth, in);
+        dlib::deserialize(item._base, in);
+        dlib::deserialize(item._features, in);
+        dlib::deserialize(item._thresholds, in);
+        dlib::deserialize(item._leaves, in);
+
+        // the depth is checked before the number of leaves is computed from it (the shift is undefined for large depths)
+        if(item._nb_trees < 0 || item._depth < 0 || item._depth > 12)
+            throw dlib::serialization_error("Inconsistent trees found while deserializing ml::boosted_trees.");
+
+        const std::size_t nb_leaves = std::size_t(1) << item._depth;
+        if(item._features.size() != item._nb_trees * (nb_leaves - 1)
+                || item._thresholds.size() != item._features.size()
+                || item._leaves.size() != item._nb_trees * nb_leaves)
+            throw dlib::serialization_error("Inconsistent trees found while deserializing ml::boosted_trees.");
+    }
+
+
+
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    boosted_trees_trainer::boosted_trees_trainer(const boosted_trees_parameters& parameters)
+    {
+        set_parameters(parameters);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void boosted_trees_trainer::set_parameters(const boosted_trees_parameters& parameters)
+    {
+        if(parameters.nb_trees < 1 || parameters.depth < 1 || parameters.depth > 12 || !(parameters.learning_rate > 0.0)
+                || !(parameters.lambda >= 0.0) || parameters.min_samples_leaf < 1 || parameters.nb_bins < 2 || parameters.nb_bins > 256)
+            throw std::runtime_error("Error in function ml::boosted_trees_trainer::set_parameters. \nInvalid hyperparameters.");
+
+        _parameters = parameters;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    boosted_trees boosted_trees_trainer::train(const std::vector<dlib::matrix<double,0,1>>& x, const std::vector<double>& y) const
+    {
+        if(x.empty() || x.size() != y.size())
+            throw std::runtime_error("Error in function ml::boosted_trees_trainer::train. \nInvalid training data.");
+
+        const int nb_samples = static_cast<int>(x.size());
+        const int nb_features = static_cast<int>(x[0].size());
+        for(const dlib::matrix<double,0,1>& sample : x)
+            if(sample.size() != nb_features)
+                throw std::runtime_error("Error in function ml::boosted_trees_trainer::train. \nThe samples have different numbers of features.");
+
+        const int nb_trees = _parameters.nb_trees;
+        const int depth = _parameters.depth;
+        const int nb_bins = _parameters.nb_bins;
+        const double lambda = _parameters.lambda;
+        const int nb_internal = (1 << depth) - 1;
+        const int nb_leaves = 1 << depth;
+        const bool concurrent = static_cast<long>(nb_samples) * nb_features >= concurrent_work;
+
+        // 1. bins of the features (feature by feature, such that a histogram is accumulated from contiguous memory)
+        std::vector<std::vector<double>> cuts(nb_features);
+        std::vector<std::uint8_t> bins(static_cast<std::size_t>(nb_features) * nb_samples);
+        for_each_index(nb_features, concurrent, [&](int f)
+        {
+            std::vector<double> values(nb_samples);
+            for(int i = 0; i < nb_samples; ++i)
+                values[i] = x[i](f);
+            cuts[f] = cut_points(values, nb_bins);
+
+            std::uint8_t *feature_bins = &bins[static_cast<std::size_t>(f) * nb_samples];
+            for(int i = 0; i < nb_samples; ++i)
+                feature_bins[i] = static_cast<std::uint8_t>(std::lower_bound(cuts[f].begin(), cuts[f].end(), values[i]) - cuts[f].begin());
+        });
+
+        // 2. boosting: every tree is fitted to the residuals of the previous trees
+        boosted_trees trees;
+        trees._parameters = _parameters;
+        trees._nb_trees = nb_trees;
+        trees._depth = depth;
+        trees._base = std::accumulate(y.begin(), y.end(), 0.0) / nb_samples;
+        trees._features.assign(static_cast<std::size_t>(nb_trees) * nb_internal, 0);
+        trees._thresholds.assign(static_cast<std::size_t>(nb_trees) * nb_internal, std::numeric_limits<double>::infinity());
+        trees._leaves.assign(static_cast<std::size_t>(nb_trees) * nb_leaves, 0.0);
+
+        std::vector<double> residuals(nb_samples);
+        for(int i = 0; i < nb_samples; ++i)
+            residuals[i] = y[i] - trees._base;
+
+        std::vector<int> nodes(nb_samples);                     // node of every sample in the current level
+        std::vector<bin_statistics> histograms(static_cast<std::size_t>(nb_features) * (nb_leaves / 2) * nb_bins);
+        std::vector<split> best_splits(static_cast<std::size_t>(nb_features) * (nb_leaves / 2));
+        std::vector<int> split_features(nb_leaves / 2);
+        std::vector<int> split_bins(nb_leaves / 2);
+        std::vector<double> leaf_sums(nb_leaves);
+        std::vector<int> leaf_counts(nb_leaves);
+
+        for(int t = 0; t < nb_trees; ++t)
+        {
+            int *features = &trees._features[static_cast<std::size_t>(t) * nb_internal];
+            double *thresholds = &trees._thresholds[static_cast<std::size_t>(t) * nb_internal];
+            double *leaves = &trees._leaves[static_cast<std::size_t>(t) * nb_leaves];
+
+            std::fill(nodes.begin(), nodes.end(), 0);
+            for(int level = 0; level < depth; ++level)
+            {
+                const int nb_nodes = 1 << level;
+
+                // 2a. histograms of the residuals and best split of every node, per feature
+                for_each_index(nb_features, concurrent, [&](int f)
+                {
+                    bin_statistics *histogram = &histograms[static_cast<std::size_t>(f) * nb_nodes * nb_bins];
+                    std::fill(histogram, histogram + nb_nodes * nb_bins, bin_statistics());
+                    const std::uint8_t *feature_bins = &bins[static_cast<std::size_t>(f) * nb_samples];
+                    for(int i = 0; i < nb_samples; ++i)
+                    {
+                        bin_statistics& statistics = histogram[nodes[i] * nb_bins + feature_bins[i]];
+                        statistics.sum += residuals[i];
+                        ++statistics.count;
+                    }
+
+                    const int nb_feature_bins = static_cast<int>(cuts[f].size()) + 1;
+                    for(int node = 0; node < nb_nodes; ++node)
+                    {
+                        const bin_statistics *node_histogram = histogram + node * nb_bins;
+                        double total_sum = 0.0;
+                        int total_count = 0;
+                        for(int b = 0; b < nb_feature_bins; ++b)
+                        {
+                            total_sum += node_histogram[b].sum;
+                            total_count += node_histogram[b].count;
+                        }
+
+                        split best;
+                        best.feature = f;
+                        double left_sum = 0.0;
+                        int left_count = 0;
+                        for(int b = 0; b + 1 < nb_feature_bins; ++b)
+                        {
+                            left_sum += node_histogram[b].sum;
+                            left_count += node_histogram[b].count;
+                            const int right_count = total_count - left_count;
+                            if(left_count < _parameters.min_samples_leaf)
+                                continue;
+                            if(right_count < _parameters.min_samples_leaf)
+                                break;
+
+                            const double gain = node_score(left_sum, left_count, lambda) + node_score(total_sum - left_sum, right_count, lambda)
+                                                - node_score(total_sum, total_count, lambda);
+                            if(gain > best.gain)
+                            {
+                                best.gain = gain;
+                                best.bin = b;
+                            }
+                        }
+                        best_splits[static_cast<std::size_t>(f) * nb_nodes + node] = best;
+                    }
+                });
+
+                // 2b. best split of every node over all features (the first feature wins ties, such that the result is deterministic)
+                for(int node = 0; node < nb_nodes; ++node)
+                {
+                    split best;
+                    for(int f = 0; f < nb_features; ++f)
+                    {
+                        const split& candidate = best_splits[static_cast<std::size_t>(f) * nb_nodes + node];
+                        if(candidate.gain > best.gain)
+                            best = candidate;
+                    }
+
+                    const int index = nb_nodes - 1 + node;
+                    if(best.bin >= 0)
+                    {
+                        features[index] = best.feature;
+                        thresholds[index] = cuts[best.feature][best.bin];
+                        split_features[node] = best.feature;
+                        split_bins[node] = best.bin;
+                    }
+                    else
+                    {
+                        // all samples go to the left child, as the threshold +infinity does for the predictions
+                        split_features[node] = 0;
+                        split_bins[node] = nb_bins;
+                    }
+                }
+
+                // 2c. nodes of the samples in the next level
+                for(int i = 0; i < nb_samples; ++i)
+                {
+                    const int node = nodes[i];
+                    nodes[i] = 2 * node + (bins[static_cast<std::size_t>(split_features[node]) * nb_samples + i] > split_bins[node]);
+                }
+            }
+
+            // 2d. leaf values (regularized and shrunk means of the residuals) and the new residuals
+            std::fill(leaf_sums.begin(), leaf_sums.end(), 0.0);
+            std::fill(leaf_counts.begin(), leaf_counts.end(), 0);
+            for(int i = 0; i < nb_samples; ++i)
+            {
+                leaf_sums[nodes[i]] += residuals[i];
+                ++leaf_counts[nodes[i]];
+            }
+            for(int leaf = 0; leaf < nb_leaves; ++leaf)
+                leaves[leaf] = (leaf_counts[leaf] > 0) ? _parameters.learning_rate * leaf_sums[leaf] / (leaf_counts[leaf] + lambda) : 0.0;
+            for(int i = 0; i < nb_samples; ++i)
+                residuals[i] -= leaves[nodes[i]];
+        }
+
+        return trees;
+    }
+
+} // namespace ml
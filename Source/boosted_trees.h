@@ -0,0 +1,180 @@
+/*
+ *	Code for the surrogate-based tabu search algorithm
+ *  to optimise people flows in a timetable.
+ *
+ *	Code author: Hendrik Vermuyten
+ */
+
+/*!
+ *	@file		boosted_trees.h
+ *  @author     Hendrik Vermuyten
+ *	@brief		Gradient-boosted regression trees, trained on histograms of the features.
+ */
+
+#ifndef BOOSTED_TREES_H
+#define BOOSTED_TREES_H
+
+#include <vector>
+#include <iosfwd>
+
+#include <dlib/matrix.h>
+
+/*!
+ *  @namespace ml
+ *  @brief	The namespace containing all machine learning elements.
+ */
+namespace ml
+{
+    /*!
+     *	@brief		The hyperparameters of gradient-boosted regression trees.
+     */
+    struct boosted_trees_parameters
+    {
+        int nb_trees = 200;             ///< The number of trees (boosting iterations)
+        int depth = 4;                  ///< The depth of every tree (2^depth leaves)
+        double learning_rate = 0.1;     ///< The shrinkage of the leaf values of every tree
+        double lambda = 1.0;            ///< The L2-regularization of the leaf values
+        int min_samples_leaf = 5;       ///< The minimum number of training samples in both children of a split
+        int nb_bins = 64;               ///< The maximum number of bins of a feature (at most 256)
+    };
+
+
+
+    /*!
+     *	@brief		An ensemble of regression trees, fitted by gradient boosting on the squared error.
+     *
+     *  Every tree is a complete binary tree of the same depth, stored breadth-first in flat arrays: the feature and the
+     *  threshold of the internal nodes of all trees one after the other, followed by the values of the leaves. A node
+     *  without a useful split sends all inputs to its left child (threshold +infinity). A prediction walks every tree
+     *  with 'node = 2*node + 1 + (x(feature) > threshold)', i.e. a fixed number of steps without branches.
+     */
+    class boosted_trees
+    {
+    public:
+        /*!
+         *	@brief		Predict the output for an input.
+         *  @param      x       The input.
+         *  @returns    The prediction (0 if no trees have been trained).
+         */
+        double operator()(const dlib::matrix<double,0,1>& x) const;
+
+        /*!
+         *	@brief		The number of trees.
+         *  @returns    The number of trees.
+         */
+        int nb_trees() const { return _nb_trees; }
+
+        /*!
+         *	@brief		The hyperparameters with which the trees were trained.
+         *  @returns    The hyperparameters.
+         */
+        const boosted_trees_parameters& parameters() const { return _parameters; }
+
+        /*!
+         *	@brief		A lower bound on the prediction for any input: the initial value plus the smallest leaf of every tree.
+         *  @returns    The lower bound.
+         */
+        double lower_bound() const;
+
+        /*!
+         *	@brief		Serialize the trees (dlib format).
+         *  @param      item    The trees.
+         *  @param      out     The output stream.
+         */
+        friend void serialize(const boosted_trees& item, std::ostream& out);
+
+        /*!
+         *	@brief		Deserialize the trees (dlib format).
+         *  @param      item    The trees.
+         *  @param      in      The input stream.
+         */
+        friend void deserialize(boosted_trees& item, std::istream& in);
+
+    private:
+        friend class boosted_trees_trainer;
+
+        /*!
+         *	@brief		The hyperparameters with which the trees were trained.
+         */
+        boosted_trees_parameters _parameters;
+
+        /*!
+         *	@brief		The number of trees.
+         */
+        int _nb_trees = 0;
+
+        /*!
+         *	@brief		The depth of every tree.
+         */
+        int _depth = 0;
+
+        /*!
+         *	@brief		The initial prediction (the mean of the training outputs).
+         */
+        double _base = 0.0;
+
+        /*!
+         *	@brief		The feature of every internal node (2^depth - 1 per tree, breadth-first).
+         */
+        std::vector<int> _features;
+
+        /*!
+         *	@brief		The threshold of every internal node: inputs with 'x(feature) > threshold' go to the right child.
+         */
+        std::vector<double> _thresholds;
+
+        /*!
+         *	@brief		The value of every leaf (2^depth per tree, from left to right), including the learning rate.
+         */
+        std::vector<double> _leaves;
+    };
+
+
+
+    /*!
+     *	@brief		Trains gradient-boosted regression trees on the squared error.
+     *
+     *  Every feature is divided into at most nb_bins bins at the quantiles of its training values. The trees are grown
+     *  level by level: the sums of the residuals per node and bin are accumulated for all features concurrently, after
+     *  which the best split of every node is a scan over the bins. The training time is linear in the number of samples.
+     *  The trainer has the same interface as the dlib trainers, such that it can be cross-validated in the same way.
+     */
+    class boosted_trees_trainer
+    {
+    public:
+        /*!
+         *	@brief		Constructor.
+         *  @param      parameters      The hyperparameters.
+         */
+        explicit boosted_trees_trainer(const boosted_trees_parameters& parameters = boosted_trees_parameters());
+
+        /*!
+         *	@brief		Set the hyperparameters.
+         *  @param      parameters      The hyperparameters.
+         */
+        void set_parameters(const boosted_trees_parameters& parameters);
+
+        /*!
+         *	@brief		The hyperparameters.
+         *  @returns    The hyperparameters.
+         */
+        const boosted_trees_parameters& parameters() const { return _parameters; }
+
+        /*!
+         *	@brief		Train the trees.
+         *  @param      x       The inputs (all of the same size).
+         *  @param      y       The outputs.
+         *  @returns    The trees.
+         */
+        boosted_trees train(const std::vector<dlib::matrix<double,0,1>>& x, const std::vector<double>& y) const;
+
+    private:
+        /*!
+         *	@brief		The hyperparameters.
+         */
+        boosted_trees_parameters _parameters;
+    };
+
+} // namespace ml
+
+#endif // BOOSTED_TREES_H
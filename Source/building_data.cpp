@@ -1,4 +1,5 @@
 #include "building_data.h"
+#include "data_hash.h"
 
 #include <QFile>
 #include <QTextStream>
@@ -288,4 +289,42 @@ namespace building
         room_targets.clear();
         exit_targets.clear();
     }
+
+
+
+    std::uint64_t data_hash()
+    {
+        global::data_hash hash;
+
+        hash << obstacles.size();
+        for(const obstacle& o : obstacles)
+            hash << o.vertices_x << o.vertices_y;
+
+        hash << stairs.size();
+        for(const stairs_element& s : stairs)
+            hash << s.stairwell << s.floor << s.up << s.from_x_min << s.from_x_max << s.from_y_min << s.from_y_max
+                 << s.to_x_min << s.to_x_max << s.to_y_min << s.to_y_max;
+
+        hash << room_targets.size();
+        for(const target& t : room_targets)
+            hash << t.x << t.y << t.dist_tolerance;
+
+        hash << exit_targets.size();
+        for(const target& t : exit_targets)
+            hash << t.x << t.y << t.dist_tolerance;
+
+        hash << teleport_locations_rooms.size();
+        for(const teleport_location& t : teleport_locations_rooms)
+            hash << t.x << t.y;
+        hash << teleport_location_exit.x << teleport_location_exit.y;
+
+        // the road map is used by the simulations, so its contents matter (not its name)
+        QFile road_map(road_map_file_name);
+        if(road_map.open(QIODevice::ReadOnly))
+            hash << road_map.readAll();
+        else
+            hash << road_map_file_name;
+
+        return hash.value();
+    }
 }
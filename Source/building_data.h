@@ -15,6 +15,7 @@
 #define BUILDING_DATA_H
 
 #include <vector>
+#include <cstdint>
 #include <QString>
 
 /*!
@@ -126,6 +127,12 @@ namespace building
      */
     extern void clear_data();
 
+    /*!
+     *	@brief		Hash of the building data (including the contents of the road map), e.g. to recognise stored simulation results.
+     *  @returns    The hash of the building data.
+     */
+    extern std::uint64_t data_hash();
+
 } // namespace building
 
 #endif // BUILDING_DATA_H
@@ -0,0 +1,162 @@
+/*
+ *	Code for the surrogate-based tabu search algorithm
+ *  to optimise people flows in a timetable.
+ *
+ *	Code author: Hendrik Vermuyten
+ */
+
+/*!
+ *	@file		data_hash.h
+ *  @author     Hendrik Vermuyten
+ *	@brief		An incremental hash of input data, used to recognise results that were computed for the same data.
+ */
+
+#ifndef DATA_HASH_H
+#define DATA_HASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <QString>
+#include <QByteArray>
+
+/*!
+ *  @namespace global
+ *  @brief	The namespace containing all global elements.
+ */
+namespace global
+{
+    /*!
+     *	@brief		Incremental 64-bit FNV-1a hash of a sequence of values.
+     *
+     *  The values are hashed by their contents (not by their addresses), such that the hash of the same data
+     *  is the same in every run of the program. Numbers are hashed as 64-bit values, such that the hash does
+     *  not depend on the exact integer or floating point type in which they are stored.
+     */
+    class data_hash
+    {
+    public:
+        /*!
+         *	@brief		Add an integer (or bool or enum) value to the hash.
+         *  @param      value       The value.
+         *  @returns    A reference to this hash.
+         */
+        template<typename T, typename = typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+        data_hash& operator<<(T value)
+        {
+            add_word(static_cast<std::uint64_t>(static_cast<long long>(value)));
+            return *this;
+        }
+
+        /*!
+         *	@brief		Add a floating point value to the hash.
+         *  @param      value       The value.
+         *  @returns    A reference to this hash.
+         */
+        data_hash& operator<<(double value)
+        {
+            if(value == 0.0)
+                value = 0.0;    // +0 and -0 hash the same
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            add_word(bits);
+            return *this;
+        }
+
+        /*!
+         *	@brief		Add a floating point value to the hash.
+         *  @param      value       The value.
+         *  @returns    A reference to this hash.
+         */
+        data_hash& operator<<(float value) { return *this << static_cast<double>(value); }
+
+        /*!
+         *	@brief		Add a string to the hash (preceded by its length).
+         *  @param      value       The string.
+         *  @returns    A reference to this hash.
+         */
+        data_hash& operator<<(const std::string& value)
+        {
+            *this << value.size();
+            add_bytes(value.data(), value.size());
+            return *this;
+        }
+
+        /*!
+         *	@brief		Add a string to the hash (preceded by its length).
+         *  @param      value       The string.
+         *  @returns    A reference to this hash.
+         */
+        data_hash& operator<<(const QString& value) { return *this << value.toStdString(); }
+
+        /*!
+         *	@brief		Add a byte array to the hash (preceded by its length).
+         *  @param      value       The byte array.
+         *  @returns    A reference to this hash.
+         */
+        data_hash& operator<<(const QByteArray& value)
+        {
+            *this << value.size();
+            add_bytes(value.constData(), static_cast<std::size_t>(value.size()));
+            return *this;
+        }
+
+        /*!
+         *	@brief		Add all elements of a vector to the hash (preceded by its length).
+         *  @param      values      The vector.
+         *  @returns    A reference to this hash.
+         */
+        template<typename T>
+        data_hash& operator<<(const std::vector<T>& values)
+        {
+            *this << values.size();
+            for(const T& value : values)
+                *this << value;
+            return *this;
+        }
+
+        /*!
+         *	@brief		Get the hash of all values added so far.
+         *  @returns    The hash.
+         */
+        std::uint64_t value() const { return _hash; }
+
+    private:
+        /*!
+         *	@brief		Add a 64-bit word to the hash (little endian, byte by byte).
+         */
+        void add_word(std::uint64_t word)
+        {
+            for(int i = 0; i < 8; ++i)
+                add_byte(static_cast<unsigned char>(word >> (8*i)));
+        }
+
+        /*!
+         *	@brief		Add a sequence of bytes to the hash.
+         */
+        void add_bytes(const char *data, std::size_t size)
+        {
+            for(std::size_t i = 0; i < size; ++i)
+                add_byte(static_cast<unsigned char>(data[i]));
+        }
+
+        /*!
+         *	@brief		Add a single byte to the hash.
+         */
+        void add_byte(unsigned char byte)
+        {
+            _hash ^= byte;
+            _hash *= 0x100000001B3ULL;
+        }
+
+        /*!
+         *	@brief		The current hash (initialised with the FNV-1a offset basis).
+         */
+        std::uint64_t _hash = 0xCBF29CE484222325ULL;
+    };
+
+}   // namespace global
+
+#endif // DATA_HASH_H
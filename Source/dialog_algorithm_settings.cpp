@@ -1,6 +1,9 @@
 #include "dialog_algorithm_settings.h"
 #include "ui_dialog_algorithm_settings.h"
 
+#include <QRegularExpression>
+#include <QRegularExpressionValidator>
+
 
 dialog_algorithm_settings::dialog_algorithm_settings(QWidget *parent) :
     QDialog(parent),
@@ -27,9 +30,33 @@ dialog_algorithm_settings::dialog_algorithm_settings(QWidget *parent) :
     ui->comboBox_learningmethod->addItem(QStringLiteral("RVM Quadratic Kernel"));
     ui->comboBox_learningmethod->addItem(QStringLiteral("RVM Cubic Kernel"));
 
+    ui->comboBox_learningmethod->addItem(QStringLiteral("Nystroem KRR Radial Basis Kernel"));
+
+    ui->comboBox_learningmethod->addItem(QStringLiteral("Gradient-Boosted Regression Trees"));
+    ui->comboBox_learningmethod->addItem(QStringLiteral("KRLS Radial Basis Kernel (online)"));
+
     ui->comboBox_learningmethod->setEditable(false);
 
 
+    // the seed is a 64-bit unsigned integer, which doesn't fit in a spin box
+    ui->lineEdit_seed->setValidator(new QRegularExpressionValidator(QRegularExpression(QStringLiteral("[0-9]{0,20}")), this));
+
+
+    // same order as timetable::acquisition_function
+    ui->comboBox_acquisitionfunction->addItem(QStringLiteral("Surrogate prediction"));
+    ui->comboBox_acquisitionfunction->addItem(QStringLiteral("Lower confidence bound"));
+    ui->comboBox_acquisitionfunction->addItem(QStringLiteral("Expected improvement"));
+
+    ui->comboBox_acquisitionfunction->setEditable(false);
+
+
+    // same order as timetable::search_strategy_type
+    ui->comboBox_searchstrategy->addItem(QStringLiteral("Tabu search"));
+    ui->comboBox_searchstrategy->addItem(QStringLiteral("Simulated annealing"));
+
+    ui->comboBox_searchstrategy->setEditable(false);
+
+
     // connections
     connect(ui->pushButton_resetvaluesTS, SIGNAL(clicked(bool)), this, SLOT(reset_values_TS()));
 }
@@ -99,6 +126,164 @@ int dialog_algorithm_settings::get_replicationbudget_IS() const
 
 
 
+// search options
+void dialog_algorithm_settings::set_common_random_numbers(bool common_random_numbers)
+{
+    ui->checkBox_commonrandomnumbers->setChecked(common_random_numbers);
+}
+
+
+bool dialog_algorithm_settings::get_common_random_numbers() const
+{
+    return ui->checkBox_commonrandomnumbers->isChecked();
+}
+
+
+void dialog_algorithm_settings::set_adaptive_timeslot_selection(bool adaptive)
+{
+    ui->checkBox_adaptivetimeslotselection->setChecked(adaptive);
+}
+
+
+bool dialog_algorithm_settings::get_adaptive_timeslot_selection() const
+{
+    return ui->checkBox_adaptivetimeslotselection->isChecked();
+}
+
+
+void dialog_algorithm_settings::set_full_neighbourhood_scan(bool full_scan)
+{
+    ui->checkBox_fullneighbourhoodscan->setChecked(full_scan);
+}
+
+
+bool dialog_algorithm_settings::get_full_neighbourhood_scan() const
+{
+    return ui->checkBox_fullneighbourhoodscan->isChecked();
+}
+
+
+void dialog_algorithm_settings::set_evaluation_memo(bool memo)
+{
+    ui->checkBox_evaluationmemo->setChecked(memo);
+}
+
+
+bool dialog_algorithm_settings::get_evaluation_memo() const
+{
+    return ui->checkBox_evaluationmemo->isChecked();
+}
+
+
+void dialog_algorithm_settings::set_reactive_tabu(bool reactive)
+{
+    ui->checkBox_reactivetabu->setChecked(reactive);
+}
+
+
+bool dialog_algorithm_settings::get_reactive_tabu() const
+{
+    return ui->checkBox_reactivetabu->isChecked();
+}
+
+
+void dialog_algorithm_settings::set_pipelined_search(bool pipelined)
+{
+    ui->checkBox_pipelinedsearch->setChecked(pipelined);
+}
+
+
+bool dialog_algorithm_settings::get_pipelined_search() const
+{
+    return ui->checkBox_pipelinedsearch->isChecked();
+}
+
+
+void dialog_algorithm_settings::set_online_refinement(bool refinement)
+{
+    ui->checkBox_onlinerefinement->setChecked(refinement);
+}
+
+
+bool dialog_algorithm_settings::get_online_refinement() const
+{
+    return ui->checkBox_onlinerefinement->isChecked();
+}
+
+
+void dialog_algorithm_settings::set_exhaustive_symmetry_pruning(bool pruning)
+{
+    ui->checkBox_exhaustivesymmetrypruning->setChecked(pruning);
+}
+
+
+bool dialog_algorithm_settings::get_exhaustive_symmetry_pruning() const
+{
+    return ui->checkBox_exhaustivesymmetrypruning->isChecked();
+}
+
+
+void dialog_algorithm_settings::set_exhaustive_branch_and_bound(bool branch_and_bound)
+{
+    ui->checkBox_exhaustivebranchandbound->setChecked(branch_and_bound);
+}
+
+
+bool dialog_algorithm_settings::get_exhaustive_branch_and_bound() const
+{
+    return ui->checkBox_exhaustivebranchandbound->isChecked();
+}
+
+
+void dialog_algorithm_settings::set_compound_moves(bool compound)
+{
+    ui->checkBox_compoundmoves->setChecked(compound);
+}
+
+
+bool dialog_algorithm_settings::get_compound_moves() const
+{
+    return ui->checkBox_compoundmoves->isChecked();
+}
+
+
+void dialog_algorithm_settings::set_path_relinking(bool relinking)
+{
+    ui->checkBox_pathrelinking->setChecked(relinking);
+}
+
+
+bool dialog_algorithm_settings::get_path_relinking() const
+{
+    return ui->checkBox_pathrelinking->isChecked();
+}
+
+
+void dialog_algorithm_settings::set_acquisition_function(timetable::acquisition_function af)
+{
+    ui->comboBox_acquisitionfunction->setCurrentIndex(static_cast<int>(af));
+}
+
+
+timetable::acquisition_function dialog_algorithm_settings::get_acquisition_function() const
+{
+    return static_cast<timetable::acquisition_function>(ui->comboBox_acquisitionfunction->currentIndex());
+}
+
+
+void dialog_algorithm_settings::set_search_strategy(timetable::search_strategy_type strategy)
+{
+    ui->comboBox_searchstrategy->setCurrentIndex(static_cast<int>(strategy));
+}
+
+
+timetable::search_strategy_type dialog_algorithm_settings::get_search_strategy() const
+{
+    return static_cast<timetable::search_strategy_type>(ui->comboBox_searchstrategy->currentIndex());
+}
+
+
+
 // Reset values TS
 void dialog_algorithm_settings::reset_values_TS()
 {
@@ -107,6 +292,19 @@ void dialog_algorithm_settings::reset_values_TS()
     ui->spinBox_nbreplicationsmengeincremental->setValue(timetable::tabu_search::_nb_eval_menge_incremental_default);
     ui->spinBox_max_candidates_per_iteration->setValue(timetable::tabu_search::_nb_eval_local_minimum_default);
     ui->spinBox_tabulistlength->setValue(timetable::tabu_search::_tabu_list_length_default);
+    ui->checkBox_commonrandomnumbers->setChecked(timetable::tabu_search::_common_random_numbers_default);
+    ui->checkBox_adaptivetimeslotselection->setChecked(timetable::tabu_search::_adaptive_timeslot_selection_default);
+    ui->checkBox_fullneighbourhoodscan->setChecked(timetable::tabu_search::_full_neighbourhood_scan_default);
+    ui->checkBox_evaluationmemo->setChecked(timetable::tabu_search::_evaluation_memo_default);
+    ui->checkBox_reactivetabu->setChecked(timetable::tabu_search::_reactive_tabu_default);
+    ui->checkBox_pipelinedsearch->setChecked(timetable::tabu_search::_pipelined_search_default);
+    ui->checkBox_onlinerefinement->setChecked(timetable::tabu_search::_online_refinement_default);
+    ui->checkBox_exhaustivesymmetrypruning->setChecked(timetable::tabu_search::_exhaustive_symmetry_pruning_default);
+    ui->checkBox_exhaustivebranchandbound->setChecked(timetable::tabu_search::_exhaustive_branch_and_bound_default);
+    ui->checkBox_compoundmoves->setChecked(timetable::tabu_search::_compound_moves_default);
+    ui->checkBox_pathrelinking->setChecked(timetable::tabu_search::_path_relinking_default);
+    ui->comboBox_acquisitionfunction->setCurrentIndex(static_cast<int>(timetable::tabu_search::_acquisition_function_default));
+    ui->comboBox_searchstrategy->setCurrentIndex(static_cast<int>(timetable::tabu_search::_search_strategy_default));
 }
 
 
@@ -165,6 +363,15 @@ void dialog_algorithm_settings::set_machine_learning_method(ml::learning_method
     case ml::learning_method::rvm_trainer_polynomial_kernel_cubic:
         lm_new = QStringLiteral("RVM Cubic Kernel");
         break;
+    case ml::learning_method::nystroem_trainer_radial_basis_kernel:
+        lm_new = QStringLiteral("Nystroem KRR Radial Basis Kernel");
+        break;
+    case ml::learning_method::gbt_trainer_regression_trees:
+        lm_new = QStringLiteral("Gradient-Boosted Regression Trees");
+        break;
+    case ml::learning_method::krls_trainer_radial_basis_kernel:
+        lm_new = QStringLiteral("KRLS Radial Basis Kernel (online)");
+        break;
     }
 
 
@@ -217,6 +424,15 @@ ml::learning_method dialog_algorithm_settings::get_machine_learning_method() con
     else if(ml_current == QStringLiteral("RVM Cubic Kernel"))
         return ml::learning_method::rvm_trainer_polynomial_kernel_cubic;
 
+    else if(ml_current == QStringLiteral("Nystroem KRR Radial Basis Kernel"))
+        return ml::learning_method::nystroem_trainer_radial_basis_kernel;
+
+    else if(ml_current == QStringLiteral("Gradient-Boosted Regression Trees"))
+        return ml::learning_method::gbt_trainer_regression_trees;
+
+    else if(ml_current == QStringLiteral("KRLS Radial Basis Kernel (online)"))
+        return ml::learning_method::krls_trainer_radial_basis_kernel;
+
 }
 
 
@@ -232,6 +448,18 @@ int dialog_algorithm_settings::get_nb_training_data() const
 }
 
 
+void dialog_algorithm_settings::set_hyperparameter_time_budget(int seconds)
+{
+    ui->spinBox_hyperparametertimebudget->setValue(seconds);
+}
+
+
+int dialog_algorithm_settings::get_hyperparameter_time_budget() const
+{
+    return ui->spinBox_hyperparametertimebudget->value();
+}
+
+
 
 // logger
 void dialog_algorithm_settings::set_logger_verbose(bool verbose)
@@ -272,6 +500,24 @@ bool dialog_algorithm_settings::get_algorithm_analyze_performance() const
 }
 
 
+void dialog_algorithm_settings::set_seed(std::uint64_t seed)
+{
+    if(seed == 0)
+        ui->lineEdit_seed->clear();
+    else
+        ui->lineEdit_seed->setText(QString::number(static_cast<qulonglong>(seed)));
+}
+
+
+std::uint64_t dialog_algorithm_settings::get_seed() const
+{
+    // an empty field, or a number that doesn't fit in 64 bits, gives a random seed
+    bool ok = false;
+    const qulonglong seed = ui->lineEdit_seed->text().toULongLong(&ok);
+    return ok ? static_cast<std::uint64_t>(seed) : 0;
+}
+
+
 
 dialog_algorithm_settings::~dialog_algorithm_settings()
 {
@@ -15,6 +15,7 @@
 #define DIALOG_ALGORITHM_SETTINGS_H
 
 #include <QDialog>
+#include <cstdint>
 #include "machine_learning_interface.h"
 #include "timetable_tabu_search.h"
 #include "logger.h"
@@ -129,6 +130,18 @@ public:
      */
     int get_nb_training_data() const;
 
+    /*!
+     *	@brief		Set the time budget of the hyperparameter search of the surrogate model.
+     *  @param      seconds      The time budget in seconds.
+     */
+    void set_hyperparameter_time_budget(int seconds);
+
+    /*!
+     *	@brief		Get the time budget of the hyperparameter search of the surrogate model.
+     *  @returns    The time budget in seconds.
+     */
+    int get_hyperparameter_time_budget() const;
+
 
 
     /*!
@@ -157,6 +170,174 @@ public:
      */
     bool get_algorithm_analyze_performance() const;
 
+    /*!
+     *	@brief		Specify whether common random numbers are used to compare candidate solutions with the current solution.
+     *  @param      common_random_numbers      True if common random numbers are used.
+     */
+    void set_common_random_numbers(bool common_random_numbers);
+
+    /*!
+     *	@brief		Return whether common random numbers are used to compare candidate solutions with the current solution.
+     *  @returns    True if common random numbers are used.
+     */
+    bool get_common_random_numbers() const;
+
+    /*!
+     *	@brief		Specify whether the timeslot of each iteration is selected adaptively.
+     *  @param      adaptive      True if the timeslot is selected adaptively.
+     */
+    void set_adaptive_timeslot_selection(bool adaptive);
+
+    /*!
+     *	@brief		Return whether the timeslot of each iteration is selected adaptively.
+     *  @returns    True if the timeslot is selected adaptively.
+     */
+    bool get_adaptive_timeslot_selection() const;
+
+    /*!
+     *	@brief		Specify whether the moves of all timeslots are scored in every iteration.
+     *  @param      full_scan      True if the moves of all timeslots are scored.
+     */
+    void set_full_neighbourhood_scan(bool full_scan);
+
+    /*!
+     *	@brief		Return whether the moves of all timeslots are scored in every iteration.
+     *  @returns    True if the moves of all timeslots are scored.
+     */
+    bool get_full_neighbourhood_scan() const;
+
+    /*!
+     *	@brief		Specify whether the observations of re-visited solutions are reused.
+     *  @param      memo      True if the observations are reused.
+     */
+    void set_evaluation_memo(bool memo);
+
+    /*!
+     *	@brief		Return whether the observations of re-visited solutions are reused.
+     *  @returns    True if the observations are reused.
+     */
+    bool get_evaluation_memo() const;
+
+    /*!
+     *	@brief		Specify whether the tabu tenure reacts to repetitions of solutions.
+     *  @param      reactive      True if the tabu tenure is reactive.
+     */
+    void set_reactive_tabu(bool reactive);
+
+    /*!
+     *	@brief		Return whether the tabu tenure reacts to repetitions of solutions.
+     *  @returns    True if the tabu tenure is reactive.
+     */
+    bool get_reactive_tabu() const;
+
+    /*!
+     *	@brief		Specify whether the next neighbourhood is scored while the candidates are simulated.
+     *  @param      pipelined      True if the search is pipelined.
+     */
+    void set_pipelined_search(bool pipelined);
+
+    /*!
+     *	@brief		Return whether the next neighbourhood is scored while the candidates are simulated.
+     *  @returns    True if the search is pipelined.
+     */
+    bool get_pipelined_search() const;
+
+    /*!
+     *	@brief		Specify whether the surrogates are refined with the simulations of the search.
+     *  @param      refinement      True if the surrogates are refined during the search.
+     */
+    void set_online_refinement(bool refinement);
+
+    /*!
+     *	@brief		Return whether the surrogates are refined with the simulations of the search.
+     *  @returns    True if the surrogates are refined during the search.
+     */
+    bool get_online_refinement() const;
+
+    /*!
+     *	@brief		Specify whether the exhaustive search skips permutations of interchangeable locations.
+     *  @param      pruning      True if permutations of interchangeable locations are skipped.
+     */
+    void set_exhaustive_symmetry_pruning(bool pruning);
+
+    /*!
+     *	@brief		Return whether the exhaustive search skips permutations of interchangeable locations.
+     *  @returns    True if permutations of interchangeable locations are skipped.
+     */
+    bool get_exhaustive_symmetry_pruning() const;
+
+    /*!
+     *	@brief		Specify whether the exhaustive search bounds the enumeration with the surrogates.
+     *  @param      branch_and_bound      True if the enumeration is bounded with the surrogates.
+     */
+    void set_exhaustive_branch_and_bound(bool branch_and_bound);
+
+    /*!
+     *	@brief		Return whether the exhaustive search bounds the enumeration with the surrogates.
+     *  @returns    True if the enumeration is bounded with the surrogates.
+     */
+    bool get_exhaustive_branch_and_bound() const;
+
+    /*!
+     *	@brief		Specify whether compound moves are added to the neighbourhood
+     *  @param      compound      True if compound moves are added to the neighbourhood.
+     */
+    void set_compound_moves(bool compound);
+
+    /*!
+     *	@brief		Return whether compound moves are added to the neighbourhood
+     *  @returns    True if compound moves are added to the neighbourhood.
+     */
+    bool get_compound_moves() const;
+
+    /*!
+     *	@brief		Specify whether the search ends with path relinking between the elite solutions
+     *  @param      relinking      True if path relinking is executed after the exploration.
+     */
+    void set_path_relinking(bool relinking);
+
+    /*!
+     *	@brief		Return whether the search ends with path relinking between the elite solutions
+     *  @returns    True if path relinking is executed after the exploration.
+     */
+    bool get_path_relinking() const;
+
+    /*!
+     *	@brief		Specify the criterion to rank the candidate moves.
+     *  @param      af      The acquisition function.
+     */
+    void set_acquisition_function(timetable::acquisition_function af);
+
+    /*!
+     *	@brief		Return the criterion to rank the candidate moves.
+     *  @returns    The acquisition function.
+     */
+    timetable::acquisition_function get_acquisition_function() const;
+
+    /*!
+     *	@brief		Specify the search strategy of the exploration.
+     *  @param      strategy      The search strategy.
+     */
+    void set_search_strategy(timetable::search_strategy_type strategy);
+
+    /*!
+     *	@brief		Return the search strategy of the exploration.
+     *  @returns    The search strategy.
+     */
+    timetable::search_strategy_type get_search_strategy() const;
+
+    /*!
+     *	@brief		Set the run-level seed from which all random numbers are derived.
+     *  @param      seed      The run-level seed (0 if a random seed is drawn).
+     */
+    void set_seed(std::uint64_t seed);
+
+    /*!
+     *	@brief		Return the run-level seed from which all random numbers are derived.
+     *  @returns    The run-level seed (0 if a random seed is drawn).
+     */
+    std::uint64_t get_seed() const;
+
 
 private slots:
     /*!
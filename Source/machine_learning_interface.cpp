@@ -1,20 +1,1089 @@
 #include "machine_learning_interface.h"
+#include "random_streams.h"
+#include "data_hash.h"
+#include "training_data_store.h"
 
 #include <QDebug>
 #include <QFile>
 #include <QTextStream>
+#include <QtConcurrent/QtConcurrent>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
 #include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <numeric>
+#include <functional>
+#include <exception>
+#include <utility>
+#include <algorithm>
 
 
 
 namespace
 {
-    std::random_device randdev;
-    std::seed_seq seedseq{ randdev(), randdev(), randdev(), randdev(), randdev(), randdev(), randdev(), randdev() };
-    std::mt19937 generator(seedseq);
+    std::mt19937_64 generator;
 
     constexpr double NANO = 1000000000.0;
-    constexpr std::chrono::nanoseconds max_runtime_findminglobal(1000*(long long)NANO); // maximum runtime of find_min_global set to 1000 seconds
+
+    // Run f(0), ..., f(n-1) on the global thread pool (the calling thread takes part) and rethrow the first exception
+    template<typename F>
+    void parallel_for(int n, const F& f)
+    {
+        std::vector<int> indices(std::max(n, 0));
+        std::iota(indices.begin(), indices.end(), 0);
+
+        std::exception_ptr error;
+        QMutex error_mutex;
+        QtConcurrent::blockingMap(indices, [&](int& i)
+        {
+            try {
+                f(i);
+            } catch(...) {
+                QMutexLocker locker(&error_mutex);
+                if(!error)
+                    error = std::current_exception();
+            }
+        });
+
+        if(error)
+            std::rethrow_exception(error);
+    }
+
+    // Cross-validation of a regression trainer with the same folds and results as dlib::cross_validate_regression_trainer
+    // (MSE, correlation, MAE, standard deviation of the absolute error), but the folds are trained and tested concurrently
+    template<typename trainer_type, typename sample_type>
+    dlib::matrix<double,1,4> parallel_cross_validate_regression_trainer(const trainer_type& trainer, const std::vector<sample_type>& x,
+                                                                        const std::vector<double>& y, long folds)
+    {
+        const long nb_samples = static_cast<long>(x.size());
+        if(folds <= 1 || folds > nb_samples || x.size() != y.size())
+            throw std::runtime_error("Error in function parallel_cross_validate_regression_trainer. \nInvalid number of folds or samples.");
+
+        const long num_in_test = nb_samples / folds;
+        const long num_in_train = nb_samples - num_in_test;
+
+        // the test samples of fold i start at sample i*num_in_test, the training samples follow them (cyclically)
+        std::vector<std::vector<double>> predictions(folds);
+        parallel_for(static_cast<int>(folds), [&](int fold)
+        {
+            const long first_test = (fold * num_in_test) % nb_samples;
+
+            std::vector<sample_type> x_train;
+            std::vector<double> y_train;
+            x_train.reserve(num_in_train);
+            y_train.reserve(num_in_train);
+            long next = (first_test + num_in_test) % nb_samples;
+            for(long cnt = 0; cnt < num_in_train; ++cnt)
+            {
+                x_train.push_back(x[next]);
+                y_train.push_back(y[next]);
+                next = (next + 1) % nb_samples;
+            }
+
+            trainer_type fold_trainer = trainer;
+            const auto df = fold_trainer.train(x_train, y_train);
+
+            predictions[fold].reserve(num_in_test);
+            for(long cnt = 0; cnt < num_in_test; ++cnt)
+                predictions[fold].push_back(df(x[(first_test + cnt) % nb_samples]));
+        });
+
+        // combine the folds in order, such that the result does not depend on the order in which they finished
+        dlib::running_stats<double> rs, rs_mae;
+        dlib::running_scalar_covariance<double> rc;
+        for(long fold = 0; fold < folds; ++fold)
+        {
+            for(long cnt = 0; cnt < num_in_test; ++cnt)
+            {
+                const double output = predictions[fold][cnt];
+                const double target = y[(fold * num_in_test + cnt) % nb_samples];
+                const double error = output - target;
+                rs_mae.add(std::abs(error));
+                rs.add(error*error);
+                rc.add(output, target);
+            }
+        }
+
+        dlib::matrix<double,1,4> result;
+        result = rs.mean(), rc.correlation(), rs_mae.mean(), rs_mae.stddev();
+        return result;
+    }
+
+    // Number of arguments of a lambda
+    template<typename T>
+    struct function_arity : function_arity<decltype(&T::operator())> {};
+
+    template<typename C, typename R, typename... A>
+    struct function_arity<R(C::*)(A...) const> { static constexpr std::size_t value = sizeof...(A); };
+
+    template<typename F, std::size_t... I>
+    double call_with_expanded_args(const F& f, const dlib::matrix<double,0,1>& x, std::index_sequence<I...>)
+    {
+        return f(x(I)...);
+    }
+
+    // Minimise a function over a box with the global optimiser of dlib::find_min_global, but evaluate the proposed points
+    // in batches (one point per thread of the global thread pool) concurrently.
+    // Stops after max_calls evaluations or when the time budget is spent (at least one batch is evaluated).
+    dlib::function_evaluation minimise_parallel(const std::function<double(const dlib::matrix<double,0,1>&)>& f,
+                                                const dlib::matrix<double,0,1>& lower, const dlib::matrix<double,0,1>& upper,
+                                                const dlib::max_function_calls& max_calls, std::chrono::nanoseconds time_budget)
+    {
+        dlib::global_function_search optimiser(dlib::function_spec(lower, upper));
+        const std::size_t batch_size = std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+        const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+        std::size_t nb_calls = 0;
+        do
+        {
+            std::vector<dlib::function_evaluation_request> batch;
+            const std::size_t nb_requests = std::min(batch_size, max_calls.max_calls - nb_calls);
+            for(std::size_t i = 0; i < nb_requests; ++i)
+                batch.push_back(optimiser.get_next_x());
+
+            std::vector<double> values(batch.size());
+            parallel_for(static_cast<int>(batch.size()), [&](int i)
+            {
+                values[i] = f(batch[i].x());
+            });
+
+            for(std::size_t i = 0; i < batch.size(); ++i)
+                batch[i].set(-values[i]);   // the optimiser maximises
+            nb_calls += batch.size();
+        }
+        while(nb_calls < max_calls.max_calls && std::chrono::steady_clock::now() - start_time < time_budget);
+
+        dlib::function_evaluation best;
+        std::size_t function_idx = 0;
+        optimiser.get_best_function_eval(best.x, best.y, function_idx);
+        best.y = -best.y;
+        return best;
+    }
+
+    // As minimise_parallel, for a function that takes the coordinates as separate arguments (like dlib::find_min_global)
+    template<typename F>
+    dlib::function_evaluation find_min_global_parallel(const F& f, const dlib::matrix<double,0,1>& lower, const dlib::matrix<double,0,1>& upper,
+                                                       const dlib::max_function_calls& max_calls, std::chrono::nanoseconds time_budget)
+    {
+        using arguments = std::make_index_sequence<function_arity<F>::value>;
+        return minimise_parallel([&](const dlib::matrix<double,0,1>& x) { return call_with_expanded_args(f, x, arguments()); },
+                                 lower, upper, max_calls, time_budget);
+    }
+
+    // Pairwise squared distances or dot products of the training samples, computed once per data set. The cached kernels
+    // below work on the indices of the samples, such that the kernel matrix of every hyperparameter trial and every fold
+    // is only an elementwise transform of these values.
+    // The matrix takes 8 n^2 bytes, so it is only computed for at most kernel_cache_max_samples samples (200 MB). For more
+    // samples, the cached kernels evaluate the kernel on the samples themselves, as the plain kernels do.
+    constexpr std::size_t kernel_cache_max_samples = 5000;
+
+    struct kernel_cache
+    {
+        std::vector<unsigned long> samples;             // the indices of the samples (0, 1, ..., n-1)
+        const std::vector<ml::sample_type> *x = nullptr; // the samples themselves
+        dlib::matrix<double> values;                    // values(i,j) = pairwise value of the samples i and j (empty if too many samples)
+
+        bool cached() const { return values.size() > 0; }
+    };
+
+    template<typename F>
+    kernel_cache make_kernel_cache(const std::vector<ml::sample_type>& x, const F& pairwise)
+    {
+        const long nb_samples = static_cast<long>(x.size());
+
+        kernel_cache cache;
+        cache.samples.resize(x.size());
+        std::iota(cache.samples.begin(), cache.samples.end(), 0UL);
+        cache.x = &x;
+        if(x.size() > kernel_cache_max_samples)
+            return cache;
+        cache.values.set_size(nb_samples, nb_samples);
+
+        // row i fills the lower triangle of row i and its mirror image, such that no two rows write the same value
+        parallel_for(static_cast<int>(nb_samples), [&](int i)
+        {
+            for(long j = 0; j <= i; ++j)
+                cache.values(i,j) = cache.values(j,i) = pairwise(x[i], x[j]);
+        });
+
+        return cache;
+    }
+
+    kernel_cache squared_distance_cache(const std::vector<ml::sample_type>& x)
+    {
+        return make_kernel_cache(x, [](const ml::sample_type& a, const ml::sample_type& b) { return dlib::length_squared(a - b); });
+    }
+
+    kernel_cache dot_product_cache(const std::vector<ml::sample_type>& x)
+    {
+        return make_kernel_cache(x, [](const ml::sample_type& a, const ml::sample_type& b) { return dlib::dot(a, b); });
+    }
+
+    // Radial basis kernel on the indices of the samples of a squared distance cache (same values as ml::radial_basis_kernel)
+    struct cached_radial_basis_kernel
+    {
+        typedef unsigned long sample_type;
+        typedef double scalar_type;
+        typedef dlib::default_memory_manager mem_manager_type;
+
+        cached_radial_basis_kernel() = default;
+        cached_radial_basis_kernel(const kernel_cache& c, double g) : cache(&c), gamma(g) {}
+
+        double operator()(const sample_type& a, const sample_type& b) const
+        {
+            const double distance = cache->cached() ? cache->values(a,b) : dlib::length_squared((*cache->x)[a] - (*cache->x)[b]);
+            return std::exp(-gamma * distance);
+        }
+
+        bool operator==(const cached_radial_basis_kernel& k) const { return cache == k.cache && gamma == k.gamma; }
+
+        const kernel_cache *cache = nullptr;
+        double gamma = 0.1;
+    };
+
+    // Polynomial kernel on the indices of the samples of a dot product cache (same values as ml::polynomial_kernel)
+    struct cached_polynomial_kernel
+    {
+        typedef unsigned long sample_type;
+        typedef double scalar_type;
+        typedef dlib::default_memory_manager mem_manager_type;
+
+        cached_polynomial_kernel() = default;
+        cached_polynomial_kernel(const kernel_cache& c, double g, double cf, double d) : cache(&c), gamma(g), coef(cf), degree(d) {}
+
+        double operator()(const sample_type& a, const sample_type& b) const
+        {
+            const double dot = cache->cached() ? cache->values(a,b) : dlib::dot((*cache->x)[a], (*cache->x)[b]);
+            return std::pow(gamma * dot + coef, degree);
+        }
+
+        bool operator==(const cached_polynomial_kernel& k) const
+        {
+            return cache == k.cache && gamma == k.gamma && coef == k.coef && degree == k.degree;
+        }
+
+        const kernel_cache *cache = nullptr;
+        double gamma = 1.0;
+        double coef = 0.0;
+        double degree = 1.0;
+    };
+
+    // Kernel used by a learning method
+    bool uses_radial_basis_kernel(ml::learning_method lm)
+    {
+        return (lm == ml::learning_method::krr_trainer_radial_basis_kernel
+                || lm == ml::learning_method::svr_trainer_radial_basis_kernel
+                || lm == ml::learning_method::rvm_trainer_radial_basis_kernel
+                || lm == ml::learning_method::nystroem_trainer_radial_basis_kernel
+                || lm == ml::learning_method::krls_trainer_radial_basis_kernel);
+    }
+
+    bool uses_histogram_intersection_kernel(ml::learning_method lm)
+    {
+        return (lm == ml::learning_method::krr_trainer_histogram_intersection_kernel
+                || lm == ml::learning_method::svr_trainer_histogram_intersection_kernel
+                || lm == ml::learning_method::rvm_trainer_histogram_intersection_kernel);
+    }
+
+    bool uses_polynomial_kernel(ml::learning_method lm)
+    {
+        return (lm == ml::learning_method::krr_trainer_polynomial_kernel_quadratic
+                || lm == ml::learning_method::krr_trainer_polynomial_kernel_cubic
+                || lm == ml::learning_method::svr_trainer_polynomial_kernel_quadratic
+                || lm == ml::learning_method::svr_trainer_polynomial_kernel_cubic
+                || lm == ml::learning_method::rvm_trainer_polynomial_kernel_quadratic
+                || lm == ml::learning_method::rvm_trainer_polynomial_kernel_cubic);
+    }
+
+    bool uses_linear_kernel(ml::learning_method lm)
+    {
+        return (lm == ml::learning_method::krr_trainer_linear_kernel
+                || lm == ml::learning_method::svr_trainer_linear_kernel
+                || lm == ml::learning_method::rvm_trainer_linear_kernel);
+    }
+
+    // Trainer used by a learning method
+    bool uses_krr_trainer(ml::learning_method lm)
+    {
+        return (lm == ml::learning_method::krr_trainer_radial_basis_kernel
+                || lm == ml::learning_method::krr_trainer_histogram_intersection_kernel
+                || lm == ml::learning_method::krr_trainer_linear_kernel
+                || lm == ml::learning_method::krr_trainer_polynomial_kernel_quadratic
+                || lm == ml::learning_method::krr_trainer_polynomial_kernel_cubic);
+    }
+
+    bool uses_svr_trainer(ml::learning_method lm)
+    {
+        return (lm == ml::learning_method::svr_trainer_radial_basis_kernel
+                || lm == ml::learning_method::svr_trainer_histogram_intersection_kernel
+                || lm == ml::learning_method::svr_trainer_linear_kernel
+                || lm == ml::learning_method::svr_trainer_polynomial_kernel_quadratic
+                || lm == ml::learning_method::svr_trainer_polynomial_kernel_cubic);
+    }
+
+    bool uses_nystroem_trainer(ml::learning_method lm)
+    {
+        return (lm == ml::learning_method::nystroem_trainer_radial_basis_kernel);
+    }
+
+    bool uses_boosted_trees(ml::learning_method lm)
+    {
+        return (lm == ml::learning_method::gbt_trainer_regression_trees);
+    }
+
+    // Learning methods that are updated with every observation instead of being refined
+    bool uses_online_learner(ml::learning_method lm)
+    {
+        return (lm == ml::learning_method::krls_trainer_radial_basis_kernel);
+    }
+
+    // Maximum number of basis vectors of Kernel Recursive Least Squares, which bounds the time to add a sample
+    constexpr unsigned long krls_max_dictionary_size = 500;
+
+    // Kernel Recursive Least Squares with a fixed kernel and tolerance as a trainer (e.g. for the cross-validation):
+    // the samples are added one at a time, in order, as the online learner does
+    template<typename kernel_type>
+    struct krls_trainer
+    {
+        kernel_type kernel;
+        double tolerance;
+
+        dlib::decision_function<kernel_type> train(const std::vector<ml::sample_type>& x, const std::vector<double>& y) const
+        {
+            dlib::krls<kernel_type> krls(kernel, tolerance, krls_max_dictionary_size);
+            for(std::size_t i = 0; i < x.size(); ++i)
+                krls.train(x[i], y[i]);
+            return krls.get_decision_function();
+        }
+    };
+
+    // Hyperparameters of gradient-boosted trees for a point of the hyperparameter search (the depth and the number of trees are rounded)
+    ml::boosted_trees_parameters make_boosted_trees_parameters(double depth, double nb_trees, double learning_rate, double lambda)
+    {
+        ml::boosted_trees_parameters parameters;
+        parameters.depth = static_cast<int>(std::lround(depth));
+        parameters.nb_trees = static_cast<int>(std::lround(nb_trees));
+        parameters.learning_rate = learning_rate;
+        parameters.lambda = lambda;
+        return parameters;
+    }
+
+    // Maximum number of basis vectors of the Nystroem approximation of a kernel
+    constexpr long nystroem_basis_size = 200;
+
+    // Kernel ridge regression on a Nystroem approximation of the kernel: the samples are projected on a basis of at most
+    // nystroem_basis_size centres (of k-means clusters), after which a linear ridge regression is trained on the projections.
+    // The training time is linear in the number of samples and the decision function has at most nystroem_basis_size
+    // basis vectors, whatever the number of training data.
+    template<typename kernel_type>
+    class nystroem_trainer
+    {
+    public:
+        void set_kernel(const kernel_type& kernel) { _kernel = kernel; }
+        void set_lambda(double lambda) { _lambda = lambda; }
+
+        dlib::decision_function<kernel_type> train(const std::vector<ml::sample_type>& x, const std::vector<double>& y) const
+        {
+            if(x.empty() || x.size() != y.size())
+                throw std::runtime_error("Error in function nystroem_trainer::train. \nInvalid training data.");
+
+            // 1. basis: all samples or the centres of their k-means clusters
+            std::vector<ml::sample_type> centres;
+            if(static_cast<long>(x.size()) <= nystroem_basis_size)
+                centres = x;
+            else
+            {
+                dlib::pick_initial_centers(nystroem_basis_size, centres, x, _kernel);
+                dlib::find_clusters_using_kmeans(x, centres, 20);
+            }
+
+            // 2. projections of the samples on the basis
+            dlib::empirical_kernel_map<kernel_type> ekm;
+            ekm.load(_kernel, centres);
+            std::vector<ml::sample_type> projections;
+            projections.reserve(x.size());
+            for(const ml::sample_type& sample : x)
+                projections.push_back(ekm.project(sample));
+
+            // 3. linear ridge regression on the projections, converted back into a kernel expansion over the basis
+            dlib::krr_trainer<ml::linear_kernel> ridge_trainer;
+            ridge_trainer.set_lambda(_lambda);
+            const ml::decision_function_linear_kernel ridge = ridge_trainer.train(projections, y);
+
+            ml::sample_type weights = dlib::zeros_matrix<double>(ekm.out_vector_size(), 1);
+            for(long i = 0; i < ridge.basis_vectors.size(); ++i)
+                weights += ridge.alpha(i) * ridge.basis_vectors(i);
+
+            dlib::decision_function<kernel_type> df = ekm.convert_to_decision_function(weights);
+            df.b = ridge.b;
+            return df;
+        }
+
+    private:
+        kernel_type _kernel;
+        double _lambda = 1e-3;
+    };
+
+    // Retrain a decision function with the given kernel and regularization parameter (no hyperparameter search)
+    template<typename kernel_type>
+    dlib::decision_function<kernel_type> refit_decision_function(ml::learning_method lm, const kernel_type& kernel, double regularization,
+                                                                 const std::vector<ml::sample_type>& x, const std::vector<double>& y)
+    {
+        if(uses_nystroem_trainer(lm))
+        {
+            nystroem_trainer<kernel_type> trainer;
+            trainer.set_kernel(kernel);
+            trainer.set_lambda(regularization);
+            return trainer.train(x, y);
+        }
+        else if(uses_krr_trainer(lm))
+        {
+            dlib::krr_trainer<kernel_type> krr_trainer;
+            krr_trainer.set_kernel(kernel);
+            krr_trainer.set_lambda(regularization);
+            return krr_trainer.train(x, y);
+        }
+        else if(uses_svr_trainer(lm))
+        {
+            dlib::svr_trainer<kernel_type> svr_trainer;
+            svr_trainer.set_kernel(kernel);
+            svr_trainer.set_c(regularization);
+            return svr_trainer.train(x, y);
+        }
+
+        dlib::rvm_trainer<kernel_type> rvm_trainer;
+        rvm_trainer.set_kernel(kernel);
+        return rvm_trainer.train(x, y);
+    }
+
+    // Retrain a model, keeping its kernel parameters (or the hyperparameters of the trees)
+    template<typename kernel_type>
+    dlib::decision_function<kernel_type> refit_model(ml::learning_method lm, const dlib::decision_function<kernel_type>& df, double regularization,
+                                                     const std::vector<ml::sample_type>& x, const std::vector<double>& y)
+    {
+        return refit_decision_function(lm, df.kernel_function, regularization, x, y);
+    }
+
+    ml::boosted_trees refit_model(ml::learning_method, const ml::boosted_trees& trees, double regularization,
+                                  const std::vector<ml::sample_type>& x, const std::vector<double>& y)
+    {
+        // the regularization parameter of the trees is the L2-regularization of the leaf values
+        ml::boosted_trees_parameters parameters = trees.parameters();
+        parameters.lambda = regularization;
+        return ml::boosted_trees_trainer(parameters).train(x, y);
+    }
+
+    // Put a model in its place in the decision functions
+    void store_decision_function(ml::decision_functions& dfs, const ml::decision_function_radial_basis_kernel& df) { dfs.dec_func_rbk = df; }
+    void store_decision_function(ml::decision_functions& dfs, const ml::decision_function_histogram_intersection_kernel& df) { dfs.dec_func_hik = df; }
+    void store_decision_function(ml::decision_functions& dfs, const ml::decision_function_polynomial_kernel& df) { dfs.dec_func_pk = df; }
+    void store_decision_function(ml::decision_functions& dfs, const ml::decision_function_linear_kernel& df) { dfs.dec_func_lk = df; }
+    void store_decision_function(ml::decision_functions& dfs, const ml::boosted_trees& trees) { dfs.dec_func_gbt = trees; }
+
+    // The retraining of a surrogate with fixed hyperparameters as a trainer (e.g. for the cross-validation)
+    struct refit_trainer
+    {
+        ml::learning_method lm;
+        ml::predictor current;
+        double regularization;
+
+        ml::predictor train(const std::vector<ml::sample_type>& x, const std::vector<double>& y) const
+        {
+            return ml::predictor::compile(lm, current.refit(lm, regularization, x, y));
+        }
+    };
+
+    // Root mean squared error of the retraining in a 10-fold cross-validation (0 if there are too few samples)
+    double refit_cross_validation_rmse(const refit_trainer& trainer, const std::vector<ml::sample_type>& x, const std::vector<double>& y)
+    {
+        if(x.size() < 10)
+            return 0.0;
+        return std::sqrt(parallel_cross_validate_regression_trainer(trainer, x, y, 10)(0));
+    }
+
+    // Evaluation of a compiled decision function. Every form has its own evaluator, such that the evaluation is resolved
+    // at compile time.
+
+    // Explicit polynomial in x: offset + sum_r l_r x_r (+ sum_{r<=s} q_rs x_r x_s (+ sum_{r<=s<=t} c_rst x_r x_s x_t))
+    template<int degree>
+    struct polynomial_evaluator
+    {
+        long nb_features = 0;
+        double offset = 0.0;
+        std::vector<double> linear;
+        std::vector<double> quadratic;      // monomials r <= s, row by row
+        std::vector<double> cubic;          // monomials r <= s <= t, in lexicographic order
+
+        double operator()(const ml::sample_type& x) const
+        {
+            double value = offset;
+            for(long r = 0; r < nb_features; ++r)
+                value += linear[r] * x(r);
+
+            if(degree >= 2)
+            {
+                std::size_t k = 0;
+                for(long r = 0; r < nb_features; ++r)
+                    for(long s = r; s < nb_features; ++s)
+                        value += quadratic[k++] * x(r) * x(s);
+            }
+
+            if(degree >= 3)
+            {
+                std::size_t k = 0;
+                for(long r = 0; r < nb_features; ++r)
+                    for(long s = r; s < nb_features; ++s)
+                    {
+                        const double xrs = x(r) * x(s);
+                        for(long t = s; t < nb_features; ++t)
+                            value += cubic[k++] * xrs * x(t);
+                    }
+            }
+
+            return value;
+        }
+    };
+
+    // Sum over the contiguous basis vectors with a polynomial kernel
+    struct polynomial_kernel_evaluator
+    {
+        long nb_features = 0;
+        double offset = 0.0;
+        double gamma = 0.0, coef = 0.0, degree = 1.0;
+        std::vector<double> alpha;
+        std::vector<double> basis_vectors;  // one after the other
+
+        double operator()(const ml::sample_type& x) const
+        {
+            double value = offset;
+            const double *basis_vector = basis_vectors.data();
+            for(std::size_t i = 0; i < alpha.size(); ++i, basis_vector += nb_features)
+            {
+                double dot = 0.0;
+                for(long r = 0; r < nb_features; ++r)
+                    dot += x(r) * basis_vector[r];
+                value += alpha[i] * std::pow(gamma * dot + coef, degree);
+            }
+            return value;
+        }
+    };
+
+    // Sum over the contiguous basis vectors (single precision) with a radial basis kernel
+    struct radial_basis_evaluator
+    {
+        long nb_features = 0;
+        double offset = 0.0;
+        double gamma = 0.0;
+        std::vector<double> alpha;
+        std::vector<float> basis_vectors;   // one after the other
+
+        double operator()(const ml::sample_type& x) const
+        {
+            // the input is converted once, such that the inner loop only works on contiguous floats
+            std::vector<float> input(nb_features);
+            for(long r = 0; r < nb_features; ++r)
+                input[r] = static_cast<float>(x(r));
+
+            double value = offset;
+            const float *basis_vector = basis_vectors.data();
+            for(std::size_t i = 0; i < alpha.size(); ++i, basis_vector += nb_features)
+            {
+                float distance = 0.0f;
+                for(long r = 0; r < nb_features; ++r)
+                {
+                    const float difference = input[r] - basis_vector[r];
+                    distance += difference * difference;
+                }
+                value += alpha[i] * std::exp(-gamma * distance);
+            }
+            return value;
+        }
+    };
+
+    // The decision function itself (kernels that cannot be compiled)
+    template<typename kernel_type>
+    struct decision_function_evaluator
+    {
+        dlib::decision_function<kernel_type> df;
+
+        double operator()(const ml::sample_type& x) const { return df(x); }
+    };
+
+    // f(x) = w.x - b, with w = sum alpha_i * s_i
+    polynomial_evaluator<1> compile_linear(const ml::decision_function_linear_kernel& df)
+    {
+        polynomial_evaluator<1> evaluator;
+        evaluator.offset = -df.b;
+        evaluator.nb_features = (df.basis_vectors.size() > 0) ? df.basis_vectors(0).size() : 0;
+        evaluator.linear.assign(evaluator.nb_features, 0.0);
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+            for(long r = 0; r < evaluator.nb_features; ++r)
+                evaluator.linear[r] += df.alpha(i) * df.basis_vectors(i)(r);
+        return evaluator;
+    }
+
+    // Does the expanded polynomial have fewer terms than the sum over the basis vectors?
+    bool polynomial_expansion_is_cheaper(const ml::decision_function_polynomial_kernel& df)
+    {
+        const long nb_basis_vectors = df.basis_vectors.size();
+        const long nb_features = (nb_basis_vectors > 0) ? df.basis_vectors(0).size() : 0;
+        long nb_terms = nb_features;
+        if(df.kernel_function.degree >= 2)
+            nb_terms += nb_features * (nb_features + 1) / 2;
+        if(df.kernel_function.degree >= 3)
+            nb_terms += nb_features * (nb_features + 1) * (nb_features + 2) / 6;
+        return nb_terms <= nb_basis_vectors * nb_features;
+    }
+
+    // (gamma x.s + coef)^p = sum_k binom(p,k) gamma^k coef^(p-k) (x.s)^k, and sum_i alpha_i (x.s_i)^k is a sum over the
+    // monomials of degree k, with coefficient 'multiplicity of the monomial * sum_i alpha_i * monomial(s_i)'
+    template<int degree>
+    polynomial_evaluator<degree> compile_polynomial(const ml::decision_function_polynomial_kernel& df)
+    {
+        const double gamma = df.kernel_function.gamma;
+        const double coef = df.kernel_function.coef;
+        const double c1 = degree * gamma * std::pow(coef, degree - 1);
+        const double c2 = (degree >= 2) ? degree * (degree - 1) / 2 * gamma * gamma * std::pow(coef, degree - 2) : 0.0;
+        const double c3 = (degree >= 3) ? gamma * gamma * gamma : 0.0;
+
+        polynomial_evaluator<degree> evaluator;
+        const long nb_features = (df.basis_vectors.size() > 0) ? df.basis_vectors(0).size() : 0;
+        evaluator.nb_features = nb_features;
+        evaluator.offset = dlib::sum(df.alpha) * std::pow(coef, degree) - df.b;
+        evaluator.linear.assign(nb_features, 0.0);
+        if(degree >= 2)
+            evaluator.quadratic.assign(nb_features * (nb_features + 1) / 2, 0.0);
+        if(degree >= 3)
+            evaluator.cubic.assign(nb_features * (nb_features + 1) * (nb_features + 2) / 6, 0.0);
+
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+        {
+            const double alpha = df.alpha(i);
+            const ml::sample_type& sv = df.basis_vectors(i);
+
+            for(long r = 0; r < nb_features; ++r)
+                evaluator.linear[r] += c1 * alpha * sv(r);
+
+            if(degree >= 2)
+            {
+                std::size_t k = 0;
+                for(long r = 0; r < nb_features; ++r)
+                    for(long s = r; s < nb_features; ++s)
+                        evaluator.quadratic[k++] += c2 * alpha * sv(r) * sv(s) * ((r == s) ? 1 : 2);
+            }
+
+            if(degree >= 3)
+            {
+                std::size_t k = 0;
+                for(long r = 0; r < nb_features; ++r)
+                    for(long s = r; s < nb_features; ++s)
+                        for(long t = s; t < nb_features; ++t)
+                        {
+                            const int multiplicity = (r == s && s == t) ? 1 : ((r == s || s == t) ? 3 : 6);
+                            evaluator.cubic[k++] += c3 * alpha * sv(r) * sv(s) * sv(t) * multiplicity;
+                        }
+            }
+        }
+
+        return evaluator;
+    }
+
+    polynomial_kernel_evaluator compile_polynomial_kernel(const ml::decision_function_polynomial_kernel& df)
+    {
+        polynomial_kernel_evaluator evaluator;
+        evaluator.nb_features = (df.basis_vectors.size() > 0) ? df.basis_vectors(0).size() : 0;
+        evaluator.offset = -df.b;
+        evaluator.gamma = df.kernel_function.gamma;
+        evaluator.coef = df.kernel_function.coef;
+        evaluator.degree = df.kernel_function.degree;
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+        {
+            evaluator.alpha.push_back(df.alpha(i));
+            for(long r = 0; r < evaluator.nb_features; ++r)
+                evaluator.basis_vectors.push_back(df.basis_vectors(i)(r));
+        }
+        return evaluator;
+    }
+
+    radial_basis_evaluator compile_radial_basis(const ml::decision_function_radial_basis_kernel& df)
+    {
+        radial_basis_evaluator evaluator;
+        evaluator.nb_features = (df.basis_vectors.size() > 0) ? df.basis_vectors(0).size() : 0;
+        evaluator.offset = -df.b;
+        evaluator.gamma = df.kernel_function.gamma;
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+        {
+            evaluator.alpha.push_back(df.alpha(i));
+            for(long r = 0; r < evaluator.nb_features; ++r)
+                evaluator.basis_vectors.push_back(static_cast<float>(df.basis_vectors(i)(r)));
+        }
+        return evaluator;
+    }
+
+    // Abbreviation of a kernel in the names of saved decision functions
+    std::string kernel_abbreviation(const ml::radial_basis_kernel&) { return "RBK"; }
+    std::string kernel_abbreviation(const ml::histogram_intersection_kernel&) { return "HIK"; }
+    std::string kernel_abbreviation(const ml::polynomial_kernel&) { return "PK"; }
+    std::string kernel_abbreviation(const ml::linear_kernel&) { return "LK"; }
+
+    template<typename kernel_type>
+    std::string model_abbreviation(const dlib::decision_function<kernel_type>& df) { return kernel_abbreviation(df.kernel_function); }
+    std::string model_abbreviation(const ml::boosted_trees&) { return "GBT"; }
+
+    // Incremental prediction of the moves in a timeslot (see ml::swap_prediction_cache). A move only changes two or three
+    // elements of the input, such that the prediction is updated from intermediate results of the input without move
+    // in O(number of basis vectors) instead of O(number of basis vectors * number of locations). Every kind of model has
+    // its own overloads, which are resolved when the predictor is compiled.
+
+    // Radial basis kernel: the squared distance of the input to every basis vector
+    void prepare_swap_cache(const ml::decision_function_radial_basis_kernel& df, ml::swap_prediction_cache& cache)
+    {
+        cache.basis_values.reserve(df.basis_vectors.size());
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+            cache.basis_values.push_back(dlib::length_squared(cache.input - df.basis_vectors(i)));
+        cache.prediction = df(cache.input);
+    }
+
+    double swap_update(const ml::decision_function_radial_basis_kernel& df, const ml::swap_prediction_cache& cache, int location1, int location2)
+    {
+        // |x' - s|^2 = |x - s|^2 + 2 (x1 - x2)(s1 - s2)
+        const double x1 = cache.input(location1);
+        const double x2 = cache.input(location2);
+        const double gamma = df.kernel_function.gamma;
+        double value = 0.0;
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+        {
+            const ml::sample_type& sv = df.basis_vectors(i);
+            double distance = cache.basis_values[i] + 2.0 * (x1 - x2) * (sv(location1) - sv(location2));
+            value += df.alpha(i) * std::exp(-gamma * distance);
+        }
+        return value - df.b;
+    }
+
+    double cycle_update(const ml::decision_function_radial_basis_kernel& df, const ml::swap_prediction_cache& cache, int location1, int location2, int location3)
+    {
+        // the squared norm of x does not change: |x' - s|^2 = |x - s|^2 - 2 sum_r d_r s_r
+        const double d1 = cache.input(location3) - cache.input(location1);
+        const double d2 = cache.input(location1) - cache.input(location2);
+        const double d3 = cache.input(location2) - cache.input(location3);
+        const double gamma = df.kernel_function.gamma;
+        double value = 0.0;
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+        {
+            const ml::sample_type& sv = df.basis_vectors(i);
+            double distance = cache.basis_values[i] - 2.0 * (d1 * sv(location1) + d2 * sv(location2) + d3 * sv(location3));
+            value += df.alpha(i) * std::exp(-gamma * distance);
+        }
+        return value - df.b;
+    }
+
+    // Histogram intersection kernel: only the terms of the changed locations change
+    void prepare_swap_cache(const ml::decision_function_histogram_intersection_kernel& df, ml::swap_prediction_cache& cache)
+    {
+        cache.prediction = df(cache.input);
+    }
+
+    double swap_update(const ml::decision_function_histogram_intersection_kernel& df, const ml::swap_prediction_cache& cache, int location1, int location2)
+    {
+        const double x1 = cache.input(location1);
+        const double x2 = cache.input(location2);
+        double delta = 0.0;
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+        {
+            const ml::sample_type& sv = df.basis_vectors(i);
+            delta += df.alpha(i) * (std::min(x2, sv(location1)) + std::min(x1, sv(location2))
+                                    - std::min(x1, sv(location1)) - std::min(x2, sv(location2)));
+        }
+        return cache.prediction + delta;
+    }
+
+    double cycle_update(const ml::decision_function_histogram_intersection_kernel& df, const ml::swap_prediction_cache& cache, int location1, int location2, int location3)
+    {
+        const double x1 = cache.input(location1);
+        const double x2 = cache.input(location2);
+        const double x3 = cache.input(location3);
+        double delta = 0.0;
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+        {
+            const ml::sample_type& sv = df.basis_vectors(i);
+            delta += df.alpha(i) * (std::min(x3, sv(location1)) + std::min(x1, sv(location2)) + std::min(x2, sv(location3))
+                                    - std::min(x1, sv(location1)) - std::min(x2, sv(location2)) - std::min(x3, sv(location3)));
+        }
+        return cache.prediction + delta;
+    }
+
+    // Polynomial kernel: the dot product of the input with every basis vector
+    void prepare_swap_cache(const ml::decision_function_polynomial_kernel& df, ml::swap_prediction_cache& cache)
+    {
+        cache.basis_values.reserve(df.basis_vectors.size());
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+            cache.basis_values.push_back(dlib::dot(cache.input, df.basis_vectors(i)));
+        cache.prediction = df(cache.input);
+    }
+
+    double swap_update(const ml::decision_function_polynomial_kernel& df, const ml::swap_prediction_cache& cache, int location1, int location2)
+    {
+        // x'.s = x.s - (x1 - x2)(s1 - s2)
+        const double x1 = cache.input(location1);
+        const double x2 = cache.input(location2);
+        const double gamma = df.kernel_function.gamma;
+        const double coef = df.kernel_function.coef;
+        const double degree = df.kernel_function.degree;
+        double value = 0.0;
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+        {
+            const ml::sample_type& sv = df.basis_vectors(i);
+            double dot = cache.basis_values[i] - (x1 - x2) * (sv(location1) - sv(location2));
+            value += df.alpha(i) * std::pow(gamma * dot + coef, degree);
+        }
+        return value - df.b;
+    }
+
+    double cycle_update(const ml::decision_function_polynomial_kernel& df, const ml::swap_prediction_cache& cache, int location1, int location2, int location3)
+    {
+        // x'.s = x.s + sum_r d_r s_r
+        const double d1 = cache.input(location3) - cache.input(location1);
+        const double d2 = cache.input(location1) - cache.input(location2);
+        const double d3 = cache.input(location2) - cache.input(location3);
+        const double gamma = df.kernel_function.gamma;
+        const double coef = df.kernel_function.coef;
+        const double degree = df.kernel_function.degree;
+        double value = 0.0;
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+        {
+            const ml::sample_type& sv = df.basis_vectors(i);
+            double dot = cache.basis_values[i] + d1 * sv(location1) + d2 * sv(location2) + d3 * sv(location3);
+            value += df.alpha(i) * std::pow(gamma * dot + coef, degree);
+        }
+        return value - df.b;
+    }
+
+    // Linear kernel: f(x) = w.x - b, with the weights w = sum alpha_i * x_i
+    void prepare_swap_cache(const ml::decision_function_linear_kernel& df, ml::swap_prediction_cache& cache)
+    {
+        cache.basis_values.assign(cache.input.size(), 0.0);
+        for(long i = 0; i < df.basis_vectors.size(); ++i)
+            for(long r = 0; r < cache.input.size(); ++r)
+                cache.basis_values[r] += df.alpha(i) * df.basis_vectors(i)(r);
+        cache.prediction = df(cache.input);
+    }
+
+    double swap_update(const ml::decision_function_linear_kernel&, const ml::swap_prediction_cache& cache, int location1, int location2)
+    {
+        const double x1 = cache.input(location1);
+        const double x2 = cache.input(location2);
+        return cache.prediction - (x1 - x2) * (cache.basis_values[location1] - cache.basis_values[location2]);
+    }
+
+    double cycle_update(const ml::decision_function_linear_kernel&, const ml::swap_prediction_cache& cache, int location1, int location2, int location3)
+    {
+        const double d1 = cache.input(location3) - cache.input(location1);
+        const double d2 = cache.input(location1) - cache.input(location2);
+        const double d3 = cache.input(location2) - cache.input(location3);
+        return cache.prediction + d1 * cache.basis_values[location1] + d2 * cache.basis_values[location2] + d3 * cache.basis_values[location3];
+    }
+
+    // Regression trees: a prediction is a single walk down every tree, so the input after the move is evaluated directly
+    void prepare_swap_cache(const ml::boosted_trees& trees, ml::swap_prediction_cache& cache)
+    {
+        cache.prediction = trees(cache.input);
+    }
+
+    double swap_update(const ml::boosted_trees& trees, const ml::swap_prediction_cache& cache, int location1, int location2)
+    {
+        ml::sample_type input = cache.input;
+        input(location1) = cache.input(location2);
+        input(location2) = cache.input(location1);
+        return trees(input);
+    }
+
+    double cycle_update(const ml::boosted_trees& trees, const ml::swap_prediction_cache& cache, int location1, int location2, int location3)
+    {
+        ml::sample_type input = cache.input;
+        input(location1) = cache.input(location3);
+        input(location2) = cache.input(location1);
+        input(location3) = cache.input(location2);
+        return trees(input);
+    }
+
+    // Lower bound on the prediction for any non-negative input (minus infinity if not bounded from below)
+    double prediction_lower_bound(const ml::decision_function_radial_basis_kernel& df)
+    {
+        // 0 < k(x,s) <= 1
+        double bound = -df.b;
+        for(long i = 0; i < df.alpha.size(); ++i)
+            bound += std::min(df.alpha(i), 0.0);
+        return bound;
+    }
+
+    double prediction_lower_bound(const ml::decision_function_histogram_intersection_kernel& df)
+    {
+        // 0 <= k(x,s) <= sum(s)
+        double bound = -df.b;
+        for(long i = 0; i < df.alpha.size(); ++i)
+            bound += std::min(df.alpha(i), 0.0) * dlib::sum(df.basis_vectors(i));
+        return bound;
+    }
+
+    double prediction_lower_bound(const ml::decision_function_polynomial_kernel& df)
+    {
+        // k(x,s) >= coef^degree, but not bounded from above
+        double bound = -df.b;
+        for(long i = 0; i < df.alpha.size(); ++i)
+        {
+            if(df.alpha(i) < 0)
+                return -std::numeric_limits<double>::infinity();
+            bound += df.alpha(i) * std::pow(df.kernel_function.coef, df.kernel_function.degree);
+        }
+        return bound;
+    }
+
+    double prediction_lower_bound(const ml::decision_function_linear_kernel& df)
+    {
+        // w.x - b >= -b if all weights are non-negative
+        if(df.basis_vectors.size() == 0)
+            return -df.b;
+        ml::sample_type weights = df.alpha(0) * df.basis_vectors(0);
+        for(long i = 1; i < df.basis_vectors.size(); ++i)
+            weights += df.alpha(i) * df.basis_vectors(i);
+        if(dlib::min(weights) < 0)
+            return -std::numeric_limits<double>::infinity();
+        return -df.b;
+    }
+
+    double prediction_lower_bound(const ml::boosted_trees& trees)
+    {
+        // every tree adds one of its leaves
+        return trees.lower_bound();
+    }
+
+    // Kernel of a model (e.g. for the predictive variance), 0 for models without kernel
+    template<typename kernel_type>
+    double evaluate_kernel(const dlib::decision_function<kernel_type>& df, const ml::sample_type& a, const ml::sample_type& b) { return df.kernel_function(a, b); }
+    double evaluate_kernel(const ml::boosted_trees&, const ml::sample_type&, const ml::sample_type&) { return 0.0; }
+
+    // Name of a learning method (for the output)
+    QString learning_method_name(ml::learning_method lm)
+    {
+        switch(lm)
+        {
+        case ml::learning_method::krr_trainer_radial_basis_kernel:              return "KRR - Radial Basis Kernel";
+        case ml::learning_method::krr_trainer_histogram_intersection_kernel:    return "KRR - Histogram Intersection Kernel";
+        case ml::learning_method::krr_trainer_polynomial_kernel_quadratic:      return "KRR - Quadratic Kernel";
+        case ml::learning_method::krr_trainer_polynomial_kernel_cubic:          return "KRR - Cubic Kernel";
+        case ml::learning_method::krr_trainer_linear_kernel:                    return "KRR - Linear Kernel";
+        case ml::learning_method::svr_trainer_radial_basis_kernel:              return "SVR - Radial Basis Kernel";
+        case ml::learning_method::svr_trainer_histogram_intersection_kernel:    return "SVR - Histogram Intersection Kernel";
+        case ml::learning_method::svr_trainer_polynomial_kernel_quadratic:      return "SVR - Quadratic Kernel";
+        case ml::learning_method::svr_trainer_polynomial_kernel_cubic:          return "SVR - Cubic Kernel";
+        case ml::learning_method::svr_trainer_linear_kernel:                    return "SVR - Linear Kernel";
+        case ml::learning_method::rvm_trainer_radial_basis_kernel:              return "RVM - Radial Basis Kernel";
+        case ml::learning_method::rvm_trainer_histogram_intersection_kernel:    return "RVM - Histogram Intersection Kernel";
+        case ml::learning_method::rvm_trainer_polynomial_kernel_quadratic:      return "RVM - Quadratic Kernel";
+        case ml::learning_method::rvm_trainer_polynomial_kernel_cubic:          return "RVM - Cubic Kernel";
+        case ml::learning_method::rvm_trainer_linear_kernel:                    return "RVM - Linear Kernel";
+        case ml::learning_method::nystroem_trainer_radial_basis_kernel:         return "Nystroem KRR - Radial Basis Kernel";
+        case ml::learning_method::gbt_trainer_regression_trees:                 return "GBT - Regression Trees";
+        case ml::learning_method::krls_trainer_radial_basis_kernel:             return "KRLS (online) - Radial Basis Kernel";
+        }
+        return "Unknown learning method";
+    }
+
+    // Trainer of a learning method with a fixed kernel and regularization parameter (e.g. for the cross-validation)
+    template<typename kernel_type>
+    struct learning_method_trainer
+    {
+        ml::learning_method lm;
+        kernel_type kernel;
+        double regularization;
+
+        dlib::decision_function<kernel_type> train(const std::vector<ml::sample_type>& x, const std::vector<double>& y) const
+        {
+            return refit_decision_function(lm, kernel, regularization, x, y);
+        }
+    };
+
+    // Result of a learning method in the comparison of the learning methods
+    struct learning_method_result
+    {
+        ml::learning_method lm = ml::learning_method::krr_trainer_radial_basis_kernel;
+        bool travels = false;
+        dlib::matrix<double,1,4> cv;                // MSE, correlation, MAE and standard deviation of the absolute error (10-fold cross-validation)
+        double training_time = 0.0;                 // seconds (hyperparameter search, training and cross-validation)
+        std::size_t model_size = 0;                 // number of basis vectors, or number of trees
+        double latency = 0.0;                       // microseconds per prediction of the compiled predictor
+        ml::predictor surrogate;                    // the compiled predictor, as the search evaluates it
+        QString error;                              // empty if the learning method was trained successfully
+    };
+
+    // Number of basis vectors of a decision function, or number of trees
+    template<typename kernel_type>
+    std::size_t model_size(const dlib::decision_function<kernel_type>& df) { return df.basis_vectors.size(); }
+    std::size_t model_size(const ml::boosted_trees& trees) { return trees.nb_trees(); }
+
+    // Search the hyperparameters of a trainer (make_trainer creates the trainer for a point of the search),
+    // train it on all data and cross-validate it
+    template<typename make_trainer_type>
+    void fit_trainer(learning_method_result& result, const make_trainer_type& make_trainer,
+                     const dlib::matrix<double,0,1>& lower, const dlib::matrix<double,0,1>& upper,
+                     const std::vector<ml::sample_type>& x, const std::vector<double>& y, std::chrono::nanoseconds time_budget)
+    {
+        const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+        dlib::matrix<double,0,1> best_parameters = lower;
+        if(lower.size() > 0)
+        {
+            best_parameters = minimise_parallel([&](const dlib::matrix<double,0,1>& parameters)
+                                                { return parallel_cross_validate_regression_trainer(make_trainer(parameters), x, y, 10)(0); },
+                                                lower, upper, dlib::max_function_calls(50), time_budget).x;
+        }
+
+        const auto trainer = make_trainer(best_parameters);
+        const auto df = trainer.train(x, y);
+        result.cv = parallel_cross_validate_regression_trainer(trainer, x, y, 10);
+        result.training_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        result.model_size = model_size(df);
+
+        ml::decision_functions dfs;
+        store_decision_function(dfs, df);
+        result.surrogate = ml::predictor::compile(result.lm, dfs);
+    }
+
+    // Search the hyperparameters of a learning method (the kernel parameters followed by the regularization parameter, if any),
+    // train it on all data and cross-validate it
+    template<typename kernel_type>
+    void fit_learning_method(learning_method_result& result, const std::function<kernel_type(const dlib::matrix<double,0,1>&)>& make_kernel,
+                             const dlib::matrix<double,0,1>& lower, const dlib::matrix<double,0,1>& upper, bool regularized,
+                             const std::vector<ml::sample_type>& x, const std::vector<double>& y, std::chrono::nanoseconds time_budget)
+    {
+        auto make_trainer = [&](const dlib::matrix<double,0,1>& parameters)
+        {
+            return learning_method_trainer<kernel_type>{result.lm, make_kernel(parameters), regularized ? parameters(parameters.size()-1) : 0.0};
+        };
+        fit_trainer(result, make_trainer, lower, upper, x, y, time_budget);
+    }
+
+    // Simulate the samples of a design of experiments on the global thread pool (every simulation runs in a Menge worker
+    // process of its own, such that as many simulations as threads run at the same time).
+    // The results are passed to 'store' one at a time as the simulations finish; samples that have not started yet are skipped once 'halt' is set.
+    void simulate_design(int nb_samples, const std::atomic<bool>& halt,
+                         const std::function<double(int)>& simulate, const std::function<void(int, double)>& store)
+    {
+        std::vector<int> samples(std::max(nb_samples, 0));
+        std::iota(samples.begin(), samples.end(), 0);
+
+        QMutex store_mutex;
+        QtConcurrent::blockingMap(samples, [&](int& sample)
+        {
+            if(halt)
+                return;
+            double value = simulate(sample);
+            QMutexLocker locker(&store_mutex);
+            store(sample, value);
+        });
+    }
 }
 
 
@@ -110,6 +1179,16 @@ namespace ml
     }
 
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    std::uint64_t surrogate_paths::map_hash() const
+    {
+        global::data_hash hash;
+        hash << _nb_nodes << _nb_paths << _room_node << _node_node_path << _paths_rooms;
+        return hash.value();
+    }
+
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     sample_type surrogate_paths::transfrom_solution_to_ml_sample(const timetable::solution& sol, int first_timeslot) const
@@ -222,240 +1301,656 @@ namespace ml
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    void surrogate_paths::generate_observations(ped::menge_interface *menge, std::vector<sample_type>& x_obs, std::vector<double>& y_obs, int nb_observations)
+    void surrogate_paths::generate_observations(ped::menge_interface *menge, std::vector<sample_type>& x_obs, std::vector<double>& y_obs, int nb_observations,
+                                                const std::atomic<bool> *halt)
     {
         // DESIGN OF EXPERIMENTS
         QString output_text;
         std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
 
+        output_text = "\nGenerating training data travels ...";
+        emit(signal_stat(output_text));
 
+        // 1. initialize vector of training data
+        x_obs.clear();
+        x_obs.reserve(nb_observations);
+        y_obs.clear();
+        y_obs.reserve(nb_observations);
 
-        /*QString filename = QStringLiteral("training_data_travels.txt");
-        QFile file(filename);
 
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) // read data from file
+        // 2. observations stored by previous runs for the same building, surrogate map and pedestrian model
+        global::data_hash key;
+        key << QString("travels") << building::data_hash() << map_hash() << menge->parameters_hash() << _nb_paths;
+        training_data_store store(training_data_store::file_name("training_data_travels", key.value()), key.value(), _nb_paths);
+
+        std::vector<sample_type> stored_x;
+        std::vector<double> stored_y;
+        const int nb_stored = store.load(stored_x, stored_y);
+        const int nb_reused = std::min(nb_stored, nb_observations - 1);
+        for(int obs = 0; obs < nb_reused; ++obs)
+        {
+            x_obs.push_back(stored_x[obs]);
+            y_obs.push_back(stored_y[obs]);
+        }
+        if(nb_stored > 0)
         {
-            output_text = "\nImporting training data travels from file";
+            output_text = "    Reusing ";
+            output_text.append(QString::number(nb_reused));
+            output_text.append(" stored observations");
             emit(signal_stat(output_text));
+        }
+
+
+        // 3. maximum number of people on one path (approximate)
+        int compression_factor = std::ceil((double)building::room_targets.size() / _nb_nodes) + 0.1;
+        std::vector<int> sorted_nb_people_per_event = timetable::eventgroup_nb_people;
+        std::sort(sorted_nb_people_per_event.begin(), sorted_nb_people_per_event.end());
+        int max_nb_people = 0;
+        int pos = sorted_nb_people_per_event.size() - 1;
+        for(int p = 0; p < compression_factor; ++p)
+        {
+            max_nb_people += sorted_nb_people_per_event[pos];
+            --pos;
+        }
+
+
+        // 4. latin hypercube sampling of the observations that are not stored yet
+        // (a separate design for every extension, such that the stored design is never resampled)
+        const int nb_new = nb_observations - 1 - nb_reused;
+        const int nb_strata = nb_new + 1;
+        generator = global::_random_streams.make_generator(global::random_stream::latin_hypercube, 2*static_cast<std::uint64_t>(nb_stored) + 1);
+        std::vector<std::vector<int>> paths_remaining_strata;
+        std::vector<int> vec_;
+        vec_.reserve(nb_strata);
+        for(int i = 0; i < nb_strata; ++i)
+            vec_.push_back(i);
+
+        for(int p = 0; p < _nb_paths; ++p)   // initialize strata
+            paths_remaining_strata.push_back(vec_);
+
+        // generate the samples first, such that the design does not depend on the order in which the simulations finish
+        std::vector<std::vector<int>> design_paths_nb_people;
+        std::vector<std::vector<int>> design_room_room_nb_people;
+        design_paths_nb_people.reserve(nb_new);
+        design_room_room_nb_people.reserve(nb_new);
+        for(int obs = 0; obs < nb_new; ++obs)
+        {
+            std::vector<int> paths_nb_people;
+            paths_nb_people.reserve(timetable::nb_locations);
 
-            QTextStream stream(&file);
-            stream >> nb_observations;
+            //qDebug() << "Observation " << obs+1;
 
-            for(size_t i = 0; i < nb_observations; ++i)
+            for(int p = 0; p < _nb_paths; ++p) // generate the number of every people on each path
             {
-                sample_type sample;
-                sample.set_size(_nb_paths);
-                for(size_t j = 0; j < _nb_paths; ++j)
+                const double probability_path_used = 0.5;
+                std::bernoulli_distribution dist_path_used(probability_path_used);
+                if(dist_path_used(generator)) // if path used
                 {
-                    int people;
-                    stream >> people;
-                    sample(j) = people;
+                    std::uniform_int_distribution<int> dist_index(0, paths_remaining_strata[p].size() - 1);
+                    int index = dist_index(generator);
+                    int stratum = paths_remaining_strata[p][index];
+                    int nbp = stratum * max_nb_people / (nb_strata - 1) +0.1;     // borders of the stratum (one group less so that both endpoints are sampled)
+                    //int nbp = (int)((double)(stratum + 0.5) * room_max_nb_people[r] / nb_training_data + 0.5); // middle of the stratum
+
+                    const bool maximum_sample = (obs == 0 && nb_stored == 0);  // the first sample of a new design has the maximum number of people
+                    if(maximum_sample)
+                        paths_nb_people.push_back(max_nb_people);
+                    else
+                        paths_nb_people.push_back(nbp);
+
+                    // delete this stratum from the vector
+                    if(!maximum_sample)
+                        paths_remaining_strata[p].erase(paths_remaining_strata[p].begin() + index);
                 }
-                x_obs.push_back(sample);
+                else // path not used
+                    paths_nb_people.push_back(0);
 
-                double traveltime;
-                stream >> traveltime;
-                y_obs.push_back(traveltime);
+                //qDebug() << "Path " << p+1 << ", nb_people = " << paths_nb_people.back();
+            }
+
+            // divide people on path evenly(?) (randomly) over rooms
+            std::vector<int> room_room_nb_people;
+            room_room_nb_people.reserve((timetable::nb_locations+1)*(timetable::nb_locations+1));
+            for(int i = 0; i < _room_node.size()*_room_node.size(); ++i)
+                room_room_nb_people.push_back(0);
+            for(int p = 0; p < _nb_paths; ++p)
+            {
+                const int nb_combos = _paths_rooms[p].size() * (_paths_rooms[p].size()-1);
+                int nbp = std::round((double)paths_nb_people[p] / nb_combos);
+                for(auto&& r1: _paths_rooms[p])
+                {
+                    for(auto&& r2: _paths_rooms[p])
+                    {
+                        if(r1!=r2)
+                            room_room_nb_people[r1*_room_node.size() + r2] += nbp;
+                    }
+                }
             }
+
+            design_paths_nb_people.push_back(std::move(paths_nb_people));
+            design_room_room_nb_people.push_back(std::move(room_room_nb_people));
+        }
+
+
+        // 5. use menge to estimate the travel times of all new samples in parallel
+        // (every observation is added to the store as soon as it has been simulated)
+        std::vector<sample_type> design_x(design_paths_nb_people.size());
+        for(size_t obs = 0; obs < design_paths_nb_people.size(); ++obs)
+        {
+            design_x[obs].set_size(_nb_paths);
+            for(int p = 0; p < _nb_paths; ++p)
+                design_x[obs](p) = design_paths_nb_people[obs][p];
         }
+        std::atomic<bool> no_halt(false);
+        std::vector<double> traveltimes(design_paths_nb_people.size(), 0.0);
+        std::vector<bool> simulated(design_paths_nb_people.size(), false);
+        int nb_simulated = 0;
+        emit(signal_progress_started(nb_observations));
+        emit(signal_progress(nb_reused, nb_observations));
+
+        simulate_design(design_paths_nb_people.size(), halt ? *halt : no_halt,
+                        [&](int obs) { return menge->calculate_custom_travel_time(design_room_room_nb_people[obs], nb_stored + obs); },
+                        [&](int obs, double traveltime)
+        {
+            traveltimes[obs] = std::max(traveltime, 0.0);
+            simulated[obs] = true;
+            ++nb_simulated;
+
+            try {
+                store.append(design_x[obs], traveltimes[obs]);
+            } catch(std::exception& e) {
+                global::_logger << global::logger::log_type::WARNING << e.what();
+            }
 
-        else*/
+            QString text = "    Observation ";
+            text.append(QString::number(nb_reused + obs + 1));
+            text.append("; Travel time = ");
+            text.append(QString::number(traveltimes[obs]));
+            text.append(" seconds");
+            emit(signal_stat(text));
+            emit(signal_progress(nb_reused + nb_simulated, nb_observations));
+        });
 
+        if(nb_simulated < (int)design_paths_nb_people.size())
         {
-            output_text = "\nGenerating training data travels ...";
+            output_text = "Generation of training data travels halted after ";
+            output_text.append(QString::number(nb_simulated));
+            output_text.append(" simulations");
             emit(signal_stat(output_text));
+            global::_logger << global::logger::log_type::WARNING << "Generation of training data travels halted after " << nb_simulated << " of " << nb_new << " simulations.";
+            if(nb_reused + nb_simulated == 0)
+                throw std::runtime_error("Error in function ml::surrogate_paths::generate_observations. \nThe generation of the training data was halted before any sample was simulated.");
+        }
 
-            // 1. initialize vector of training data
-            x_obs.clear();
-            x_obs.reserve(nb_observations);
-            y_obs.clear();
-            y_obs.reserve(nb_observations);
+        // 6. put the observations in matrix (in the order of the design)
+        for(size_t obs = 0; obs < design_paths_nb_people.size(); ++obs)
+        {
+            if(!simulated[obs])
+                continue;
+            x_obs.push_back(design_x[obs]);
+            y_obs.push_back(traveltimes[obs]);
+        }
 
+        // add row with all zeros
+        sample_type mat;
+        mat.set_size(_nb_paths);
+        for(int p = 0; p < _nb_paths; ++p)
+            mat(p) = 0;
+        x_obs.push_back(mat);
+        y_obs.push_back(0.0);
+        output_text = "    Observation ";
+        output_text.append(QString::number(nb_observations));
+        output_text.append("; Travel time = 0 seconds");
+        emit(signal_stat(output_text));
+        emit(signal_progress(nb_observations, nb_observations));
+
+
+
+        std::chrono::nanoseconds elapsed_time = std::chrono::system_clock::now() - start_time;
+        double _time_generating_data_travels = elapsed_time.count() / NANO;
+        output_text = "Finished generating training data. Elapsed time: ";
+        output_text.append(QString::number(_time_generating_data_travels));
+        output_text.append(" seconds");
+        emit(signal_stat(output_text));
+        global::_logger << global::logger::log_type::INFORMATION << "Generated " << x_obs.size() << " training data travels ("
+                        << nb_reused << " stored, " << nb_simulated << " simulated).\nElapsed time = " << _time_generating_data_travels << " seconds.";
+    }
 
-            // 2. maximum number of people on one path (approximate)
-            int compression_factor = std::ceil((double)building::room_targets.size() / _nb_nodes) + 0.1;
-            std::vector<int> sorted_nb_people_per_event = timetable::eventgroup_nb_people;
-            std::sort(sorted_nb_people_per_event.begin(), sorted_nb_people_per_event.end());
-            int max_nb_people = 0;
-            int pos = sorted_nb_people_per_event.size() - 1;
-            for(int p = 0; p < compression_factor; ++p)
-            {
-                max_nb_people += sorted_nb_people_per_event[pos];
-                --pos;
-            }
 
 
-            // 3. latin hypercube sampling
-            std::vector<std::vector<int>> paths_remaining_strata;
-            std::vector<int> vec_;
-            vec_.reserve(nb_observations);
-            for(int i = 0; i < nb_observations; ++i)
-                vec_.push_back(i);
 
-            for(int p = 0; p < _nb_paths; ++p)   // initialize strata
-                paths_remaining_strata.push_back(vec_);
 
-            // generate N observations and use menge to analyze them
-            for(int obs = 0; obs < nb_observations - 1; ++obs)
-            {
-                std::vector<int> paths_nb_people;
-                paths_nb_people.reserve(timetable::nb_locations);
 
-                //qDebug() << "Observation " << obs+1;
 
-                for(int p = 0; p < _nb_paths; ++p) // generate the number of every people on each path
-                {
-                    const double probability_path_used = 0.5;
-                    std::bernoulli_distribution dist_path_used(probability_path_used);
-                    if(dist_path_used(generator)) // if path used
-                    {
-                        std::uniform_int_distribution<int> dist_index(0, paths_remaining_strata[p].size() - 1);
-                        int index = dist_index(generator);
-                        int stratum = paths_remaining_strata[p][index];
-                        int nbp = stratum * max_nb_people / (nb_observations - 1) +0.1;     // borders of the stratum (one group less so that both endpoints are sampled)
-                        //int nbp = (int)((double)(stratum + 0.5) * room_max_nb_people[r] / nb_training_data + 0.5); // middle of the stratum
-
-                        if(obs == 0)
-                            paths_nb_people.push_back(max_nb_people);
-                        else
-                            paths_nb_people.push_back(nbp);
-
-                        // delete this stratum from the vector
-                        if(obs > 0)
-                            paths_remaining_strata[p].erase(paths_remaining_strata[p].begin() + index);
-                    }
-                    else // path not used
-                        paths_nb_people.push_back(0);
 
-                    //qDebug() << "Path " << p+1 << ", nb_people = " << paths_nb_people.back();
-                }
 
-                // divide people on path evenly(?) (randomly) over rooms
-                std::vector<int> room_room_nb_people;
-                room_room_nb_people.reserve((timetable::nb_locations+1)*(timetable::nb_locations+1));
-                for(int i = 0; i < _room_node.size()*_room_node.size(); ++i)
-                    room_room_nb_people.push_back(0);
-                for(int p = 0; p < _nb_paths; ++p)
-                {
-                    const int nb_combos = _paths_rooms[p].size() * (_paths_rooms[p].size()-1);
-                    int nbp = std::round((double)paths_nb_people[p] / nb_combos);
-                    for(auto&& r1: _paths_rooms[p])
-                    {
-                        for(auto&& r2: _paths_rooms[p])
-                        {
-                            if(r1!=r2)
-                                room_room_nb_people[r1*_room_node.size() + r2] += nbp;
-                        }
-                    }
-                }
 
-                // use menge to estimate travel time
-                double traveltime = menge->calculate_custom_travel_time(room_room_nb_people);
-                if(traveltime < 0)
-                    traveltime = 0;
-
-                // put observation in matrix
-                sample_type mat;
-                mat.set_size(paths_nb_people.size());
-                for(int p = 0; p < _nb_paths; ++p)
-                    mat(p) = paths_nb_people[p];
-                x_obs.push_back(mat);
-                y_obs.push_back(traveltime);
-
-                output_text = "    Observation ";
-                output_text.append(QString::number(obs+1));
-                output_text.append("; Travel time = ");
-                output_text.append(QString::number(traveltime));
-                output_text.append(" seconds");
-                emit(signal_stat(output_text));
+
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///                                                                                                              ///
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+    machine_learning_interface::machine_learning_interface()
+    {
+
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    machine_learning_interface::~machine_learning_interface()
+    {
+        _refinement.waitForFinished();
+    }
+
+
+
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void machine_learning_interface::clear()
+    {
+        _nb_training_data = 0;
+        _training_data_evac_x.clear();
+        _training_data_evac_y.clear();
+        _training_data_travels_x.clear();
+        _training_data_travels_y.clear();
+        _trained_surrogate_evacuations = false;
+        _trained_surrogate_travels = false;
+        _cv_rmse_evacuations = 0.0;
+        _cv_rmse_travels = 0.0;
+        _nb_observations_added = 0;
+        _observed_evacuations = observed_rows();
+        _observed_travels = observed_rows();
+        _predictive_variance_prepared = false;
+        std::atomic_store(&_variance_model_evacuations, std::shared_ptr<const predictive_variance_model>());
+        std::atomic_store(&_variance_model_travels, std::shared_ptr<const predictive_variance_model>());
+        ++_variance_version;
+        _predictor_evacuations = predictor();
+        _predictor_travels = predictor();
+        _online_evacuations = online_learner();
+        _online_travels = online_learner();
+    }
+
+
+
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    sample_type machine_learning_interface::evacuation_sample(const timetable::solution& sol, int timeslot) const
+    {
+        sample_type input_data;
+        input_data.set_size(timetable::nb_locations);
+        for(int r = 0; r < timetable::nb_locations; ++r) {
+            int event = sol.timeslot_location(timeslot, r);
+            if(event >= 0) {
+                int nb_people = timetable::get_event_nb_people(event);
+                input_data(r) = nb_people;
+            }
+            else {
+                input_data(r) = 0;
             }
+        }
+        return input_data;
+    }
 
-            // add row with all zeros
-            sample_type mat;
-            mat.set_size(_nb_paths);
-            for(int p = 0; p < _nb_paths; ++p)
-                mat(p) = 0;
-            x_obs.push_back(mat);
-            y_obs.push_back(0.0);
-            output_text = "    Observation ";
-            output_text.append(QString::number(nb_observations));
-            output_text.append("; Travel time = 0 seconds");
-            emit(signal_stat(output_text));
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    struct predictor::model
+    {
+        virtual ~model() = default;
+        virtual double predict(const sample_type& x) const = 0;
+        virtual void predict(const std::vector<sample_type>& x, std::vector<double>& y) const = 0;
+        virtual std::string kernel_name() const = 0;
+        virtual void save(const std::string& filename) const = 0;
+        virtual void prepare_swaps(swap_prediction_cache& cache) const = 0;
+        virtual double predict_swap(const swap_prediction_cache& cache, int location1, int location2) const = 0;
+        virtual double predict_cycle(const swap_prediction_cache& cache, int location1, int location2, int location3) const = 0;
+        virtual double lower_bound() const = 0;
+        virtual double kernel_value(const sample_type& a, const sample_type& b) const = 0;
+        virtual decision_functions refit(learning_method lm, double regularization, const std::vector<sample_type>& x, const std::vector<double>& y) const = 0;
+    };
+
+    template<typename function_type, typename evaluator_type>
+    struct predictor::model_impl : predictor::model
+    {
+        model_impl(const function_type& decision_function, evaluator_type compiled_evaluator)
+            : df(decision_function), evaluator(std::move(compiled_evaluator))
+        {
+
+        }
+
+        double predict(const sample_type& x) const override
+        {
+            return evaluator(x);
+        }
+
+        void predict(const std::vector<sample_type>& x, std::vector<double>& y) const override
+        {
+            // the evaluator is known here, such that the loop has no dispatch
+            y.resize(x.size());
+            for(std::size_t i = 0; i < x.size(); ++i)
+                y[i] = evaluator(x[i]);
+        }
+
+        std::string kernel_name() const override
+        {
+            return model_abbreviation(df);
+        }
+
+        void save(const std::string& filename) const override
+        {
+            dlib::serialize(filename) << df;
+        }
+
+        void prepare_swaps(swap_prediction_cache& cache) const override
+        {
+            prepare_swap_cache(df, cache);
+        }
+
+        double predict_swap(const swap_prediction_cache& cache, int location1, int location2) const override
+        {
+            return swap_update(df, cache, location1, location2);
+        }
+
+        double predict_cycle(const swap_prediction_cache& cache, int location1, int location2, int location3) const override
+        {
+            return cycle_update(df, cache, location1, location2, location3);
+        }
+
+        double lower_bound() const override
+        {
+            return prediction_lower_bound(df);
+        }
+
+        double kernel_value(const sample_type& a, const sample_type& b) const override
+        {
+            return evaluate_kernel(df, a, b);
+        }
+
+        decision_functions refit(learning_method lm, double regularization, const std::vector<sample_type>& x, const std::vector<double>& y) const override
+        {
+            decision_functions refined;
+            store_decision_function(refined, refit_model(lm, df, regularization, x, y));
+            return refined;
+        }
+
+        function_type df;
+        evaluator_type evaluator;
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    predictor predictor::compile(learning_method lm, const decision_functions& df)
+    {
+        predictor compiled;
+
+        if(uses_radial_basis_kernel(lm))
+        {
+            compiled._model = std::make_shared<const model_impl<decision_function_radial_basis_kernel, radial_basis_evaluator>>(
+                        df.dec_func_rbk, compile_radial_basis(df.dec_func_rbk));
+        }
+        else if(uses_histogram_intersection_kernel(lm))
+        {
+            compiled._model = std::make_shared<const model_impl<decision_function_histogram_intersection_kernel, decision_function_evaluator<histogram_intersection_kernel>>>(
+                        df.dec_func_hik, decision_function_evaluator<histogram_intersection_kernel>{df.dec_func_hik});
+        }
+        else if(uses_polynomial_kernel(lm))
+        {
+            const decision_function_polynomial_kernel& f = df.dec_func_pk;
+            const double degree = f.kernel_function.degree;
+            if(degree == 1.0 && polynomial_expansion_is_cheaper(f))
+                compiled._model = std::make_shared<const model_impl<decision_function_polynomial_kernel, polynomial_evaluator<1>>>(f, compile_polynomial<1>(f));
+            else if(degree == 2.0 && polynomial_expansion_is_cheaper(f))
+                compiled._model = std::make_shared<const model_impl<decision_function_polynomial_kernel, polynomial_evaluator<2>>>(f, compile_polynomial<2>(f));
+            else if(degree == 3.0 && polynomial_expansion_is_cheaper(f))
+                compiled._model = std::make_shared<const model_impl<decision_function_polynomial_kernel, polynomial_evaluator<3>>>(f, compile_polynomial<3>(f));
+            else
+                compiled._model = std::make_shared<const model_impl<decision_function_polynomial_kernel, polynomial_kernel_evaluator>>(f, compile_polynomial_kernel(f));
+        }
+        else if(uses_linear_kernel(lm))
+        {
+            compiled._model = std::make_shared<const model_impl<decision_function_linear_kernel, polynomial_evaluator<1>>>(df.dec_func_lk, compile_linear(df.dec_func_lk));
+        }
+        else if(uses_boosted_trees(lm))
+        {
+            // the flattened trees are their own evaluation
+            compiled._model = std::make_shared<const model_impl<boosted_trees, boosted_trees>>(df.dec_func_gbt, df.dec_func_gbt);
+        }
+
+        return compiled;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // the compiled decision function is loaded atomically once per call, since another thread may publish a new one
+
+    double predictor::operator()(const sample_type& x) const
+    {
+        const std::shared_ptr<const model> current = std::atomic_load(&_model);
+        return current ? current->predict(x) : 0.0;
+    }
+
+    void predictor::predict(const std::vector<sample_type>& x, std::vector<double>& y) const
+    {
+        const std::shared_ptr<const model> current = std::atomic_load(&_model);
+        if(current)
+            current->predict(x, y);
+        else
+            y.assign(x.size(), 0.0);
+    }
+
+    std::string predictor::kernel_name() const
+    {
+        const std::shared_ptr<const model> current = std::atomic_load(&_model);
+        return current ? current->kernel_name() : std::string();
+    }
+
+    void predictor::save(const std::string& filename) const
+    {
+        const std::shared_ptr<const model> current = std::atomic_load(&_model);
+        if(!current)
+            throw std::runtime_error("Error in function ml::predictor::save. \nThe predictor is empty.");
+        current->save(filename);
+    }
+
+    swap_prediction_cache predictor::prepare_swaps(const sample_type& input) const
+    {
+        swap_prediction_cache cache;
+        cache.input = input;
+        cache.model = snapshot();
+        if(cache.model._model)
+            cache.model._model->prepare_swaps(cache);
+        return cache;
+    }
+
+    // the snapshot in the cache is never published to, so it is read without atomic load
+
+    double predictor::predict_swap(const swap_prediction_cache& cache, int location1, int location2)
+    {
+        if(cache.input(location1) == cache.input(location2) || !cache.model._model)
+            return cache.prediction;
+        return cache.model._model->predict_swap(cache, location1, location2);
+    }
+
+    double predictor::predict_cycle(const swap_prediction_cache& cache, int location1, int location2, int location3)
+    {
+        const double x1 = cache.input(location1);
+        if((x1 == cache.input(location2) && x1 == cache.input(location3)) || !cache.model._model)
+            return cache.prediction;
+        return cache.model._model->predict_cycle(cache, location1, location2, location3);
+    }
+
+    double predictor::lower_bound() const
+    {
+        const std::shared_ptr<const model> current = std::atomic_load(&_model);
+        return current ? current->lower_bound() : -std::numeric_limits<double>::infinity();
+    }
+
+    double predictor::kernel_value(const sample_type& a, const sample_type& b) const
+    {
+        const std::shared_ptr<const model> current = std::atomic_load(&_model);
+        return current ? current->kernel_value(a, b) : 0.0;
+    }
+
+    decision_functions predictor::refit(learning_method lm, double regularization, const std::vector<sample_type>& x, const std::vector<double>& y) const
+    {
+        const std::shared_ptr<const model> current = std::atomic_load(&_model);
+        if(!current)
+            throw std::runtime_error("Error in function ml::predictor::refit. \nThe predictor is empty.");
+        return current->refit(lm, regularization, x, y);
+    }
+
+    predictor predictor::snapshot() const
+    {
+        predictor copy;
+        copy._model = std::atomic_load(&_model);
+        return copy;
+    }
+
+    void predictor::publish(const predictor& other)
+    {
+        std::atomic_store(&_model, std::atomic_load(&other._model));
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void online_learner::reset(const radial_basis_kernel& kernel, double tolerance, unsigned long max_dictionary_size)
+    {
+        _krls.reset(new dlib::krls<radial_basis_kernel>(kernel, tolerance, max_dictionary_size));
+    }
+
+    void online_learner::add_sample(const sample_type& x, double y)
+    {
+        if(!_krls)
+            throw std::runtime_error("Error in function ml::online_learner::add_sample. \nThe learner has not been started.");
+        _krls->train(x, y);
+    }
+
+    void online_learner::add_samples(const std::vector<sample_type>& x, const std::vector<double>& y)
+    {
+        if(!_krls)
+            throw std::runtime_error("Error in function ml::online_learner::add_samples. \nThe learner has not been started.");
+        if(x.size() != y.size())
+            throw std::runtime_error("Error in function ml::online_learner::add_samples. \nThe numbers of inputs and outputs differ.");
+        for(std::size_t i = 0; i < x.size(); ++i)
+            _krls->train(x[i], y[i]);
+    }
+
+    decision_function_radial_basis_kernel online_learner::decision_function() const
+    {
+        return _krls ? _krls->get_decision_function() : decision_function_radial_basis_kernel();
+    }
+
+    predictor online_learner::snapshot() const
+    {
+        decision_functions df;
+        df.dec_func_rbk = decision_function();
+        return predictor::compile(learning_method::krls_trainer_radial_basis_kernel, df);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void machine_learning_interface::compile_predictors()
+    {
+        _predictor_evacuations.publish(predictor::compile(_learning_method, _decision_functions_evacuations));
+        _predictor_travels.publish(predictor::compile(_learning_method, _decision_functions_travels));
+        ++_surrogate_version;
+    }
 
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-            std::chrono::nanoseconds elapsed_time = std::chrono::system_clock::now() - start_time;
-            double _time_generating_data_travels = elapsed_time.count() / NANO;
-            output_text = "Finished generating training data. Elapsed time: ";
-            output_text.append(QString::number(_time_generating_data_travels));
-            output_text.append(" seconds");
-            emit(signal_stat(output_text));
-            global::_logger << global::logger::log_type::INFORMATION << "Generated " << nb_observations << " training data travels.\nElapsed time = " << _time_generating_data_travels << " seconds.";
+    double machine_learning_interface::predict_evacuation_time(const timetable::solution& sol, int timeslot) const
+    {
+        return _predictor_evacuations(evacuation_sample(sol, timeslot));
+    }
 
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-            /*QFile savefile(filename);
-            if(savefile.open(QIODevice::WriteOnly | QIODevice::Text))
-            {
-                QTextStream stream(&savefile);
-                stream << nb_observations << "\n";
+    std::vector<double> machine_learning_interface::predict_evacuation_times(const timetable::solution& sol) const
+    {
+        std::vector<sample_type> input_data(timetable::nb_timeslots);
+        for(int t = 0; t < timetable::nb_timeslots; ++t)
+            input_data[t] = evacuation_sample(sol, t);
 
-                for(size_t i = 0; i < nb_observations; ++i)
-                {
-                    stream << "\n";
-                    for(size_t j = 0; j < timetable::nb_locations; ++j)
-                        stream << x_obs[i](j) << "\t";
-                    stream << y_obs[i];
-                }
-            }*/
-        }
+        std::vector<double> predictions;
+        _predictor_evacuations.predict(input_data, predictions);
+        return predictions;
     }
 
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    double machine_learning_interface::predict_travel_time(const timetable::solution& sol, int first_timeslot) const
+    {
+        return _predictor_travels(_surrogate_paths->transfrom_solution_to_ml_sample(sol, first_timeslot));
+    }
 
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    std::vector<double> machine_learning_interface::predict_travel_times(const timetable::solution& sol, const std::vector<int>& first_timeslots) const
+    {
+        std::vector<sample_type> input_data(first_timeslots.size());
+        for(std::size_t i = 0; i < first_timeslots.size(); ++i)
+            input_data[i] = _surrogate_paths->transfrom_solution_to_ml_sample(sol, first_timeslots[i]);
 
+        std::vector<double> predictions;
+        _predictor_travels.predict(input_data, predictions);
+        return predictions;
+    }
 
 
 
 
 
-
-    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ///                                                                                                              ///
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-
-    machine_learning_interface::machine_learning_interface()
+    swap_prediction_cache machine_learning_interface::prepare_evacuation_time_swaps(const timetable::solution& sol, int timeslot) const
     {
-
+        // the moves are predicted with a snapshot of the surrogate, which an online learner may replace in the meantime
+        return _predictor_evacuations.prepare_swaps(evacuation_sample(sol, timeslot));
     }
 
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    machine_learning_interface::~machine_learning_interface()
+    double machine_learning_interface::predict_evacuation_time_swap(const swap_prediction_cache& cache, int location1, int location2) const
     {
-
+        return predictor::predict_swap(cache, location1, location2);
     }
 
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+    double machine_learning_interface::predict_evacuation_time_cycle(const swap_prediction_cache& cache, int location1, int location2, int location3) const
+    {
+        return predictor::predict_cycle(cache, location1, location2, location3);
+    }
 
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    void machine_learning_interface::clear()
+    double machine_learning_interface::lower_bound_travel_time() const
     {
-        _nb_training_data = 0;
-        _training_data_evac_x.clear();
-        _training_data_evac_y.clear();
-        _training_data_travels_x.clear();
-        _training_data_travels_y.clear();
-        _trained_surrogate_evacuations = false;
-        _trained_surrogate_travels = false;
+        // the surrogate of an online learner changes with every observation, so a bound of the current one doesn't hold later on
+        if(uses_online_learner(_learning_method))
+            return -std::numeric_limits<double>::infinity();
+
+        // all inputs (number of people on a path) are non-negative
+        return _predictor_travels.lower_bound();
     }
 
 
@@ -464,95 +1959,320 @@ namespace ml
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    double machine_learning_interface::predict_evacuation_time(const timetable::solution& sol, int timeslot) const
+    // ONLINE REFINEMENT
+    void machine_learning_interface::add_observed_row(observed_rows& observed, std::vector<sample_type>& x, std::vector<double>& y,
+                                                      std::uint64_t hash, const sample_type& sample, double value)
     {
-        // 1. transform data into sample_type
-        sample_type input_data;
-        input_data.set_size(timetable::nb_locations);
-        for(int r = 0; r < timetable::nb_locations; ++r) {
-            int event = sol.timeslot_location(timeslot, r);
-            if(event >= 0) {
-                int nb_people = timetable::get_event_nb_people(event);
-                input_data(r) = nb_people;
-            }
-            else {
-                input_data(r) = 0;
-            }
+        // a replication of an observed configuration updates the running mean of its row
+        // (the row is checked, since training reorders the data and a hash may collide)
+        auto it = observed.rows.find(hash);
+        if(it != observed.rows.end() && it->second.first < x.size() && x[it->second.first] == sample)
+        {
+            const size_t row = it->second.first;
+            const size_t count = ++it->second.second;
+            y[row] += (value - y[row]) / static_cast<double>(count);
+            return;
+        }
+        if(it != observed.rows.end())
+            observed.rows.erase(it);
+
+        // evict the oldest observed configuration
+        while(observed.rows.size() >= _max_observed_rows && !observed.order.empty())
+        {
+            const std::uint64_t oldest = observed.order.front();
+            observed.order.pop_front();
+            auto old = observed.rows.find(oldest);
+            if(old == observed.rows.end())
+                continue;
+            const size_t row = old->second.first;
+            observed.rows.erase(old);
+            if(row >= x.size())
+                continue;
+            x.erase(x.begin() + static_cast<std::ptrdiff_t>(row));
+            y.erase(y.begin() + static_cast<std::ptrdiff_t>(row));
+            for(auto& entry : observed.rows)
+                if(entry.second.first > row)
+                    --entry.second.first;
         }
 
-        // 2. use correct decision function
-        if(_learning_method == learning_method::krr_trainer_radial_basis_kernel
-                || _learning_method == learning_method::svr_trainer_radial_basis_kernel
-                || _learning_method == learning_method::rvm_trainer_radial_basis_kernel)
+        x.push_back(sample);
+        y.push_back(value);
+        observed.rows[hash] = std::make_pair(x.size() - 1, size_t(1));
+        observed.order.push_back(hash);
+    }
+
+    void machine_learning_interface::add_observation_evacuations(const timetable::solution& sol, int timeslot, double evacuation_time)
+    {
+        const sample_type sample = evacuation_sample(sol, timeslot);
+        add_observed_row(_observed_evacuations, _training_data_evac_x, _training_data_evac_y, sol.hash_timeslot(timeslot), sample, evacuation_time);
+        ++_nb_observations_added;
+
+        // an online learner absorbs the observation at once; concurrent predictions switch to the updated surrogate atomically
+        // (every replication is fed to it, such that it averages them itself)
+        if(uses_online_learner(_learning_method) && !_online_evacuations.empty())
         {
-            return _decision_functions_evacuations.dec_func_rbk(input_data);
+            _online_evacuations.add_sample(sample, evacuation_time);
+            _predictor_evacuations.publish(_online_evacuations.snapshot());
+            ++_surrogate_version;
+
+            // the predictive variance follows the mean (rebuilt from scratch, so only every few observations)
+            if(_predictive_variance_prepared && _nb_observations_added % _online_variance_update_interval == 0)
+                prepare_predictive_variance();
         }
-        else if(_learning_method == learning_method::krr_trainer_histogram_intersection_kernel
-                || _learning_method == learning_method::svr_trainer_histogram_intersection_kernel
-                || _learning_method == learning_method::rvm_trainer_histogram_intersection_kernel)
+    }
+
+    void machine_learning_interface::add_observation_travels(const timetable::solution& sol, int first_timeslot, double travel_time)
+    {
+        const sample_type sample = _surrogate_paths->transfrom_solution_to_ml_sample(sol, first_timeslot);
+        add_observed_row(_observed_travels, _training_data_travels_x, _training_data_travels_y, sol.hash_timeslot_pair(first_timeslot), sample, travel_time);
+        ++_nb_observations_added;
+
+        if(uses_online_learner(_learning_method) && !_online_travels.empty())
         {
-            return _decision_functions_evacuations.dec_func_hik(input_data);
+            _online_travels.add_sample(sample, travel_time);
+            _predictor_travels.publish(_online_travels.snapshot());
+            ++_surrogate_version;
+
+            if(_predictive_variance_prepared && _nb_observations_added % _online_variance_update_interval == 0)
+                prepare_predictive_variance();
         }
-        else if(_learning_method == learning_method::krr_trainer_polynomial_kernel_quadratic
-                || _learning_method == learning_method::krr_trainer_polynomial_kernel_cubic
-                || _learning_method == learning_method::svr_trainer_polynomial_kernel_quadratic
-                || _learning_method == learning_method::svr_trainer_polynomial_kernel_cubic
-                || _learning_method == learning_method::rvm_trainer_polynomial_kernel_quadratic
-                || _learning_method == learning_method::rvm_trainer_polynomial_kernel_cubic)
+    }
+
+    bool machine_learning_interface::is_online() const
+    {
+        return uses_online_learner(_learning_method);
+    }
+
+    bool machine_learning_interface::can_refine() const
+    {
+        if(uses_online_learner(_learning_method))
+            return false;
+        if(_alpha_objective > 0.01 && (!_trained_surrogate_evacuations || _regularization_evacuations < 0))
+            return false;
+        if(_alpha_objective < 0.99 && (!_trained_surrogate_travels || _regularization_travels < 0))
+            return false;
+        return true;
+    }
+
+    void machine_learning_interface::start_refinement()
+    {
+        if(_refinement_running || !can_refine())
+            return;
+
+        // the refinement works on copies, such that the training data can still be extended during the refinement
+        const learning_method lm = _learning_method;
+        const bool refine_evacuations = (_alpha_objective > 0.01);
+        const bool refine_travels = (_alpha_objective < 0.99);
+        const predictor current_evacuations = _predictor_evacuations.snapshot();
+        const predictor current_travels = _predictor_travels.snapshot();
+        const decision_functions decision_functions_evacuations = _decision_functions_evacuations;
+        const decision_functions decision_functions_travels = _decision_functions_travels;
+        const double regularization_evacuations = _regularization_evacuations;
+        const double regularization_travels = _regularization_travels;
+        const double cv_rmse_evacuations = _cv_rmse_evacuations;
+        const double cv_rmse_travels = _cv_rmse_travels;
+        const std::vector<sample_type> x_evac = _training_data_evac_x;
+        const std::vector<double> y_evac = _training_data_evac_y;
+        const std::vector<sample_type> x_travels = _training_data_travels_x;
+        const std::vector<double> y_travels = _training_data_travels_y;
+
+        _refinement = QtConcurrent::run([=]()
+        {
+            // the error of a refined surrogate is cross-validated again (its error on its own training data is far too optimistic)
+            refined_surrogates refined;
+            refined.evacuations = decision_functions_evacuations;
+            refined.travels = decision_functions_travels;
+            refined.cv_rmse_evacuations = cv_rmse_evacuations;
+            refined.cv_rmse_travels = cv_rmse_travels;
+            if(refine_evacuations)
+            {
+                refined.evacuations = current_evacuations.refit(lm, regularization_evacuations, x_evac, y_evac);
+                refined.cv_rmse_evacuations = refit_cross_validation_rmse(refit_trainer{lm, current_evacuations, regularization_evacuations}, x_evac, y_evac);
+            }
+            if(refine_travels)
+            {
+                refined.travels = current_travels.refit(lm, regularization_travels, x_travels, y_travels);
+                refined.cv_rmse_travels = refit_cross_validation_rmse(refit_trainer{lm, current_travels, regularization_travels}, x_travels, y_travels);
+            }
+            return refined;
+        });
+        _refinement_running = true;
+        _nb_observations_added = 0;
+    }
+
+    void machine_learning_interface::install_refinement()
+    {
+        if(!_refinement_running)
+            return;
+
+        _refinement_running = false;
+        try
         {
-            return _decision_functions_evacuations.dec_func_pk(input_data);
+            const refined_surrogates refined = _refinement.result();
+            _decision_functions_evacuations = refined.evacuations;
+            _decision_functions_travels = refined.travels;
+            _cv_rmse_evacuations = refined.cv_rmse_evacuations;
+            _cv_rmse_travels = refined.cv_rmse_travels;
+            compile_predictors();
         }
-        else if(_learning_method == learning_method::krr_trainer_linear_kernel
-                || _learning_method == learning_method::svr_trainer_linear_kernel
-                || _learning_method == learning_method::rvm_trainer_linear_kernel)
+        catch(std::exception& e)
         {
-            return _decision_functions_evacuations.dec_func_lk(input_data);
+            // keep the current surrogates
+            QString text = "Refinement of the surrogate models failed. Reason: ";
+            text.append(e.what());
+            global::_logger << global::logger::log_type::WARNING << text;
         }
 
-
-        return -1;
+        // the variance is conditioned on the extended training data
+        if(_predictive_variance_prepared)
+            prepare_predictive_variance();
     }
 
 
-    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    double machine_learning_interface::predict_travel_time(const timetable::solution& sol, int first_timeslot) const
-    {
-        // 1. transform data into sample_type
-        sample_type input_data = _surrogate_paths->transfrom_solution_to_ml_sample(sol, first_timeslot);
 
 
-        // 2. use correct decision function
-        if(_learning_method == learning_method::krr_trainer_radial_basis_kernel
-                || _learning_method == learning_method::svr_trainer_radial_basis_kernel
-                || _learning_method == learning_method::rvm_trainer_radial_basis_kernel)
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // PREDICTIVE VARIANCE
+    predictive_variance_model machine_learning_interface::build_predictive_variance_model(const predictor& surrogate, const std::vector<sample_type>& x,
+                                                                                          const std::vector<double>& y) const
+    {
+        predictive_variance_model model;
+        if(x.size() < 2 || x.size() != y.size())
+            return model;
+
+        // condition on an evenly spread subset of the training data
+        size_t nb_inputs = x.size() < _predictive_variance_max_inputs ? x.size() : _predictive_variance_max_inputs;
+        std::vector<size_t> indices(nb_inputs);
+        for(size_t i = 0; i < nb_inputs; ++i)
+            indices[i] = i * x.size() / nb_inputs;
+
+        dlib::matrix<double> gram(nb_inputs, nb_inputs);
+        double mean_diagonal = 0.0;
+        for(size_t i = 0; i < nb_inputs; ++i)
         {
-            return _decision_functions_travels.dec_func_rbk(input_data);
+            for(size_t j = 0; j <= i; ++j)
+            {
+                gram(i, j) = surrogate.kernel_value(x[indices[i]], x[indices[j]]);
+                gram(j, i) = gram(i, j);
+            }
+            mean_diagonal += gram(i, i);
         }
-        else if(_learning_method == learning_method::krr_trainer_histogram_intersection_kernel
-                || _learning_method == learning_method::svr_trainer_histogram_intersection_kernel
-                || _learning_method == learning_method::rvm_trainer_histogram_intersection_kernel)
+        mean_diagonal /= nb_inputs;
+        if(!(mean_diagonal > 0.0))
+            return model;
+
+        double mean_y = 0.0;
+        for(size_t i = 0; i < nb_inputs; ++i)
+            mean_y += y[indices[i]];
+        mean_y /= nb_inputs;
+        double variance_y = 0.0;
+        for(size_t i = 0; i < nb_inputs; ++i)
+            variance_y += (y[indices[i]] - mean_y) * (y[indices[i]] - mean_y);
+        variance_y /= (nb_inputs - 1);
+
+        for(size_t i = 0; i < nb_inputs; ++i)
+            gram(i, i) += _predictive_variance_nugget * mean_diagonal;
+
+        model.inverse_gram = dlib::inv(gram);
+        model.scale = variance_y / mean_diagonal;
+        model.inputs.reserve(nb_inputs);
+        for(size_t i = 0; i < nb_inputs; ++i)
+            model.inputs.push_back(x[indices[i]]);
+        return model;
+    }
+
+    double machine_learning_interface::predictive_variance(const predictive_variance_model& model, const predictor& surrogate, const sample_type& input) const
+    {
+        const size_t nb_inputs = model.inputs.size();
+        if(nb_inputs == 0)
+            return 0.0;
+
+        std::vector<double> k(nb_inputs);
+        for(size_t i = 0; i < nb_inputs; ++i)
+            k[i] = surrogate.kernel_value(model.inputs[i], input);
+
+        // k(x,x) - k_x^T (K + nugget*I)^-1 k_x
+        double explained = 0.0;
+        for(size_t i = 0; i < nb_inputs; ++i)
         {
-            return _decision_functions_travels.dec_func_hik(input_data);
+            double row = 0.0;
+            for(size_t j = 0; j < nb_inputs; ++j)
+                row += model.inverse_gram(i, j) * k[j];
+            explained += k[i] * row;
         }
-        else if(_learning_method == learning_method::krr_trainer_polynomial_kernel_quadratic
-                || _learning_method == learning_method::krr_trainer_polynomial_kernel_cubic
-                || _learning_method == learning_method::svr_trainer_polynomial_kernel_quadratic
-                || _learning_method == learning_method::svr_trainer_polynomial_kernel_cubic
-                || _learning_method == learning_method::rvm_trainer_polynomial_kernel_quadratic
-                || _learning_method == learning_method::rvm_trainer_polynomial_kernel_cubic)
+        double variance = model.scale * (surrogate.kernel_value(input, input) - explained);
+        return (variance > 0.0) ? variance : 0.0;
+    }
+
+    void machine_learning_interface::prepare_predictive_variance()
+    {
+        std::shared_ptr<predictive_variance_model> model_evacuations = std::make_shared<predictive_variance_model>();
+        std::shared_ptr<predictive_variance_model> model_travels = std::make_shared<predictive_variance_model>();
+        if(_alpha_objective > 0.01 && _trained_surrogate_evacuations)
+            *model_evacuations = build_predictive_variance_model(_predictor_evacuations, _training_data_evac_x, _training_data_evac_y);
+        if(_alpha_objective < 0.99 && _trained_surrogate_travels)
+            *model_travels = build_predictive_variance_model(_predictor_travels, _training_data_travels_x, _training_data_travels_y);
+
+        // the version is incremented after the models are replaced, such that a variance cached with the new version
+        // was computed with the new models (see cached_predictive_variance)
+        std::atomic_store(&_variance_model_evacuations, std::shared_ptr<const predictive_variance_model>(model_evacuations));
+        std::atomic_store(&_variance_model_travels, std::shared_ptr<const predictive_variance_model>(model_travels));
+        ++_variance_version;
         {
-            return _decision_functions_travels.dec_func_pk(input_data);
+            QMutexLocker locker(&_variance_cache_mutex);
+            _variance_cache_evacuations.clear();
+            _variance_cache_travels.clear();
         }
-        else if(_learning_method == learning_method::krr_trainer_linear_kernel
-                || _learning_method == learning_method::svr_trainer_linear_kernel
-                || _learning_method == learning_method::rvm_trainer_linear_kernel)
+        _predictive_variance_prepared = true;
+
+        // the acquisition values of the moves change with the variance
+        ++_surrogate_version;
+
+        if(model_evacuations->inputs.empty() && model_travels->inputs.empty())
+            global::_logger << global::logger::log_type::WARNING << "No training data available to estimate the predictive variance of the surrogates.";
+    }
+
+    double machine_learning_interface::cached_predictive_variance(std::unordered_map<std::uint64_t, std::pair<std::uint64_t, double>>& cache,
+                                                                  std::uint64_t hash, std::uint64_t version, const std::function<double()>& compute) const
+    {
         {
-            return _decision_functions_travels.dec_func_lk(input_data);
+            QMutexLocker locker(&_variance_cache_mutex);
+            auto it = cache.find(hash);
+            if(it != cache.end() && it->second.first == version)
+                return it->second.second;
         }
 
+        // computed without the lock, such that concurrent scorings don't wait for each other
+        double variance = compute();
+
+        QMutexLocker locker(&_variance_cache_mutex);
+        if(cache.size() >= _variance_cache_max_size)
+            cache.clear();
+        cache[hash] = std::make_pair(version, variance);
+        return variance;
+    }
+
+    double machine_learning_interface::predictive_variance_evacuation_time(const timetable::solution& sol, int timeslot) const
+    {
+        const std::uint64_t version = _variance_version.load();
+        const std::shared_ptr<const predictive_variance_model> model = std::atomic_load(&_variance_model_evacuations);
+        if(!model || model->inputs.empty())
+            return 0.0;
+        return cached_predictive_variance(_variance_cache_evacuations, sol.hash_timeslot(timeslot), version,
+                                          [&]() { return predictive_variance(*model, _predictor_evacuations, evacuation_sample(sol, timeslot)); });
+    }
 
-        return -1;
+    double machine_learning_interface::predictive_variance_travel_time(const timetable::solution& sol, int first_timeslot) const
+    {
+        const std::uint64_t version = _variance_version.load();
+        const std::shared_ptr<const predictive_variance_model> model = std::atomic_load(&_variance_model_travels);
+        if(!model || model->inputs.empty())
+            return 0.0;
+        return cached_predictive_variance(_variance_cache_travels, sol.hash_timeslot_pair(first_timeslot), version,
+                                          [&]() { return predictive_variance(*model, _predictor_travels,
+                                                                             _surrogate_paths->transfrom_solution_to_ml_sample(sol, first_timeslot)); });
     }
 
 
@@ -570,6 +2290,15 @@ namespace ml
 
         std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
 
+        // the training data are simulated with the replications at the start of the simulation random number stream
+        _menge->reset_replications();
+        _halt_training_data = false;
+        const training_functions trainer = training_functions_of(_learning_method);
+
+        // training reorders the data, so the rows of earlier observations are no longer known
+        _observed_evacuations = observed_rows();
+        _observed_travels = observed_rows();
+
 
         // evacuations
         if(_alpha_objective > 0.01)
@@ -596,54 +2325,7 @@ namespace ml
 
                 try
                 {
-                    switch(_learning_method)
-                    {
-                    case learning_method::krr_trainer_radial_basis_kernel:
-                        train_krr_radial_basis_evacuations();
-                        break;
-                    case learning_method::krr_trainer_histogram_intersection_kernel:
-                        train_krr_histogram_intersection_evacuations();
-                        break;
-                    case learning_method::krr_trainer_linear_kernel:
-                        train_krr_linear_evacuations();
-                        break;
-                    case learning_method::krr_trainer_polynomial_kernel_quadratic:
-                        train_krr_quadratic_evacuations();
-                        break;
-                    case learning_method::krr_trainer_polynomial_kernel_cubic:
-                        train_krr_cubic_evacuations();
-                        break;
-                    case learning_method::svr_trainer_radial_basis_kernel:
-                        train_svr_radial_basis_evacuations();
-                        break;
-                    case learning_method::svr_trainer_histogram_intersection_kernel:
-                        train_svr_histogram_intersection_evacuations();
-                        break;
-                    case learning_method::svr_trainer_linear_kernel:
-                        train_svr_linear_evacuations();
-                        break;
-                    case learning_method::svr_trainer_polynomial_kernel_quadratic:
-                        train_svr_quadratic_evacuations();
-                        break;
-                    case learning_method::svr_trainer_polynomial_kernel_cubic:
-                        train_svr_cubic_evacuations();
-                        break;
-                    case learning_method::rvm_trainer_radial_basis_kernel:
-                        train_rvm_radial_basis_evacuations();
-                        break;
-                    case learning_method::rvm_trainer_histogram_intersection_kernel:
-                        train_rvm_histogram_intersection_evacuations();
-                        break;
-                    case learning_method::rvm_trainer_linear_kernel:
-                        train_rvm_linear_evacuations();
-                        break;
-                    case learning_method::rvm_trainer_polynomial_kernel_quadratic:
-                        train_rvm_quadratic_evacuations();
-                        break;
-                    case learning_method::rvm_trainer_polynomial_kernel_cubic:
-                        train_rvm_cubic_evacuations();
-                        break;
-                    }
+                    (this->*trainer.evacuations)();
 
 
                     // if successful stop loop and continue
@@ -686,54 +2368,7 @@ namespace ml
 
                 try
                 {
-                    switch(_learning_method)
-                    {
-                    case learning_method::krr_trainer_radial_basis_kernel:
-                        train_krr_radial_basis_travels();
-                        break;
-                    case learning_method::krr_trainer_histogram_intersection_kernel:
-                        train_krr_histogram_intersection_travels();
-                        break;
-                    case learning_method::krr_trainer_linear_kernel:
-                        train_krr_linear_travels();
-                        break;
-                    case learning_method::krr_trainer_polynomial_kernel_quadratic:
-                        train_krr_quadratic_travels();
-                        break;
-                    case learning_method::krr_trainer_polynomial_kernel_cubic:
-                        train_krr_cubic_travels();
-                        break;
-                    case learning_method::svr_trainer_radial_basis_kernel:
-                        train_svr_radial_basis_travels();
-                        break;
-                    case learning_method::svr_trainer_histogram_intersection_kernel:
-                        train_svr_histogram_intersection_travels();
-                        break;
-                    case learning_method::svr_trainer_linear_kernel:
-                        train_svr_linear_travels();
-                        break;
-                    case learning_method::svr_trainer_polynomial_kernel_quadratic:
-                        train_svr_quadratic_travels();
-                        break;
-                    case learning_method::svr_trainer_polynomial_kernel_cubic:
-                        train_svr_cubic_travels();
-                        break;
-                    case learning_method::rvm_trainer_radial_basis_kernel:
-                        train_rvm_radial_basis_travels();
-                        break;
-                    case learning_method::rvm_trainer_histogram_intersection_kernel:
-                        train_rvm_histogram_intersection_travels();
-                        break;
-                    case learning_method::rvm_trainer_linear_kernel:
-                        train_rvm_linear_travels();
-                        break;
-                    case learning_method::rvm_trainer_polynomial_kernel_quadratic:
-                        train_rvm_quadratic_travels();
-                        break;
-                    case learning_method::rvm_trainer_polynomial_kernel_cubic:
-                        train_rvm_cubic_travels();
-                        break;
-                    }
+                    (this->*trainer.travels)();
 
 
                     // if successful, stop loop and continue
@@ -750,6 +2385,8 @@ namespace ml
             }
         }
 
+        compile_predictors();
+
 
 
         std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
@@ -773,277 +2410,237 @@ namespace ml
 
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    
-    void machine_learning_interface::compare_learning_methods()
-    {
-        emit(signal_status("\n\nComparing learning methods"));
-        std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
 
-        // evacuations
-        if(_alpha_objective > 0.01)
+    machine_learning_interface::training_functions machine_learning_interface::training_functions_of(learning_method lm)
+    {
+        switch(lm)
         {
-            if(_training_data_evac_y.size() < _nb_training_data)
-                generate_training_data_evacuations();
-
-
-            // KRR Trainers
-            try {
-                train_krr_radial_basis_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training krr_radial_basis_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                train_krr_histogram_intersection_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training krr_histogram_intersection_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                train_krr_linear_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training krr_linear_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                train_krr_quadratic_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training krr_quadratic_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                //train_krr_cubic_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training krr_cubic_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-
-            // SVR Trainers
-            try {
-                train_svr_radial_basis_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training svr_radial_basis_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                //train_svr_histogram_intersection_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training svr_histogram_intersection_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                //train_svr_linear_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training svr_linear_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                //train_svr_quadratic_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training svr_quadratic_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
+        case learning_method::krr_trainer_radial_basis_kernel:
+            return {&machine_learning_interface::train_krr_radial_basis_evacuations, &machine_learning_interface::train_krr_radial_basis_travels};
+        case learning_method::krr_trainer_histogram_intersection_kernel:
+            return {&machine_learning_interface::train_krr_histogram_intersection_evacuations, &machine_learning_interface::train_krr_histogram_intersection_travels};
+        case learning_method::krr_trainer_linear_kernel:
+            return {&machine_learning_interface::train_krr_linear_evacuations, &machine_learning_interface::train_krr_linear_travels};
+        case learning_method::krr_trainer_polynomial_kernel_quadratic:
+            return {&machine_learning_interface::train_krr_quadratic_evacuations, &machine_learning_interface::train_krr_quadratic_travels};
+        case learning_method::krr_trainer_polynomial_kernel_cubic:
+            return {&machine_learning_interface::train_krr_cubic_evacuations, &machine_learning_interface::train_krr_cubic_travels};
+        case learning_method::svr_trainer_radial_basis_kernel:
+            return {&machine_learning_interface::train_svr_radial_basis_evacuations, &machine_learning_interface::train_svr_radial_basis_travels};
+        case learning_method::svr_trainer_histogram_intersection_kernel:
+            return {&machine_learning_interface::train_svr_histogram_intersection_evacuations, &machine_learning_interface::train_svr_histogram_intersection_travels};
+        case learning_method::svr_trainer_linear_kernel:
+            return {&machine_learning_interface::train_svr_linear_evacuations, &machine_learning_interface::train_svr_linear_travels};
+        case learning_method::svr_trainer_polynomial_kernel_quadratic:
+            return {&machine_learning_interface::train_svr_quadratic_evacuations, &machine_learning_interface::train_svr_quadratic_travels};
+        case learning_method::svr_trainer_polynomial_kernel_cubic:
+            return {&machine_learning_interface::train_svr_cubic_evacuations, &machine_learning_interface::train_svr_cubic_travels};
+        case learning_method::rvm_trainer_radial_basis_kernel:
+            return {&machine_learning_interface::train_rvm_radial_basis_evacuations, &machine_learning_interface::train_rvm_radial_basis_travels};
+        case learning_method::rvm_trainer_histogram_intersection_kernel:
+            return {&machine_learning_interface::train_rvm_histogram_intersection_evacuations, &machine_learning_interface::train_rvm_histogram_intersection_travels};
+        case learning_method::rvm_trainer_linear_kernel:
+            return {&machine_learning_interface::train_rvm_linear_evacuations, &machine_learning_interface::train_rvm_linear_travels};
+        case learning_method::rvm_trainer_polynomial_kernel_quadratic:
+            return {&machine_learning_interface::train_rvm_quadratic_evacuations, &machine_learning_interface::train_rvm_quadratic_travels};
+        case learning_method::rvm_trainer_polynomial_kernel_cubic:
+            return {&machine_learning_interface::train_rvm_cubic_evacuations, &machine_learning_interface::train_rvm_cubic_travels};
+        case learning_method::nystroem_trainer_radial_basis_kernel:
+            return {&machine_learning_interface::train_nystroem_radial_basis_evacuations, &machine_learning_interface::train_nystroem_radial_basis_travels};
+        case learning_method::gbt_trainer_regression_trees:
+            return {&machine_learning_interface::train_gbt_evacuations, &machine_learning_interface::train_gbt_travels};
+        case learning_method::krls_trainer_radial_basis_kernel:
+            return {&machine_learning_interface::train_krls_radial_basis_evacuations, &machine_learning_interface::train_krls_radial_basis_travels};
+        }
 
-            try {
-                //train_svr_cubic_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training svr_cubic_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
+        throw std::runtime_error("Error in function ml::machine_learning_interface::training_functions_of. \nUnknown learning method.");
+    }
 
 
-            // RVM Trainers
-            try {
-                train_rvm_radial_basis_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training rvm_radial_basis_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
 
-            try {
-                train_rvm_histogram_intersection_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training rvm_histogram_intersection_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
 
-            try {
-                train_rvm_linear_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training rvm_linear_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
 
-            try {
-                train_rvm_quadratic_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training rvm_quadratic_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    
+    void machine_learning_interface::compare_learning_methods()
+    {
+        emit(signal_status("\n\nComparing learning methods"));
+        std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
+        _menge->reset_replications();
+        _halt_training_data = false;
+
+        // 1. training data (shuffled once, such that all learning methods are cross-validated on the same folds)
+        const std::vector<learning_method> methods = {
+            learning_method::krr_trainer_radial_basis_kernel, learning_method::krr_trainer_histogram_intersection_kernel,
+            learning_method::krr_trainer_polynomial_kernel_quadratic, learning_method::krr_trainer_polynomial_kernel_cubic,
+            learning_method::krr_trainer_linear_kernel,
+            learning_method::svr_trainer_radial_basis_kernel, learning_method::svr_trainer_histogram_intersection_kernel,
+            learning_method::svr_trainer_polynomial_kernel_quadratic, learning_method::svr_trainer_polynomial_kernel_cubic,
+            learning_method::svr_trainer_linear_kernel,
+            learning_method::rvm_trainer_radial_basis_kernel, learning_method::rvm_trainer_histogram_intersection_kernel,
+            learning_method::rvm_trainer_polynomial_kernel_quadratic, learning_method::rvm_trainer_polynomial_kernel_cubic,
+            learning_method::rvm_trainer_linear_kernel,
+            learning_method::nystroem_trainer_radial_basis_kernel,
+            learning_method::gbt_trainer_regression_trees,
+            learning_method::krls_trainer_radial_basis_kernel };
+
+        std::vector<learning_method_result> results;
+        auto add_results = [&](bool travels)
+        {
+            for(learning_method lm : methods)
+            {
+                learning_method_result result;
+                result.lm = lm;
+                result.travels = travels;
+                results.push_back(result);
             }
+        };
 
-            try {
-                //train_rvm_cubic_evacuations();
-            } catch(std::exception& e) {
-                QString text = "Training rvm_cubic_evacuations failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
+        if(_alpha_objective > 0.01)
+        {
+            if(_training_data_evac_y.size() < _nb_training_data)
+                generate_training_data_evacuations();
+            dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
+            add_results(false);
         }
-
-        // travels
-        else if(_alpha_objective < 0.99)
+        if(_alpha_objective < 0.99)
         {
             if(_training_data_travels_y.size() < _nb_training_data)
                 generate_training_data_travels();
+            dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
+            add_results(true);
+        }
 
+        // 2. train and cross-validate all learning methods concurrently
+        //    (the training data are only read, the surrogates of this object are not changed)
+        const std::chrono::nanoseconds time_budget = std::chrono::seconds(_hyperparameter_search_time_budget);
+        std::atomic<int> nb_finished{0};
+        parallel_for(static_cast<int>(results.size()), [&](int i)
+        {
+            learning_method_result& result = results[i];
+            const learning_method lm = result.lm;
+            const std::vector<sample_type>& x = result.travels ? _training_data_travels_x : _training_data_evac_x;
+            const std::vector<double>& y = result.travels ? _training_data_travels_y : _training_data_evac_y;
 
-            // KRR Trainers
-            try {
-                train_krr_radial_basis_travels();
-            } catch(std::exception& e) {
-                QString text = "Training krr_radial_basis_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                train_krr_histogram_intersection_travels();
-            } catch(std::exception& e) {
-                QString text = "Training krr_histogram_intersection_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                train_krr_linear_travels();
-            } catch(std::exception& e) {
-                QString text = "Training krr_linear_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                train_krr_quadratic_travels();
-            } catch(std::exception& e) {
-                QString text = "Training krr_quadratic_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                //train_krr_cubic_travels();
-            } catch(std::exception& e) {
-                QString text = "Training krr_cubic_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-
-            // SVR Trainers
-            try {
-                train_svr_radial_basis_travels();
-            } catch(std::exception& e) {
-                QString text = "Training svr_radial_basis_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                train_svr_histogram_intersection_travels();
-            } catch(std::exception& e) {
-                QString text = "Training svr_histogram_intersection_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                train_svr_linear_travels();
-            } catch(std::exception& e) {
-                QString text = "Training svr_linear_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                train_svr_quadratic_travels();
-            } catch(std::exception& e) {
-                QString text = "Training svr_quadratic_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
-            try {
-                //train_svr_cubic_travels();
-            } catch(std::exception& e) {
-                QString text = "Training svr_cubic_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
-
+            try
+            {
+                // bounds of the kernel parameters followed by the regularization parameter (or of the hyperparameters of the trees)
+                std::vector<double> lower_bounds, upper_bounds;
+                if(uses_radial_basis_kernel(lm))
+                {
+                    lower_bounds = {_rbk_gamma_min};
+                    upper_bounds = {_rbk_gamma_max};
+                }
+                else if(uses_polynomial_kernel(lm))
+                {
+                    lower_bounds = {_pk_gamma_min, _pk_coef_min};
+                    upper_bounds = {_pk_gamma_max, _pk_coef_max};
+                }
+                else if(uses_boosted_trees(lm))
+                {
+                    lower_bounds = {_gbt_depth_min, _gbt_nb_trees_min, _gbt_learning_rate_min, _gbt_lambda_min};
+                    upper_bounds = {_gbt_depth_max, _gbt_nb_trees_max, _gbt_learning_rate_max, _gbt_lambda_max};
+                }
+                const bool regularized = uses_krr_trainer(lm) || uses_svr_trainer(lm) || uses_nystroem_trainer(lm);
+                if(uses_krr_trainer(lm) || uses_nystroem_trainer(lm))
+                {
+                    lower_bounds.insert(lower_bounds.end(), {_krr_lambda_min});
+                    upper_bounds.insert(upper_bounds.end(), {_krr_lambda_max});
+                }
+                else if(uses_svr_trainer(lm))
+                {
+                    lower_bounds.insert(lower_bounds.end(), {_svr_c_min});
+                    upper_bounds.insert(upper_bounds.end(), {_svr_c_max});
+                }
+                else if(uses_online_learner(lm))
+                {
+                    lower_bounds.insert(lower_bounds.end(), {_krls_tolerance_min});
+                    upper_bounds.insert(upper_bounds.end(), {_krls_tolerance_max});
+                }
+                const dlib::matrix<double,0,1> lower = dlib::mat(lower_bounds);
+                const dlib::matrix<double,0,1> upper = dlib::mat(upper_bounds);
 
-            // RVM Trainers
-            try {
-                train_rvm_radial_basis_travels();
-            } catch(std::exception& e) {
-                QString text = "Training rvm_radial_basis_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
+                if(uses_boosted_trees(lm))
+                {
+                    fit_trainer(result, [](const dlib::matrix<double,0,1>& p) { return boosted_trees_trainer(make_boosted_trees_parameters(p(0), p(1), p(2), p(3))); },
+                                lower, upper, x, y, time_budget);
+                }
+                else if(uses_online_learner(lm))
+                {
+                    fit_trainer(result, [](const dlib::matrix<double,0,1>& p) { return krls_trainer<radial_basis_kernel>{radial_basis_kernel(p(0)), p(1)}; },
+                                lower, upper, x, y, time_budget);
+                }
+                else if(uses_radial_basis_kernel(lm))
+                {
+                    fit_learning_method<radial_basis_kernel>(result, [](const dlib::matrix<double,0,1>& p) { return radial_basis_kernel(p(0)); },
+                                                             lower, upper, regularized, x, y, time_budget);
+                }
+                else if(uses_polynomial_kernel(lm))
+                {
+                    const int degree = (lm == learning_method::krr_trainer_polynomial_kernel_cubic
+                                        || lm == learning_method::svr_trainer_polynomial_kernel_cubic
+                                        || lm == learning_method::rvm_trainer_polynomial_kernel_cubic) ? 3 : 2;
+                    fit_learning_method<polynomial_kernel>(result, [degree](const dlib::matrix<double,0,1>& p) { return polynomial_kernel(p(0), p(1), degree); },
+                                                           lower, upper, regularized, x, y, time_budget);
+                }
+                else if(uses_histogram_intersection_kernel(lm))
+                {
+                    fit_learning_method<histogram_intersection_kernel>(result, [](const dlib::matrix<double,0,1>&) { return histogram_intersection_kernel(); },
+                                                                       lower, upper, regularized, x, y, time_budget);
+                }
+                else
+                {
+                    fit_learning_method<linear_kernel>(result, [](const dlib::matrix<double,0,1>&) { return linear_kernel(); },
+                                                       lower, upper, regularized, x, y, time_budget);
+                }
             }
-
-            try {
-                train_rvm_histogram_intersection_travels();
-            } catch(std::exception& e) {
-                QString text = "Training rvm_histogram_intersection_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
+            catch(std::exception& e)
+            {
+                result.error = e.what();
             }
 
-            try {
-                train_rvm_linear_travels();
-            } catch(std::exception& e) {
-                QString text = "Training rvm_linear_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
+            QString info = "Finished " + learning_method_name(lm) + (result.travels ? " for travels" : " for evacuations");
+            info += " (" + QString::number(++nb_finished) + "/" + QString::number(static_cast<int>(results.size())) + ")";
+            emit(signal_status(info));
+        });
 
-            try {
-                train_rvm_quadratic_travels();
-            } catch(std::exception& e) {
-                QString text = "Training rvm_quadratic_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
-            }
+        // 3. latency of a single prediction of the compiled predictor, which the search evaluates
+        //    (measured sequentially, such that the learning methods don't disturb each other)
+        for(learning_method_result& result : results)
+        {
+            if(!result.error.isEmpty())
+                continue;
+
+            const std::vector<sample_type>& x = result.travels ? _training_data_travels_x : _training_data_evac_x;
+            const std::size_t nb_predictions = std::max<std::size_t>(1000, x.size());
+            volatile double sink = 0.0;
+            std::chrono::steady_clock::time_point start_prediction = std::chrono::steady_clock::now();
+            for(std::size_t k = 0; k < nb_predictions; ++k)
+                sink = result.surrogate(x[k % x.size()]);
+            std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start_prediction;
+            result.latency = duration.count() / nb_predictions;
+        }
 
-            try {
-                //train_rvm_cubic_travels();
-            } catch(std::exception& e) {
-                QString text = "Training rvm_cubic_travels failed. Reason: ";
-                text.append(e.what());
-                emit(signal_status(text));
+        // 4. report
+        QString report = "\nComparison of the learning methods (10-fold cross-validation)\n";
+        report += QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                .arg("Learning method", -36).arg("Surrogate", -12).arg("MSE", 12).arg("MAE", 12).arg("PCC", 8)
+                .arg("Time (s)", 10).arg("#BV/T", 6).arg("Latency (us)", 14);
+        for(const learning_method_result& result : results)
+        {
+            report += QString("%1 %2 ").arg(learning_method_name(result.lm), -36).arg(result.travels ? "travels" : "evacuations", -12);
+            if(!result.error.isEmpty())
+            {
+                report += "failed: " + result.error + "\n";
+                continue;
             }
+            report += QString("%1 %2 %3 %4 %5 %6\n")
+                    .arg(result.cv(0), 12, 'g', 5).arg(result.cv(2), 12, 'g', 5).arg(result.cv(1), 8, 'f', 4)
+                    .arg(result.training_time, 10, 'f', 1).arg(static_cast<qulonglong>(result.model_size), 6)
+                    .arg(result.latency, 14, 'f', 2);
         }
+        emit(signal_status(report));
+        global::_logger << global::logger::log_type::INFORMATION << report;
 
         std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
         QString info = "\nFinished comparing learning methods.\nElapsed time: ";
@@ -1072,6 +2669,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
 
+        // The pairwise squared distances of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = squared_distance_cache(_training_data_evac_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -1079,14 +2679,14 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double lambda) -> double
         {
             // define krls object with corresponding parameters
-            dlib::krr_trainer<radial_basis_kernel> krr_trainer;
+            dlib::krr_trainer<cached_radial_basis_kernel> krr_trainer;
 
             // set the kernel and its parameter gamma
-            krr_trainer.set_kernel(radial_basis_kernel(gamma));
+            krr_trainer.set_kernel(cached_radial_basis_kernel(cache, gamma));
             krr_trainer.set_lambda(lambda);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, cache.samples, _training_data_evac_y, 10);
 
             // We return a number indicating how good the parameters are.  Bigger is
             // better in this example.  We're returning the harmonic mean between the
@@ -1102,11 +2702,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                                      {_rbk_gamma_min, _krr_lambda_min},    // lower bound constraint on gamma and lambda
                                                      {_rbk_gamma_max, _krr_lambda_max},    // upper bound constraint on gamma and lambda
                                                      dlib::max_function_calls(50),
-                                                     max_runtime_findminglobal);
+                                                     std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double rbk_gamma = best_parameters.x(0);
@@ -1117,9 +2717,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_rbk = krr_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -1175,7 +2777,7 @@ namespace ml
             krr_trainer.set_lambda(lambda);  // regularization parameter
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -1186,11 +2788,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_krr_lambda_min},       // lower bound constraint on lambda
                                             {_krr_lambda_max},       // upper bound constraint on lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define svr object with best found parameters
         double krr_lambda = best_parameters.x(0);
@@ -1200,9 +2802,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_hik = krr_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -1244,6 +2848,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
 
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_evac_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -1251,14 +2858,14 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double coef, const double lambda) -> double
         {
             // define krls object with corresponding parameters
-            dlib::krr_trainer<polynomial_kernel> krr_trainer;
+            dlib::krr_trainer<cached_polynomial_kernel> krr_trainer;
 
             // set the kernel and its parameters gamma and coef and the regularization parameter lambda
-            krr_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 2
+            krr_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 2
             krr_trainer.set_lambda(lambda);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, cache.samples, _training_data_evac_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -1269,11 +2876,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_pk_gamma_min, _pk_coef_min, _krr_lambda_min},        // lower bound constraint on gamma, coef, and lambda
                                             {_pk_gamma_max, _pk_coef_max, _krr_lambda_max},        // upper bound constraint on gamma, coef, and lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double pk_gamma = best_parameters.x(0);
@@ -1285,9 +2892,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_pk = krr_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -1333,6 +2942,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
 
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_evac_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -1340,14 +2952,14 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double coef, const double lambda) -> double
         {
             // define krls object with corresponding parameters
-            dlib::krr_trainer<polynomial_kernel> krr_trainer;
+            dlib::krr_trainer<cached_polynomial_kernel> krr_trainer;
 
             // set the kernel and its parameters gamma and coef and the regularization parameter lambda
-            krr_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 3
+            krr_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 3
             krr_trainer.set_lambda(lambda);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, cache.samples, _training_data_evac_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -1358,11 +2970,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_pk_gamma_min, _pk_coef_min, _krr_lambda_min},        // lower bound constraint on gamma, coef, and lambda
                                             {_pk_gamma_max, _pk_coef_max, _krr_lambda_max},        // upper bound constraint on gamma, coef, and lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double pk_gamma = best_parameters.x(0);
@@ -1374,9 +2986,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_pk = krr_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -1433,7 +3047,7 @@ namespace ml
             krr_trainer.set_lambda(lambda);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -1444,11 +3058,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_krr_lambda_min},    // lower bound constraint on lambda
                                             {_krr_lambda_max},    // upper bound constraint on lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double krr_lambda = best_parameters.x(0);
@@ -1458,9 +3072,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_lk = krr_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -1501,6 +3117,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
 
+        // The pairwise squared distances of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = squared_distance_cache(_training_data_evac_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -1508,15 +3127,15 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double c) -> double
         {
             // define krls object with corresponding parameters
-            dlib::svr_trainer<radial_basis_kernel> svr_trainer;
+            dlib::svr_trainer<cached_radial_basis_kernel> svr_trainer;
 
             // set the kernel and its parameter c
-            svr_trainer.set_kernel(radial_basis_kernel(gamma));
+            svr_trainer.set_kernel(cached_radial_basis_kernel(cache, gamma));
             svr_trainer.set_c(c);  // regularization parameter: higher values = exact fitting; smaller values = higher generalization
             svr_trainer.set_epsilon_insensitivity(0.1);    // stop fitting data point once it is "close enough"
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, cache.samples, _training_data_evac_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -1527,11 +3146,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_rbk_gamma_min, _svr_c_min},      // lower bound constraint on gamma and c
                                             {_rbk_gamma_max, _svr_c_max},      // upper bound constraint on gamma and c
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define svr object with best found parameters
         double rbk_gamma = best_parameters.x(0);
@@ -1542,9 +3161,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_rbk = svr_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = svr_c;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -1600,7 +3221,7 @@ namespace ml
             svr_trainer.set_epsilon_insensitivity(0.1);    // stop fitting data point once it is "close enough"
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -1611,11 +3232,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_svr_c_min},      // lower bound constraint on c
                                             {_svr_c_max},      // upper bound constraint on c
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define svr object with best found parameters
         double svr_c = best_parameters.x(0);
@@ -1625,9 +3246,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_hik = svr_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = svr_c;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -1669,6 +3292,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
 
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_evac_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -1676,14 +3302,14 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double coef, const double c) -> double
         {
             // define krls object with corresponding parameters
-            dlib::svr_trainer<polynomial_kernel> svr_trainer;
+            dlib::svr_trainer<cached_polynomial_kernel> svr_trainer;
 
             // set the kernel and its parameters gamma and coef and the regularization parameter lambda
-            svr_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 2
+            svr_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 2
             svr_trainer.set_c(c);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, cache.samples, _training_data_evac_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -1694,11 +3320,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_pk_gamma_min, _pk_coef_min, _svr_c_min},        // lower bound constraint on gamma, coef, and lambda
                                             {_pk_gamma_max, _pk_coef_max, _svr_c_max},        // upper bound constraint on gamma, coef, and lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double pk_gamma = best_parameters.x(0);
@@ -1710,9 +3336,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_pk = svr_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = svr_c;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -1758,6 +3386,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
 
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_evac_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -1765,14 +3396,14 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double coef, const double c) -> double
         {
             // define krls object with corresponding parameters
-            dlib::svr_trainer<polynomial_kernel> svr_trainer;
+            dlib::svr_trainer<cached_polynomial_kernel> svr_trainer;
 
             // set the kernel and its parameters gamma and coef and the regularization parameter lambda
-            svr_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 2
+            svr_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 2
             svr_trainer.set_c(c);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, cache.samples, _training_data_evac_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -1783,11 +3414,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_pk_gamma_min, _pk_coef_min, _svr_c_min},        // lower bound constraint on gamma, coef, and lambda
                                             {_pk_gamma_max, _pk_coef_max, _svr_c_max},        // upper bound constraint on gamma, coef, and lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double pk_gamma = best_parameters.x(0);
@@ -1799,9 +3430,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_pk = svr_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = svr_c;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -1859,7 +3492,7 @@ namespace ml
             svr_linear_trainer.set_epsilon_insensitivity(0.1);    // stop fitting data point once it is "close enough"
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_linear_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_linear_trainer, _training_data_evac_x, _training_data_evac_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -1870,11 +3503,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_svr_c_min},      // lower bound constraint on c
                                             {_svr_c_max},      // upper bound constraint on c
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define svr object with best found parameters
         double svr_c = best_parameters.x(0);
@@ -1884,9 +3517,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_lk = svr_linear_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = svr_c;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_linear_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_linear_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -1928,6 +3563,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
 
+        // The pairwise squared distances of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = squared_distance_cache(_training_data_evac_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -1935,13 +3573,13 @@ namespace ml
         auto cross_validation_score = [&](const double gamma) -> double
         {
             // define krls object with corresponding parameters
-            dlib::rvm_trainer<radial_basis_kernel> rvm_trainer;
+            dlib::rvm_trainer<cached_radial_basis_kernel> rvm_trainer;
 
             // set the kernel and its parameter gamma
-            rvm_trainer.set_kernel(radial_basis_kernel(gamma));
+            rvm_trainer.set_kernel(cached_radial_basis_kernel(cache, gamma));
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, cache.samples, _training_data_evac_y, 10);
 
             // We return a number indicating how good the parameters are.  Bigger is
             // better in this example.  We're returning the harmonic mean between the
@@ -1957,11 +3595,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                                      {_rbk_gamma_min},    // lower bound constraint on gamma
                                                      {_rbk_gamma_max},    // upper bound constraint on gamma
                                                      dlib::max_function_calls(50),
-                                                     max_runtime_findminglobal);
+                                                     std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double rbk_gamma = best_parameters.x(0);
@@ -1970,9 +3608,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_rbk = rvm_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = 0.0;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -2018,9 +3658,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_evacuations.dec_func_hik = rvm_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = 0.0;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
@@ -2054,24 +3696,292 @@ namespace ml
         emit(signal_status(info));
 
 
-        // Randomize the samples
-        dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
+        // Randomize the samples
+        dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
+
+        // Define rvm object (no parameters)
+        dlib::rvm_trainer<linear_kernel> rvm_trainer;
+        rvm_trainer.set_kernel(linear_kernel());
+
+        // Now we train on the full set of data and get the resulting decision function
+        _decision_functions_evacuations.dec_func_lk = rvm_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = 0.0;
+
+        // do 10-fold cross-validation
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
+
+
+        // signal output
+        std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
+
+        info = "Finished training RVM Trainer with Linear Kernel for evacuations.";
+        info += "\n    Mean squared error = ";
+        info += QString::number(result(0));
+        info += "\n    Pearson correlation = ";
+        info += QString::number(result(1));
+        info += "\n    Mean absolute error = ";
+        info += QString::number(result(2));
+        info += "\n    Standard deviation absolute error = ";
+        info += QString::number(result(3));
+        info += "\nElapsed time: ";
+        info += QString::number(comptime.count() / NANO);
+        info += " seconds";
+
+        global::_logger << global::logger::log_type::INFORMATION << info;
+        emit(signal_status(info));
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void machine_learning_interface::train_rvm_quadratic_evacuations()
+    {
+        // parameters kernel
+        constexpr int degree = 2;
+
+        // computation time and status information
+        std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
+        QString info = "\nStart training RVM Trainer with Polynomial Kernel (Quadratic) for evacuations ...";
+        emit(signal_status(info));
+
+        // Randomize the samples
+        dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
+
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_evac_x);
+
+        // Here we define a function, cross_validation_score(),
+        // that will do the cross-validation we mentioned and
+        // return a number indicating how good a particular setting
+        // of gamma (kernel) and coef (kernel) is.
+        auto cross_validation_score = [&](const double gamma, const double coef) -> double
+        {
+            // define krls object with corresponding parameters
+            dlib::rvm_trainer<cached_polynomial_kernel> rvm_trainer;
+
+            // set the kernel and its parameters gamma and coef
+            rvm_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 2
+
+            // perform 10-fold cross validation and return the results.
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, cache.samples, _training_data_evac_y, 10);
+
+            return result(0);   // result(0) = MSE (mean squared error)
+                                // result(1) = correlation between y' and y
+                                // result(2) = MAE (mean absolute error)
+                                // result(3) = the standard deviation of the absolute error
+        };
+
+        // We call this global optimizer that will search for the best parameters.
+        // It will call cross_validation_score() 50 times with different settings and return
+        // the best parameter setting it finds.
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
+                                            {_pk_gamma_min, _pk_coef_min},        // lower bound constraint on gamma and coef
+                                            {_pk_gamma_max, _pk_coef_max},        // upper bound constraint on gamma and coef
+                                            dlib::max_function_calls(50),
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
+
+        // Define krr object with best found parameters
+        double pk_gamma = best_parameters.x(0);
+        double pk_coef = best_parameters.x(1);
+        dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
+        rvm_trainer.set_kernel(polynomial_kernel(pk_gamma, pk_coef, degree));
+
+        // Now we train on the full set of data and get the resulting decision function
+        _decision_functions_evacuations.dec_func_pk = rvm_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = 0.0;
+
+        // do 10-fold cross-validation
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
+
+
+
+        // signal output
+        std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
+
+        info = "Finished training RVM Trainer with Polynomial Kernel (Quadratic) for evacuations.";
+        info += "\n    Best value for gamma (kernel) = ";
+        info += QString::number(pk_gamma);
+        info += "\n    Best value for coef (kernel) = ";
+        info += QString::number(pk_coef);
+        info += "\n    Mean squared error = ";
+        info += QString::number(result(0));
+        info += "\n    Pearson correlation = ";
+        info += QString::number(result(1));
+        info += "\n    Mean absolute error = ";
+        info += QString::number(result(2));
+        info += "\n    Standard deviation absolute error = ";
+        info += QString::number(result(3));
+        info += "\nElapsed time: ";
+        info += QString::number(comptime.count() / NANO);
+        info += " seconds";
+
+        global::_logger << global::logger::log_type::INFORMATION << info;
+        emit(signal_status(info));
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void machine_learning_interface::train_rvm_cubic_evacuations()
+    {
+        // parameters kernel
+        constexpr int degree = 3;
+
+        // computation time and status information
+        std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
+        QString info = "\nStart training RVM Trainer with Polynomial Kernel (Cubic) for evacuations ...";
+        emit(signal_status(info));
+
+        // Randomize the samples
+        dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
+
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_evac_x);
+
+        // Here we define a function, cross_validation_score(),
+        // that will do the cross-validation we mentioned and
+        // return a number indicating how good a particular setting
+        // of gamma (kernel) and coef (kernel), is.
+        auto cross_validation_score = [&](const double gamma, const double coef) -> double
+        {
+            // define krls object with corresponding parameters
+            dlib::rvm_trainer<cached_polynomial_kernel> rvm_trainer;
+
+            // set the kernel and its parameters gamma and coef
+            rvm_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 3
+
+            // perform 10-fold cross validation and return the results.
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, cache.samples, _training_data_evac_y, 10);
+
+            return result(0);   // result(0) = MSE (mean squared error)
+                                // result(1) = correlation between y' and y
+                                // result(2) = MAE (mean absolute error)
+                                // result(3) = the standard deviation of the absolute error
+        };
+
+        // We call this global optimizer that will search for the best parameters.
+        // It will call cross_validation_score() 50 times with different settings and return
+        // the best parameter setting it finds.
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
+                                            {_pk_gamma_min, _pk_coef_min},        // lower bound constraint on gamma and coef
+                                            {_pk_gamma_max, _pk_coef_max},        // upper bound constraint on gamma and coef
+                                            dlib::max_function_calls(50),
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
+
+        // Define krr object with best found parameters
+        double pk_gamma = best_parameters.x(0);
+        double pk_coef = best_parameters.x(1);
+        dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
+        rvm_trainer.set_kernel(polynomial_kernel(pk_gamma, pk_coef, degree));
+
+        // Now we train on the full set of data and get the resulting decision function
+        _decision_functions_evacuations.dec_func_pk = rvm_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = 0.0;
+
+        // do 10-fold cross-validation
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
+
+
+
+        // signal output
+        std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
+
+        info = "Finished training RVM Trainer with Polynomial Kernel (Cubic) for evacuations.";
+        info += "\n    Best value for gamma (kernel) = ";
+        info += QString::number(pk_gamma);
+        info += "\n    Best value for coef (kernel) = ";
+        info += QString::number(pk_coef);
+        info += "\n    Mean squared error = ";
+        info += QString::number(result(0));
+        info += "\n    Pearson correlation = ";
+        info += QString::number(result(1));
+        info += "\n    Mean absolute error = ";
+        info += QString::number(result(2));
+        info += "\n    Standard deviation absolute error = ";
+        info += QString::number(result(3));
+        info += "\nElapsed time: ";
+        info += QString::number(comptime.count() / NANO);
+        info += " seconds";
+
+        global::_logger << global::logger::log_type::INFORMATION << info;
+        emit(signal_status(info));
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void machine_learning_interface::train_nystroem_radial_basis_evacuations()
+    {
+        // computation time and status information
+        std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
+        QString info = "\nStart training Nystroem KRR Trainer with Radial Basis Kernel for evacuations ...";
+        emit(signal_status(info));
+
+
+        // Randomize the samples
+        dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
+
+        // Here we define a function, cross_validation_score(),
+        // that will do the cross-validation we mentioned and
+        // return a number indicating how good a particular setting
+        // of gamma (kernel) and lambda (regularization) is.
+        auto cross_validation_score = [&](const double gamma, const double lambda) -> double
+        {
+            // define nystroem object with corresponding parameters
+            nystroem_trainer<radial_basis_kernel> trainer;
+
+            // set the kernel and its parameter gamma and the regularization parameter lambda
+            trainer.set_kernel(radial_basis_kernel(gamma));
+            trainer.set_lambda(lambda);
+
+            // perform 10-fold cross validation and return the results.
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_evac_x, _training_data_evac_y, 10);
+
+            return result(0);   // result(0) = MSE (mean squared error)
+                                // result(1) = correlation between y' and y
+                                // result(2) = MAE (mean absolute error)
+                                // result(3) = the standard deviation of the absolute error
+        };
+
+        // We call this global optimizer that will search for the best parameters.
+        // It will call cross_validation_score() 50 times with different settings and return
+        // the best parameter setting it finds.
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
+                                                     {_rbk_gamma_min, _krr_lambda_min},    // lower bound constraint on gamma and lambda
+                                                     {_rbk_gamma_max, _krr_lambda_max},    // upper bound constraint on gamma and lambda
+                                                     dlib::max_function_calls(50),
+                                                     std::chrono::seconds(_hyperparameter_search_time_budget));
 
-        // Define rvm object (no parameters)
-        dlib::rvm_trainer<linear_kernel> rvm_trainer;
-        rvm_trainer.set_kernel(linear_kernel());
+        // Define nystroem object with best found parameters
+        double rbk_gamma = best_parameters.x(0);
+        double krr_lambda = best_parameters.x(1);
+        nystroem_trainer<radial_basis_kernel> trainer;
+        trainer.set_kernel(radial_basis_kernel(rbk_gamma));
+        trainer.set_lambda(krr_lambda);
 
         // Now we train on the full set of data and get the resulting decision function
-        _decision_functions_evacuations.dec_func_lk = rvm_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _decision_functions_evacuations.dec_func_rbk = trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
+
 
 
         // signal output
         std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
 
-        info = "Finished training RVM Trainer with Linear Kernel for evacuations.";
+        info = "Finished training Nystroem KRR Trainer with Radial Basis Kernel for evacuations.";
+        info += "\n    Best value for gamma (kernel) = ";
+        info += QString::number(rbk_gamma);
+        info += "\n    Best value for lambda (regularization) = ";
+        info += QString::number(krr_lambda);
+        info += "\n    Number of basis vectors = ";
+        info += QString::number(_decision_functions_evacuations.dec_func_rbk.basis_vectors.size());
         info += "\n    Mean squared error = ";
         info += QString::number(result(0));
         info += "\n    Pearson correlation = ";
@@ -2091,33 +4001,28 @@ namespace ml
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    void machine_learning_interface::train_rvm_quadratic_evacuations()
+    void machine_learning_interface::train_gbt_evacuations()
     {
-        // parameters kernel
-        constexpr int degree = 2;
-
         // computation time and status information
         std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
-        QString info = "\nStart training RVM Trainer with Polynomial Kernel (Quadratic) for evacuations ...";
+        QString info = "\nStart training Gradient-Boosted Regression Trees for evacuations ...";
         emit(signal_status(info));
 
+
         // Randomize the samples
         dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
 
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
-        // of gamma (kernel) and coef (kernel) is.
-        auto cross_validation_score = [&](const double gamma, const double coef) -> double
+        // of the depth and number of trees, the learning rate and lambda (regularization) is.
+        auto cross_validation_score = [&](const double depth, const double nb_trees, const double learning_rate, const double lambda) -> double
         {
-            // define krls object with corresponding parameters
-            dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
-
-            // set the kernel and its parameters gamma and coef
-            rvm_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 2
+            // define boosted_trees_trainer object with corresponding parameters
+            boosted_trees_trainer trainer(make_boosted_trees_parameters(depth, nb_trees, learning_rate, lambda));
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_evac_x, _training_data_evac_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -2128,34 +4033,39 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
-                                            {_pk_gamma_min, _pk_coef_min},        // lower bound constraint on gamma and coef
-                                            {_pk_gamma_max, _pk_coef_max},        // upper bound constraint on gamma and coef
-                                            dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
+                                                     {_gbt_depth_min, _gbt_nb_trees_min, _gbt_learning_rate_min, _gbt_lambda_min},   // lower bound constraints
+                                                     {_gbt_depth_max, _gbt_nb_trees_max, _gbt_learning_rate_max, _gbt_lambda_max},   // upper bound constraints
+                                                     dlib::max_function_calls(50),
+                                                     std::chrono::seconds(_hyperparameter_search_time_budget));
 
-        // Define krr object with best found parameters
-        double pk_gamma = best_parameters.x(0);
-        double pk_coef = best_parameters.x(1);
-        dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
-        rvm_trainer.set_kernel(polynomial_kernel(pk_gamma, pk_coef, degree));
+        // Define boosted_trees_trainer object with best found parameters
+        const boosted_trees_parameters parameters = make_boosted_trees_parameters(best_parameters.x(0), best_parameters.x(1),
+                                                                                  best_parameters.x(2), best_parameters.x(3));
+        boosted_trees_trainer trainer(parameters);
 
-        // Now we train on the full set of data and get the resulting decision function
-        _decision_functions_evacuations.dec_func_pk = rvm_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        // Now we train on the full set of data and get the resulting trees
+        _decision_functions_evacuations.dec_func_gbt = trainer.train(_training_data_evac_x, _training_data_evac_y);
+        _regularization_evacuations = parameters.lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
         // signal output
         std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
 
-        info = "Finished training RVM Trainer with Polynomial Kernel (Quadratic) for evacuations.";
-        info += "\n    Best value for gamma (kernel) = ";
-        info += QString::number(pk_gamma);
-        info += "\n    Best value for coef (kernel) = ";
-        info += QString::number(pk_coef);
+        info = "Finished training Gradient-Boosted Regression Trees for evacuations.";
+        info += "\n    Best depth of the trees = ";
+        info += QString::number(parameters.depth);
+        info += "\n    Best number of trees = ";
+        info += QString::number(parameters.nb_trees);
+        info += "\n    Best learning rate = ";
+        info += QString::number(parameters.learning_rate);
+        info += "\n    Best value for lambda (regularization) = ";
+        info += QString::number(parameters.lambda);
         info += "\n    Mean squared error = ";
         info += QString::number(result(0));
         info += "\n    Pearson correlation = ";
@@ -2175,33 +4085,28 @@ namespace ml
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    void machine_learning_interface::train_rvm_cubic_evacuations()
+    void machine_learning_interface::train_krls_radial_basis_evacuations()
     {
-        // parameters kernel
-        constexpr int degree = 3;
-
         // computation time and status information
         std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
-        QString info = "\nStart training RVM Trainer with Polynomial Kernel (Cubic) for evacuations ...";
+        QString info = "\nStart training KRLS (online) with Radial Basis Kernel for evacuations ...";
         emit(signal_status(info));
 
+
         // Randomize the samples
         dlib::randomize_samples(_training_data_evac_x, _training_data_evac_y);
 
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
-        // of gamma (kernel) and coef (kernel), is.
-        auto cross_validation_score = [&](const double gamma, const double coef) -> double
+        // of gamma (kernel) and the tolerance (sparsification) is.
+        auto cross_validation_score = [&](const double gamma, const double tolerance) -> double
         {
-            // define krls object with corresponding parameters
-            dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
-
-            // set the kernel and its parameters gamma and coef
-            rvm_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 3
+            // define krls_trainer object with corresponding parameters
+            krls_trainer<radial_basis_kernel> trainer{radial_basis_kernel(gamma), tolerance};
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_evac_x, _training_data_evac_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -2212,34 +4117,39 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
-                                            {_pk_gamma_min, _pk_coef_min},        // lower bound constraint on gamma and coef
-                                            {_pk_gamma_max, _pk_coef_max},        // upper bound constraint on gamma and coef
-                                            dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
+                                                     {_rbk_gamma_min, _krls_tolerance_min},    // lower bound constraint on gamma and the tolerance
+                                                     {_rbk_gamma_max, _krls_tolerance_max},    // upper bound constraint on gamma and the tolerance
+                                                     dlib::max_function_calls(50),
+                                                     std::chrono::seconds(_hyperparameter_search_time_budget));
 
-        // Define krr object with best found parameters
-        double pk_gamma = best_parameters.x(0);
-        double pk_coef = best_parameters.x(1);
-        dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
-        rvm_trainer.set_kernel(polynomial_kernel(pk_gamma, pk_coef, degree));
+        // Start the online learner with the best found parameters
+        double rbk_gamma = best_parameters.x(0);
+        double krls_tolerance = best_parameters.x(1);
+        _online_evacuations.reset(radial_basis_kernel(rbk_gamma), krls_tolerance, krls_max_dictionary_size);
 
-        // Now we train on the full set of data and get the resulting decision function
-        _decision_functions_evacuations.dec_func_pk = rvm_trainer.train(_training_data_evac_x, _training_data_evac_y);
+        // Now we add the full set of data; every later observation is added by add_observation_evacuations
+        _online_evacuations.add_samples(_training_data_evac_x, _training_data_evac_y);
+        _decision_functions_evacuations.dec_func_rbk = _online_evacuations.decision_function();
+        _regularization_evacuations = krls_tolerance;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        krls_trainer<radial_basis_kernel> trainer{radial_basis_kernel(rbk_gamma), krls_tolerance};
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_evac_x, _training_data_evac_y, 10);
+        _cv_rmse_evacuations = std::sqrt(result(0));
 
 
 
         // signal output
         std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
 
-        info = "Finished training RVM Trainer with Polynomial Kernel (Cubic) for evacuations.";
+        info = "Finished training KRLS (online) with Radial Basis Kernel for evacuations.";
         info += "\n    Best value for gamma (kernel) = ";
-        info += QString::number(pk_gamma);
-        info += "\n    Best value for coef (kernel) = ";
-        info += QString::number(pk_coef);
+        info += QString::number(rbk_gamma);
+        info += "\n    Best value for the tolerance (sparsification) = ";
+        info += QString::number(krls_tolerance);
+        info += "\n    Number of basis vectors = ";
+        info += QString::number(_decision_functions_evacuations.dec_func_rbk.basis_vectors.size());
         info += "\n    Mean squared error = ";
         info += QString::number(result(0));
         info += "\n    Pearson correlation = ";
@@ -2259,6 +4169,7 @@ namespace ml
 
 
 
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     void machine_learning_interface::train_krr_radial_basis_travels()
@@ -2272,6 +4183,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
 
+        // The pairwise squared distances of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = squared_distance_cache(_training_data_travels_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -2279,14 +4193,14 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double lambda) -> double
         {
             // define krls object with corresponding parameters
-            dlib::krr_trainer<radial_basis_kernel> krr_trainer;
+            dlib::krr_trainer<cached_radial_basis_kernel> krr_trainer;
 
             // set the kernel and its parameter gamma
-            krr_trainer.set_kernel(radial_basis_kernel(gamma));
+            krr_trainer.set_kernel(cached_radial_basis_kernel(cache, gamma));
             krr_trainer.set_lambda(lambda);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, cache.samples, _training_data_travels_y, 10);
 
             // We return a number indicating how good the parameters are.  Bigger is
             // better in this example.  We're returning the harmonic mean between the
@@ -2302,11 +4216,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                                      {_rbk_gamma_min, _krr_lambda_min},    // lower bound constraint on gamma and lambda
                                                      {_rbk_gamma_max, _krr_lambda_max},    // upper bound constraint on gamma and lambda
                                                      dlib::max_function_calls(50),
-                                                     max_runtime_findminglobal);
+                                                     std::chrono::seconds(_hyperparameter_search_time_budget));
 
         //qDebug() << "best param found";
 
@@ -2320,9 +4234,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_travels.dec_func_rbk = krr_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
@@ -2378,7 +4294,7 @@ namespace ml
             krr_trainer.set_lambda(lambda);  // regularization parameter
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -2389,11 +4305,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_krr_lambda_min},       // lower bound constraint on lambda
                                             {_krr_lambda_max},       // upper bound constraint on lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define svr object with best found parameters
         double krr_lambda = best_parameters.x(0);
@@ -2403,9 +4319,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_travels.dec_func_hik = krr_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
@@ -2447,6 +4365,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
 
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_travels_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -2454,14 +4375,14 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double coef, const double lambda) -> double
         {
             // define krls object with corresponding parameters
-            dlib::krr_trainer<polynomial_kernel> krr_trainer;
+            dlib::krr_trainer<cached_polynomial_kernel> krr_trainer;
 
             // set the kernel and its parameters gamma and coef and the regularization parameter lambda
-            krr_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 2
+            krr_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 2
             krr_trainer.set_lambda(lambda);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, cache.samples, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -2472,11 +4393,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_pk_gamma_min, _pk_coef_min, _krr_lambda_min},        // lower bound constraint on gamma, coef, and lambda
                                             {_pk_gamma_max, _pk_coef_max, _krr_lambda_max},        // upper bound constraint on gamma, coef, and lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double pk_gamma = best_parameters.x(0);
@@ -2488,9 +4409,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_travels.dec_func_pk = krr_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
@@ -2536,6 +4459,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
 
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_travels_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -2543,14 +4469,14 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double coef, const double lambda) -> double
         {
             // define krls object with corresponding parameters
-            dlib::krr_trainer<polynomial_kernel> krr_trainer;
+            dlib::krr_trainer<cached_polynomial_kernel> krr_trainer;
 
             // set the kernel and its parameters gamma and coef and the regularization parameter lambda
-            krr_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 3
+            krr_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 3
             krr_trainer.set_lambda(lambda);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, cache.samples, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -2561,11 +4487,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_pk_gamma_min, _pk_coef_min, _krr_lambda_min},        // lower bound constraint on gamma, coef, and lambda
                                             {_pk_gamma_max, _pk_coef_max, _krr_lambda_max},        // upper bound constraint on gamma, coef, and lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double pk_gamma = best_parameters.x(0);
@@ -2577,9 +4503,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_travels.dec_func_pk = krr_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
@@ -2636,7 +4564,7 @@ namespace ml
             krr_trainer.set_lambda(lambda);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -2647,11 +4575,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_krr_lambda_min},    // lower bound constraint on lambda
                                             {_krr_lambda_max},    // upper bound constraint on lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double krr_lambda = best_parameters.x(0);
@@ -2661,9 +4589,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_travels.dec_func_lk = krr_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(krr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
@@ -2704,6 +4634,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
 
+        // The pairwise squared distances of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = squared_distance_cache(_training_data_travels_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -2711,15 +4644,15 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double c) -> double
         {
             // define krls object with corresponding parameters
-            dlib::svr_trainer<radial_basis_kernel> svr_trainer;
+            dlib::svr_trainer<cached_radial_basis_kernel> svr_trainer;
 
             // set the kernel and its parameter c
-            svr_trainer.set_kernel(radial_basis_kernel(gamma));
+            svr_trainer.set_kernel(cached_radial_basis_kernel(cache, gamma));
             svr_trainer.set_c(c);  // regularization parameter: higher values = exact fitting; smaller values = higher generalization
             svr_trainer.set_epsilon_insensitivity(0.1);    // stop fitting data point once it is "close enough"
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, cache.samples, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -2730,11 +4663,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_rbk_gamma_min, _svr_c_min},      // lower bound constraint on gamma and c
                                             {_rbk_gamma_max, _svr_c_max},      // upper bound constraint on gamma and c
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define svr object with best found parameters
         double rbk_gamma = best_parameters.x(0);
@@ -2745,9 +4678,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_travels.dec_func_rbk = svr_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = svr_c;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
@@ -2803,7 +4738,7 @@ namespace ml
             svr_trainer.set_epsilon_insensitivity(0.1);    // stop fitting data point once it is "close enough"
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -2814,11 +4749,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_svr_c_min},      // lower bound constraint on c
                                             {_svr_c_max},      // upper bound constraint on c
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define svr object with best found parameters
         double svr_c = best_parameters.x(0);
@@ -2828,9 +4763,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_travels.dec_func_hik = svr_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = svr_c;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
@@ -2872,6 +4809,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
 
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_travels_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -2879,14 +4819,14 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double coef, const double c) -> double
         {
             // define krls object with corresponding parameters
-            dlib::svr_trainer<polynomial_kernel> svr_trainer;
+            dlib::svr_trainer<cached_polynomial_kernel> svr_trainer;
 
             // set the kernel and its parameters gamma and coef and the regularization parameter lambda
-            svr_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 2
+            svr_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 2
             svr_trainer.set_c(c);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, cache.samples, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -2897,11 +4837,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_pk_gamma_min, _pk_coef_min, _svr_c_min},        // lower bound constraint on gamma, coef, and lambda
                                             {_pk_gamma_max, _pk_coef_max, _svr_c_max},        // upper bound constraint on gamma, coef, and lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double pk_gamma = best_parameters.x(0);
@@ -2913,9 +4853,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_travels.dec_func_pk = svr_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = svr_c;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
@@ -2961,6 +4903,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
 
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_travels_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -2968,14 +4913,14 @@ namespace ml
         auto cross_validation_score = [&](const double gamma, const double coef, const double c) -> double
         {
             // define krls object with corresponding parameters
-            dlib::svr_trainer<polynomial_kernel> svr_trainer;
+            dlib::svr_trainer<cached_polynomial_kernel> svr_trainer;
 
             // set the kernel and its parameters gamma and coef and the regularization parameter lambda
-            svr_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 2
+            svr_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 2
             svr_trainer.set_c(c);
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, cache.samples, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -2986,11 +4931,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_pk_gamma_min, _pk_coef_min, _svr_c_min},        // lower bound constraint on gamma, coef, and lambda
                                             {_pk_gamma_max, _pk_coef_max, _svr_c_max},        // upper bound constraint on gamma, coef, and lambda
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
         double pk_gamma = best_parameters.x(0);
@@ -3002,9 +4947,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_travels.dec_func_pk = svr_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = svr_c;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
@@ -3062,7 +5009,7 @@ namespace ml
             svr_linear_trainer.set_epsilon_insensitivity(0.1);    // stop fitting data point once it is "close enough"
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_linear_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_linear_trainer, _training_data_travels_x, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -3073,11 +5020,11 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
                                             {_svr_c_min},      // lower bound constraint on c
                                             {_svr_c_max},      // upper bound constraint on c
                                             dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define svr object with best found parameters
         double svr_c = best_parameters.x(0);
@@ -3087,9 +5034,11 @@ namespace ml
 
         // Now we train on the full set of data and get the resulting decision function
         _decision_functions_travels.dec_func_lk = svr_linear_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = svr_c;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(svr_linear_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(svr_linear_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
@@ -3131,6 +5080,9 @@ namespace ml
         // Randomize the samples
         dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
 
+        // The pairwise squared distances of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = squared_distance_cache(_training_data_travels_x);
+
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
@@ -3138,18 +5090,198 @@ namespace ml
         auto cross_validation_score = [&](const double gamma) -> double
         {
             // define krls object with corresponding parameters
-            dlib::rvm_trainer<radial_basis_kernel> rvm_trainer;
+            dlib::rvm_trainer<cached_radial_basis_kernel> rvm_trainer;
+
+            // set the kernel and its parameter gamma
+            rvm_trainer.set_kernel(cached_radial_basis_kernel(cache, gamma));
+
+            // perform 10-fold cross validation and return the results.
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, cache.samples, _training_data_travels_y, 10);
+
+            // We return a number indicating how good the parameters are.  Bigger is
+            // better in this example.  We're returning the harmonic mean between the
+            // accuracies of each class.
+            //return 2*dlib::prod(result)/dlib::sum(result);
+
+            return result(0);   // result(0) = MSE (mean squared error)
+                                // result(1) = correlation between y' and y
+                                // result(2) = MAE (mean absolute error)
+                                // result(3) = the standard deviation of the absolute error
+        };
+
+        // We call this global optimizer that will search for the best parameters.
+        // It will call cross_validation_score() 50 times with different settings and return
+        // the best parameter setting it finds.
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
+                                                     {_rbk_gamma_min},    // lower bound constraint on gamma
+                                                     {_rbk_gamma_max},    // upper bound constraint on gamma
+                                                     dlib::max_function_calls(50),
+                                                     std::chrono::seconds(_hyperparameter_search_time_budget));
+
+        // Define krr object with best found parameters
+        double rbk_gamma = best_parameters.x(0);
+        dlib::rvm_trainer<radial_basis_kernel> rvm_trainer;
+        rvm_trainer.set_kernel(radial_basis_kernel(rbk_gamma));
+
+        // Now we train on the full set of data and get the resulting decision function
+        _decision_functions_travels.dec_func_rbk = rvm_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = 0.0;
+
+        // do 10-fold cross-validation
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
+
+
+
+        // signal output
+        std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
+
+        info = "Finished training RVM Trainer with Radial Basis Kernel for travels.";
+        info += "\n    Best value for gamma (kernel) = ";
+        info += QString::number(rbk_gamma);
+        info += "\n    Mean squared error = ";
+        info += QString::number(result(0));
+        info += "\n    Pearson correlation = ";
+        info += QString::number(result(1));
+        info += "\n    Mean absolute error = ";
+        info += QString::number(result(2));
+        info += "\n    Standard deviation absolute error = ";
+        info += QString::number(result(3));
+        info += "\nElapsed time: ";
+        info += QString::number(comptime.count() / NANO);
+        info += " seconds";
+
+        global::_logger << global::logger::log_type::INFORMATION << info;
+        emit(signal_status(info));
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void machine_learning_interface::train_rvm_histogram_intersection_travels()
+    {
+        // computation time and status information
+        std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
+        QString info = "\nStart training RVM Trainer with Histogram Intersection Kernel for travels ...";
+        emit(signal_status(info));
+
+
+        // Randomize the samples
+        dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
+
+        // Define svr object (no parameters)
+        dlib::rvm_trainer<histogram_intersection_kernel> rvm_trainer;
+        rvm_trainer.set_kernel(histogram_intersection_kernel());
+
+        // Now we train on the full set of data and get the resulting decision function
+        _decision_functions_travels.dec_func_hik = rvm_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = 0.0;
+
+        // do 10-fold cross-validation
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
+
+
+
+        // signal output
+        std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
+
+        info = "Finished training RVM Trainer with Histogram Intersection Kernel for travels.";
+        info += "\n    Mean squared error = ";
+        info += QString::number(result(0));
+        info += "\n    Pearson correlation = ";
+        info += QString::number(result(1));
+        info += "\n    Mean absolute error = ";
+        info += QString::number(result(2));
+        info += "\n    Standard deviation absolute error = ";
+        info += QString::number(result(3));
+        info += "\nElapsed time: ";
+        info += QString::number(comptime.count() / NANO);
+        info += " seconds";
+
+        global::_logger << global::logger::log_type::INFORMATION << info;
+        emit(signal_status(info));
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void machine_learning_interface::train_rvm_linear_travels()
+    {
+        std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
+        QString info = "\nStart training RVM Trainer with Linear Kernel for travels ...";
+        emit(signal_status(info));
+
+
+        // Randomize the samples
+        dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
+
+        // Define rvm object (no parameters)
+        dlib::rvm_trainer<linear_kernel> rvm_trainer;
+        rvm_trainer.set_kernel(linear_kernel());
+
+        // Now we train on the full set of data and get the resulting decision function
+        _decision_functions_travels.dec_func_lk = rvm_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = 0.0;
+
+        // do 10-fold cross-validation
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
+
+
+        // signal output
+        std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
+
+        info = "Finished training RVM Trainer with Linear Kernel for travels.";
+        info += "\n    Mean squared error = ";
+        info += QString::number(result(0));
+        info += "\n    Pearson correlation = ";
+        info += QString::number(result(1));
+        info += "\n    Mean absolute error = ";
+        info += QString::number(result(2));
+        info += "\n    Standard deviation absolute error = ";
+        info += QString::number(result(3));
+        info += "\nElapsed time: ";
+        info += QString::number(comptime.count() / NANO);
+        info += " seconds";
+
+        global::_logger << global::logger::log_type::INFORMATION << info;
+        emit(signal_status(info));
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void machine_learning_interface::train_rvm_quadratic_travels()
+    {
+        // parameters kernel
+        constexpr int degree = 2;
+
+        // computation time and status information
+        std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
+        QString info = "\nStart training RVM Trainer with Polynomial Kernel (Quadratic) for travels ...";
+        emit(signal_status(info));
+
+        // Randomize the samples
+        dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
+
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_travels_x);
+
+        // Here we define a function, cross_validation_score(),
+        // that will do the cross-validation we mentioned and
+        // return a number indicating how good a particular setting
+        // of gamma (kernel) and coef (kernel) is.
+        auto cross_validation_score = [&](const double gamma, const double coef) -> double
+        {
+            // define krls object with corresponding parameters
+            dlib::rvm_trainer<cached_polynomial_kernel> rvm_trainer;
 
-            // set the kernel and its parameter gamma
-            rvm_trainer.set_kernel(radial_basis_kernel(gamma));
+            // set the kernel and its parameters gamma and coef
+            rvm_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 2
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
-
-            // We return a number indicating how good the parameters are.  Bigger is
-            // better in this example.  We're returning the harmonic mean between the
-            // accuracies of each class.
-            //return 2*dlib::prod(result)/dlib::sum(result);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, cache.samples, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -3160,31 +5292,36 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
-                                                     {_rbk_gamma_min},    // lower bound constraint on gamma
-                                                     {_rbk_gamma_max},    // upper bound constraint on gamma
-                                                     dlib::max_function_calls(50),
-                                                     max_runtime_findminglobal);
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
+                                            {_pk_gamma_min, _pk_coef_min},        // lower bound constraint on gamma and coef
+                                            {_pk_gamma_max, _pk_coef_max},        // upper bound constraint on gamma and coef
+                                            dlib::max_function_calls(50),
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
 
         // Define krr object with best found parameters
-        double rbk_gamma = best_parameters.x(0);
-        dlib::rvm_trainer<radial_basis_kernel> rvm_trainer;
-        rvm_trainer.set_kernel(radial_basis_kernel(rbk_gamma));
+        double pk_gamma = best_parameters.x(0);
+        double pk_coef = best_parameters.x(1);
+        dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
+        rvm_trainer.set_kernel(polynomial_kernel(pk_gamma, pk_coef, degree));
 
         // Now we train on the full set of data and get the resulting decision function
-        _decision_functions_travels.dec_func_rbk = rvm_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _decision_functions_travels.dec_func_pk = rvm_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = 0.0;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
         // signal output
         std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
 
-        info = "Finished training RVM Trainer with Radial Basis Kernel for travels.";
+        info = "Finished training RVM Trainer with Polynomial Kernel (Quadratic) for travels.";
         info += "\n    Best value for gamma (kernel) = ";
-        info += QString::number(rbk_gamma);
+        info += QString::number(pk_gamma);
+        info += "\n    Best value for coef (kernel) = ";
+        info += QString::number(pk_coef);
         info += "\n    Mean squared error = ";
         info += QString::number(result(0));
         info += "\n    Pearson correlation = ";
@@ -3204,33 +5341,76 @@ namespace ml
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    void machine_learning_interface::train_rvm_histogram_intersection_travels()
+    void machine_learning_interface::train_rvm_cubic_travels()
     {
+        // parameters kernel
+        constexpr int degree = 3;
+
         // computation time and status information
         std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
-        QString info = "\nStart training RVM Trainer with Histogram Intersection Kernel for travels ...";
+        QString info = "\nStart training RVM Trainer with Polynomial Kernel (Cubic) for travels ...";
         emit(signal_status(info));
 
-
         // Randomize the samples
         dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
 
-        // Define svr object (no parameters)
-        dlib::rvm_trainer<histogram_intersection_kernel> rvm_trainer;
-        rvm_trainer.set_kernel(histogram_intersection_kernel());
+        // The pairwise dot products of the samples are computed once and shared by all trials and folds
+        const kernel_cache cache = dot_product_cache(_training_data_travels_x);
+
+        // Here we define a function, cross_validation_score(),
+        // that will do the cross-validation we mentioned and
+        // return a number indicating how good a particular setting
+        // of gamma (kernel) and coef (kernel), is.
+        auto cross_validation_score = [&](const double gamma, const double coef) -> double
+        {
+            // define krls object with corresponding parameters
+            dlib::rvm_trainer<cached_polynomial_kernel> rvm_trainer;
+
+            // set the kernel and its parameters gamma and coef
+            rvm_trainer.set_kernel(cached_polynomial_kernel(cache, gamma, coef, degree));      // degree == 3
+
+            // perform 10-fold cross validation and return the results.
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, cache.samples, _training_data_travels_y, 10);
+
+            return result(0);   // result(0) = MSE (mean squared error)
+                                // result(1) = correlation between y' and y
+                                // result(2) = MAE (mean absolute error)
+                                // result(3) = the standard deviation of the absolute error
+        };
+
+        // We call this global optimizer that will search for the best parameters.
+        // It will call cross_validation_score() 50 times with different settings and return
+        // the best parameter setting it finds.
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
+                                            {_pk_gamma_min, _pk_coef_min},        // lower bound constraint on gamma and coef
+                                            {_pk_gamma_max, _pk_coef_max},        // upper bound constraint on gamma and coef
+                                            dlib::max_function_calls(50),
+                                            std::chrono::seconds(_hyperparameter_search_time_budget));
+
+        // Define krr object with best found parameters
+        double pk_gamma = best_parameters.x(0);
+        double pk_coef = best_parameters.x(1);
+        dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
+        rvm_trainer.set_kernel(polynomial_kernel(pk_gamma, pk_coef, degree));
 
         // Now we train on the full set of data and get the resulting decision function
-        _decision_functions_travels.dec_func_hik = rvm_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _decision_functions_travels.dec_func_pk = rvm_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = 0.0;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
         // signal output
         std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
 
-        info = "Finished training RVM Trainer with Histogram Intersection Kernel for travels.";
+        info = "Finished training RVM Trainer with Polynomial Kernel (Cubic) for travels.";
+        info += "\n    Best value for gamma (kernel) = ";
+        info += QString::number(pk_gamma);
+        info += "\n    Best value for coef (kernel) = ";
+        info += QString::number(pk_coef);
         info += "\n    Mean squared error = ";
         info += QString::number(result(0));
         info += "\n    Pearson correlation = ";
@@ -3250,31 +5430,75 @@ namespace ml
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    void machine_learning_interface::train_rvm_linear_travels()
+    void machine_learning_interface::train_nystroem_radial_basis_travels()
     {
+        // computation time and status information
         std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
-        QString info = "\nStart training RVM Trainer with Linear Kernel for travels ...";
+        QString info = "\nStart training Nystroem KRR Trainer with Radial Basis Kernel for travels ...";
         emit(signal_status(info));
 
 
         // Randomize the samples
         dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
 
-        // Define rvm object (no parameters)
-        dlib::rvm_trainer<linear_kernel> rvm_trainer;
-        rvm_trainer.set_kernel(linear_kernel());
+        // Here we define a function, cross_validation_score(),
+        // that will do the cross-validation we mentioned and
+        // return a number indicating how good a particular setting
+        // of gamma (kernel) and lambda (regularization) is.
+        auto cross_validation_score = [&](const double gamma, const double lambda) -> double
+        {
+            // define nystroem object with corresponding parameters
+            nystroem_trainer<radial_basis_kernel> trainer;
+
+            // set the kernel and its parameter gamma and the regularization parameter lambda
+            trainer.set_kernel(radial_basis_kernel(gamma));
+            trainer.set_lambda(lambda);
+
+            // perform 10-fold cross validation and return the results.
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_travels_x, _training_data_travels_y, 10);
+
+            return result(0);   // result(0) = MSE (mean squared error)
+                                // result(1) = correlation between y' and y
+                                // result(2) = MAE (mean absolute error)
+                                // result(3) = the standard deviation of the absolute error
+        };
+
+        // We call this global optimizer that will search for the best parameters.
+        // It will call cross_validation_score() 50 times with different settings and return
+        // the best parameter setting it finds.
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
+                                                     {_rbk_gamma_min, _krr_lambda_min},    // lower bound constraint on gamma and lambda
+                                                     {_rbk_gamma_max, _krr_lambda_max},    // upper bound constraint on gamma and lambda
+                                                     dlib::max_function_calls(50),
+                                                     std::chrono::seconds(_hyperparameter_search_time_budget));
+
+        // Define nystroem object with best found parameters
+        double rbk_gamma = best_parameters.x(0);
+        double krr_lambda = best_parameters.x(1);
+        nystroem_trainer<radial_basis_kernel> trainer;
+        trainer.set_kernel(radial_basis_kernel(rbk_gamma));
+        trainer.set_lambda(krr_lambda);
 
         // Now we train on the full set of data and get the resulting decision function
-        _decision_functions_travels.dec_func_lk = rvm_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _decision_functions_travels.dec_func_rbk = trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = krr_lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
+
 
 
         // signal output
         std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
 
-        info = "Finished training RVM Trainer with Linear Kernel for travels.";
+        info = "Finished training Nystroem KRR Trainer with Radial Basis Kernel for travels.";
+        info += "\n    Best value for gamma (kernel) = ";
+        info += QString::number(rbk_gamma);
+        info += "\n    Best value for lambda (regularization) = ";
+        info += QString::number(krr_lambda);
+        info += "\n    Number of basis vectors = ";
+        info += QString::number(_decision_functions_travels.dec_func_rbk.basis_vectors.size());
         info += "\n    Mean squared error = ";
         info += QString::number(result(0));
         info += "\n    Pearson correlation = ";
@@ -3294,33 +5518,28 @@ namespace ml
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    void machine_learning_interface::train_rvm_quadratic_travels()
+    void machine_learning_interface::train_gbt_travels()
     {
-        // parameters kernel
-        constexpr int degree = 2;
-
         // computation time and status information
         std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
-        QString info = "\nStart training RVM Trainer with Polynomial Kernel (Quadratic) for travels ...";
+        QString info = "\nStart training Gradient-Boosted Regression Trees for travels ...";
         emit(signal_status(info));
 
+
         // Randomize the samples
         dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
 
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
-        // of gamma (kernel) and coef (kernel) is.
-        auto cross_validation_score = [&](const double gamma, const double coef) -> double
+        // of the depth and number of trees, the learning rate and lambda (regularization) is.
+        auto cross_validation_score = [&](const double depth, const double nb_trees, const double learning_rate, const double lambda) -> double
         {
-            // define krls object with corresponding parameters
-            dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
-
-            // set the kernel and its parameters gamma and coef
-            rvm_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 2
+            // define boosted_trees_trainer object with corresponding parameters
+            boosted_trees_trainer trainer(make_boosted_trees_parameters(depth, nb_trees, learning_rate, lambda));
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_travels_x, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -3331,34 +5550,39 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
-                                            {_pk_gamma_min, _pk_coef_min},        // lower bound constraint on gamma and coef
-                                            {_pk_gamma_max, _pk_coef_max},        // upper bound constraint on gamma and coef
-                                            dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
+                                                     {_gbt_depth_min, _gbt_nb_trees_min, _gbt_learning_rate_min, _gbt_lambda_min},   // lower bound constraints
+                                                     {_gbt_depth_max, _gbt_nb_trees_max, _gbt_learning_rate_max, _gbt_lambda_max},   // upper bound constraints
+                                                     dlib::max_function_calls(50),
+                                                     std::chrono::seconds(_hyperparameter_search_time_budget));
 
-        // Define krr object with best found parameters
-        double pk_gamma = best_parameters.x(0);
-        double pk_coef = best_parameters.x(1);
-        dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
-        rvm_trainer.set_kernel(polynomial_kernel(pk_gamma, pk_coef, degree));
+        // Define boosted_trees_trainer object with best found parameters
+        const boosted_trees_parameters parameters = make_boosted_trees_parameters(best_parameters.x(0), best_parameters.x(1),
+                                                                                  best_parameters.x(2), best_parameters.x(3));
+        boosted_trees_trainer trainer(parameters);
 
-        // Now we train on the full set of data and get the resulting decision function
-        _decision_functions_travels.dec_func_pk = rvm_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        // Now we train on the full set of data and get the resulting trees
+        _decision_functions_travels.dec_func_gbt = trainer.train(_training_data_travels_x, _training_data_travels_y);
+        _regularization_travels = parameters.lambda;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
         // signal output
         std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
 
-        info = "Finished training RVM Trainer with Polynomial Kernel (Quadratic) for travels.";
-        info += "\n    Best value for gamma (kernel) = ";
-        info += QString::number(pk_gamma);
-        info += "\n    Best value for coef (kernel) = ";
-        info += QString::number(pk_coef);
+        info = "Finished training Gradient-Boosted Regression Trees for travels.";
+        info += "\n    Best depth of the trees = ";
+        info += QString::number(parameters.depth);
+        info += "\n    Best number of trees = ";
+        info += QString::number(parameters.nb_trees);
+        info += "\n    Best learning rate = ";
+        info += QString::number(parameters.learning_rate);
+        info += "\n    Best value for lambda (regularization) = ";
+        info += QString::number(parameters.lambda);
         info += "\n    Mean squared error = ";
         info += QString::number(result(0));
         info += "\n    Pearson correlation = ";
@@ -3378,33 +5602,28 @@ namespace ml
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    void machine_learning_interface::train_rvm_cubic_travels()
+    void machine_learning_interface::train_krls_radial_basis_travels()
     {
-        // parameters kernel
-        constexpr int degree = 3;
-
         // computation time and status information
         std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
-        QString info = "\nStart training RVM Trainer with Polynomial Kernel (Cubic) for travels ...";
+        QString info = "\nStart training KRLS (online) with Radial Basis Kernel for travels ...";
         emit(signal_status(info));
 
+
         // Randomize the samples
         dlib::randomize_samples(_training_data_travels_x, _training_data_travels_y);
 
         // Here we define a function, cross_validation_score(),
         // that will do the cross-validation we mentioned and
         // return a number indicating how good a particular setting
-        // of gamma (kernel) and coef (kernel), is.
-        auto cross_validation_score = [&](const double gamma, const double coef) -> double
+        // of gamma (kernel) and the tolerance (sparsification) is.
+        auto cross_validation_score = [&](const double gamma, const double tolerance) -> double
         {
-            // define krls object with corresponding parameters
-            dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
-
-            // set the kernel and its parameters gamma and coef
-            rvm_trainer.set_kernel(polynomial_kernel(gamma, coef, degree));      // degree == 3
+            // define krls_trainer object with corresponding parameters
+            krls_trainer<radial_basis_kernel> trainer{radial_basis_kernel(gamma), tolerance};
 
             // perform 10-fold cross validation and return the results.
-            dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+            dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_travels_x, _training_data_travels_y, 10);
 
             return result(0);   // result(0) = MSE (mean squared error)
                                 // result(1) = correlation between y' and y
@@ -3415,34 +5634,39 @@ namespace ml
         // We call this global optimizer that will search for the best parameters.
         // It will call cross_validation_score() 50 times with different settings and return
         // the best parameter setting it finds.
-        auto best_parameters = dlib::find_min_global(cross_validation_score,
-                                            {_pk_gamma_min, _pk_coef_min},        // lower bound constraint on gamma and coef
-                                            {_pk_gamma_max, _pk_coef_max},        // upper bound constraint on gamma and coef
-                                            dlib::max_function_calls(50),
-                                            max_runtime_findminglobal);
+        auto best_parameters = find_min_global_parallel(cross_validation_score,
+                                                     {_rbk_gamma_min, _krls_tolerance_min},    // lower bound constraint on gamma and the tolerance
+                                                     {_rbk_gamma_max, _krls_tolerance_max},    // upper bound constraint on gamma and the tolerance
+                                                     dlib::max_function_calls(50),
+                                                     std::chrono::seconds(_hyperparameter_search_time_budget));
 
-        // Define krr object with best found parameters
-        double pk_gamma = best_parameters.x(0);
-        double pk_coef = best_parameters.x(1);
-        dlib::rvm_trainer<polynomial_kernel> rvm_trainer;
-        rvm_trainer.set_kernel(polynomial_kernel(pk_gamma, pk_coef, degree));
+        // Start the online learner with the best found parameters
+        double rbk_gamma = best_parameters.x(0);
+        double krls_tolerance = best_parameters.x(1);
+        _online_travels.reset(radial_basis_kernel(rbk_gamma), krls_tolerance, krls_max_dictionary_size);
 
-        // Now we train on the full set of data and get the resulting decision function
-        _decision_functions_travels.dec_func_pk = rvm_trainer.train(_training_data_travels_x, _training_data_travels_y);
+        // Now we add the full set of data; every later observation is added by add_observation_travels
+        _online_travels.add_samples(_training_data_travels_x, _training_data_travels_y);
+        _decision_functions_travels.dec_func_rbk = _online_travels.decision_function();
+        _regularization_travels = krls_tolerance;
 
         // do 10-fold cross-validation
-        dlib::matrix<double> result = dlib::cross_validate_regression_trainer(rvm_trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        krls_trainer<radial_basis_kernel> trainer{radial_basis_kernel(rbk_gamma), krls_tolerance};
+        dlib::matrix<double> result = parallel_cross_validate_regression_trainer(trainer, _training_data_travels_x, _training_data_travels_y, 10);
+        _cv_rmse_travels = std::sqrt(result(0));
 
 
 
         // signal output
         std::chrono::nanoseconds comptime = std::chrono::system_clock::now() - start_time;
 
-        info = "Finished training RVM Trainer with Polynomial Kernel (Cubic) for travels.";
+        info = "Finished training KRLS (online) with Radial Basis Kernel for travels.";
         info += "\n    Best value for gamma (kernel) = ";
-        info += QString::number(pk_gamma);
-        info += "\n    Best value for coef (kernel) = ";
-        info += QString::number(pk_coef);
+        info += QString::number(rbk_gamma);
+        info += "\n    Best value for the tolerance (sparsification) = ";
+        info += QString::number(krls_tolerance);
+        info += "\n    Number of basis vectors = ";
+        info += QString::number(_decision_functions_travels.dec_func_rbk.basis_vectors.size());
         info += "\n    Mean squared error = ";
         info += QString::number(result(0));
         info += "\n    Pearson correlation = ";
@@ -3468,6 +5692,7 @@ namespace ml
 
 
 
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     void machine_learning_interface::generate_training_data_evacuations()
@@ -3476,165 +5701,183 @@ namespace ml
         QString output_text;
         std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
 
+        output_text = "\nGenerating training data evacuations ...";
+        emit(signal_status(output_text));
 
+        // 1. initialize vector of training data
+        _training_data_evac_x.clear();
+        _training_data_evac_x.reserve(_nb_training_data);
+        _training_data_evac_y.clear();
+        _training_data_evac_y.reserve(_nb_training_data);
 
 
+        // 2. observations stored by previous runs for the same building and pedestrian model
+        global::data_hash key;
+        key << QString("evacuations") << building::data_hash() << _menge->parameters_hash() << timetable::nb_locations;
+        training_data_store store(training_data_store::file_name("training_data_evac", key.value()), key.value(), timetable::nb_locations);
 
-        /*QString filename = QStringLiteral("training_data_evac.txt");
-        QFile file(filename);
-
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) // read data from file
+        std::vector<sample_type> stored_x;
+        std::vector<double> stored_y;
+        const int nb_stored = store.load(stored_x, stored_y);
+        const int nb_reused = std::min(nb_stored, static_cast<int>(_nb_training_data) - 1);
+        for(int obs = 0; obs < nb_reused; ++obs)
         {
-            output_text = "\nImporting training data evacuations from file";
-            emit(signal_status(output_text));
-
-            QTextStream stream(&file);
-            stream >> _nb_training_data;
-
-            for(size_t i = 0; i < _nb_training_data; ++i)
-            {
-                sample_type sample;
-                sample.set_size(timetable::nb_locations);
-                for(size_t j = 0; j < timetable::nb_locations; ++j)
-                {
-                    int people;
-                    stream >> people;
-                    sample(j) = people;
-                }
-                _training_data_evac_x.push_back(sample);
-
-                double evactime;
-                stream >> evactime;
-                _training_data_evac_y.push_back(evactime);
-            }
+            _training_data_evac_x.push_back(stored_x[obs]);
+            _training_data_evac_y.push_back(stored_y[obs]);
         }
-
-        else*/ // generate data
+        if(nb_stored > 0)
         {
-
-            output_text = "\nGenerating training data evacuations ...";
+            output_text = "    Reusing ";
+            output_text.append(QString::number(nb_reused));
+            output_text.append(" stored observations");
             emit(signal_status(output_text));
-
-            // 1. initialize vector of training data
-            _training_data_evac_x.clear();
-            _training_data_evac_x.reserve(_nb_training_data);
-            _training_data_evac_y.clear();
-            _training_data_evac_y.reserve(_nb_training_data);
+        }
 
 
-            // 2. for every room find maximally allowed number of people
-            std::vector<int> room_max_nb_people;
-            room_max_nb_people.reserve(timetable::nb_locations);
-            for(int r = 0; r < timetable::nb_locations; ++r)
+        // 3. for every room find maximally allowed number of people
+        std::vector<int> room_max_nb_people;
+        room_max_nb_people.reserve(timetable::nb_locations);
+        for(int r = 0; r < timetable::nb_locations; ++r)
+        {
+            room_max_nb_people.push_back(0);
+            for(int e = 0; e < timetable::nb_events; ++e)
             {
-                room_max_nb_people.push_back(0);
-                for(int e = 0; e < timetable::nb_events; ++e)
+                if(timetable::get_event_location_possible(e,r))
                 {
-                    if(timetable::get_event_location_possible(e,r))
-                    {
-                        if(timetable::get_event_nb_people(e) > room_max_nb_people[r])
-                            room_max_nb_people[r] = timetable::get_event_nb_people(e);
-                    }
+                    if(timetable::get_event_nb_people(e) > room_max_nb_people[r])
+                        room_max_nb_people[r] = timetable::get_event_nb_people(e);
                 }
             }
+        }
 
 
 
-            // 3. latin hypercube sampling
-            std::vector<std::vector<int>> rooms_remaining_strata;
-            std::vector<int> vec_;
-            vec_.reserve(_nb_training_data);
-            for(int i = 0; i < _nb_training_data; ++i)
-                vec_.push_back(i);
-
-            for(int r = 0; r < timetable::nb_locations; ++r)   // initialize strata
-                rooms_remaining_strata.push_back(vec_);
+        // 4. latin hypercube sampling of the observations that are not stored yet
+        // (a separate design for every extension, such that the stored design is never resampled)
+        const int nb_new = _nb_training_data - 1 - nb_reused;
+        const int nb_strata = nb_new + 1;
+        generator = global::_random_streams.make_generator(global::random_stream::latin_hypercube, 2*static_cast<std::uint64_t>(nb_stored));
+        std::vector<std::vector<int>> rooms_remaining_strata;
+        std::vector<int> vec_;
+        vec_.reserve(nb_strata);
+        for(int i = 0; i < nb_strata; ++i)
+            vec_.push_back(i);
 
-            // generate N observations and use menge to analyze them
-            for(int obs = 0; obs < _nb_training_data - 1; ++obs)
-            {
-                std::vector<int> room_nb_people;
-                room_nb_people.reserve(timetable::nb_locations);
+        for(int r = 0; r < timetable::nb_locations; ++r)   // initialize strata
+            rooms_remaining_strata.push_back(vec_);
 
-                for(int r = 0; r < timetable::nb_locations; ++r) // generate the number of every people in each room
-                {
-                    std::uniform_int_distribution<int> dist_index(0, rooms_remaining_strata[r].size() - 1);
-                    int index = dist_index(generator);
-                    int stratum = rooms_remaining_strata[r][index];
-                    int nbp = stratum * room_max_nb_people[r] / (_nb_training_data - 1) +0.1;     // borders of the stratum (one group less so that both endpoints are sampled)
-                    //int nbp = (int)((double)(stratum + 0.5) * room_max_nb_people[r] / nb_training_data + 0.5); // middle of the stratum
+        // generate the samples first, such that the design does not depend on the order in which the simulations finish
+        std::vector<std::vector<int>> design;
+        design.reserve(nb_new);
+        for(int obs = 0; obs < nb_new; ++obs)
+        {
+            std::vector<int> room_nb_people;
+            room_nb_people.reserve(timetable::nb_locations);
 
-                    if(obs == 0)
-                        room_nb_people.push_back(room_max_nb_people[r]);
-                    else
-                        room_nb_people.push_back(nbp);
+            for(int r = 0; r < timetable::nb_locations; ++r) // generate the number of every people in each room
+            {
+                std::uniform_int_distribution<int> dist_index(0, rooms_remaining_strata[r].size() - 1);
+                int index = dist_index(generator);
+                int stratum = rooms_remaining_strata[r][index];
+                int nbp = stratum * room_max_nb_people[r] / (nb_strata - 1) +0.1;     // borders of the stratum (one group less so that both endpoints are sampled)
+                //int nbp = (int)((double)(stratum + 0.5) * room_max_nb_people[r] / nb_training_data + 0.5); // middle of the stratum
+
+                const bool maximum_sample = (obs == 0 && nb_stored == 0);  // the first sample of a new design has the maximum number of people
+                if(maximum_sample)
+                    room_nb_people.push_back(room_max_nb_people[r]);
+                else
+                    room_nb_people.push_back(nbp);
+
+                // delete this stratum from the vector
+                if(!maximum_sample)
+                    rooms_remaining_strata[r].erase(rooms_remaining_strata[r].begin() + index);
+            }
 
-                    // delete this stratum from the vector
-                    if(obs > 0)
-                        rooms_remaining_strata[r].erase(rooms_remaining_strata[r].begin() + index);
-                }
+            design.push_back(std::move(room_nb_people));
+        }
 
-                // use menge to estimate evacuation time
-                double evactime = _menge->calculate_custom_evacuation_time(room_nb_people);
-                if(evactime < 0)
-                    evactime = 0;
-
-
-                // put observation in matrix
-                sample_type mat;
-                mat.set_size(timetable::nb_locations);
-                for(int r = 0; r < timetable::nb_locations; ++r)
-                    mat(r) = room_nb_people[r];
-                _training_data_evac_x.push_back(mat);
-                _training_data_evac_y.push_back(evactime);
-
-                output_text = "    Observation ";
-                output_text.append(QString::number(obs+1));
-                output_text.append("; Evacuation time = ");
-                output_text.append(QString::number(evactime));
-                output_text.append(" seconds");
-                emit(signal_status(output_text));
-            }
 
-            // add row with all zeros
-            sample_type mat;
-            mat.set_size(timetable::nb_locations);
+        // 5. use menge to estimate the evacuation times of all new samples in parallel
+        // (every observation is added to the store as soon as it has been simulated)
+        std::vector<sample_type> design_x(design.size());
+        for(size_t obs = 0; obs < design.size(); ++obs)
+        {
+            design_x[obs].set_size(timetable::nb_locations);
             for(int r = 0; r < timetable::nb_locations; ++r)
-                mat(r) = 0;
-            _training_data_evac_x.push_back(mat);
-            _training_data_evac_y.push_back(0.0);
-            output_text = "    Observation ";
-            output_text.append(QString::number(_nb_training_data));
-            output_text.append("; Evacuation time = 0 seconds");
-            emit(signal_status(output_text));
+                design_x[obs](r) = design[obs][r];
+        }
+        std::vector<double> evactimes(design.size(), 0.0);
+        std::vector<bool> simulated(design.size(), false);
+        int nb_simulated = 0;
+        emit(signal_training_data_started(_nb_training_data));
+        emit(signal_training_data_progress(nb_reused, _nb_training_data));
+
+        simulate_design(design.size(), _halt_training_data,
+                        [&](int obs) { return _menge->calculate_custom_evacuation_time(design[obs], nb_stored + obs); },
+                        [&](int obs, double evactime)
+        {
+            evactimes[obs] = std::max(evactime, 0.0);
+            simulated[obs] = true;
+            ++nb_simulated;
 
+            try {
+                store.append(design_x[obs], evactimes[obs]);
+            } catch(std::exception& e) {
+                global::_logger << global::logger::log_type::WARNING << e.what();
+            }
 
+            QString text = "    Observation ";
+            text.append(QString::number(nb_reused + obs + 1));
+            text.append("; Evacuation time = ");
+            text.append(QString::number(evactimes[obs]));
+            text.append(" seconds");
+            emit(signal_status(text));
+            emit(signal_training_data_progress(nb_reused + nb_simulated, _nb_training_data));
+        });
 
-            std::chrono::nanoseconds elapsed_time = std::chrono::system_clock::now() - start_time;
-            _time_generating_data_evac = elapsed_time.count() / NANO;
-            output_text = "Finished generating training data. Elapsed time: ";
-            output_text.append(QString::number(_time_generating_data_evac));
-            output_text.append(" seconds");
+        if(nb_simulated < (int)design.size())
+        {
+            output_text = "Generation of training data evacuations halted after ";
+            output_text.append(QString::number(nb_simulated));
+            output_text.append(" simulations");
             emit(signal_status(output_text));
-            global::_logger << global::logger::log_type::INFORMATION << "Generated " << _nb_training_data << " training data evacuations.\nElapsed time = " << _time_generating_data_evac << " seconds.";
+            global::_logger << global::logger::log_type::WARNING << "Generation of training data evacuations halted after " << nb_simulated << " of " << nb_new << " simulations.";
+            if(nb_reused + nb_simulated == 0)
+                throw std::runtime_error("Error in function ml::machine_learning_interface::generate_training_data_evacuations. \nThe generation of the training data was halted before any sample was simulated.");
+        }
 
+        // 6. put the observations in matrix (in the order of the design)
+        for(size_t obs = 0; obs < design.size(); ++obs)
+        {
+            if(!simulated[obs])
+                continue;
+            _training_data_evac_x.push_back(design_x[obs]);
+            _training_data_evac_y.push_back(evactimes[obs]);
+        }
 
+        // add row with all zeros
+        sample_type mat;
+        mat.set_size(timetable::nb_locations);
+        for(int r = 0; r < timetable::nb_locations; ++r)
+            mat(r) = 0;
+        _training_data_evac_x.push_back(mat);
+        _training_data_evac_y.push_back(0.0);
+        output_text = "    Observation ";
+        output_text.append(QString::number(_nb_training_data));
+        output_text.append("; Evacuation time = 0 seconds");
+        emit(signal_status(output_text));
+        emit(signal_training_data_progress(_nb_training_data, _nb_training_data));
 
-            /*QFile savefile(filename);
-            if(savefile.open(QIODevice::WriteOnly | QIODevice::Text))
-            {
-                QTextStream stream(&savefile);
-                stream << _nb_training_data << "\n";
 
-                for(size_t i = 0; i < _nb_training_data; ++i)
-                {
-                    stream << "\n";
-                    for(size_t j = 0; j < timetable::nb_locations; ++j)
-                        stream << _training_data_evac_x[i](j) << "\t";
-                    stream << _training_data_evac_y[i];
-                }
-            }*/
-        }
+
+        std::chrono::nanoseconds elapsed_time = std::chrono::system_clock::now() - start_time;
+        _time_generating_data_evac = elapsed_time.count() / NANO;
+        output_text = "Finished generating training data. Elapsed time: ";
+        output_text.append(QString::number(_time_generating_data_evac));
+        output_text.append(" seconds");
+        emit(signal_status(output_text));
+        global::_logger << global::logger::log_type::INFORMATION << "Generated " << _training_data_evac_x.size() << " training data evacuations ("
+                        << nb_reused << " stored, " << nb_simulated << " simulated).\nElapsed time = " << _time_generating_data_evac << " seconds.";
     }
 
 
@@ -3643,12 +5886,20 @@ namespace ml
     void machine_learning_interface::generate_training_data_travels()
     {
         if(_surrogate_paths != nullptr)
-            _surrogate_paths->generate_observations(_menge, _training_data_travels_x, _training_data_travels_y, _nb_training_data);
+            _surrogate_paths->generate_observations(_menge, _training_data_travels_x, _training_data_travels_y, _nb_training_data, &_halt_training_data);
         else
             emit(signal_status("Couldn't generate training data travels: no paths for the surrogate specified"));
     }
 
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void machine_learning_interface::halt_training_data_generation()
+    {
+        _halt_training_data = true;
+    }
+
+
 
 
 
@@ -3687,15 +5938,23 @@ namespace ml
                 dlib::deserialize(stdfilename) >> _decision_functions_evacuations.dec_func_lk; // only decision function type matters (RBK, HIK, PK, or LK)
                 _learning_method = learning_method::krr_trainer_linear_kernel;
             }
+            else if(filename.contains("GBT", Qt::CaseInsensitive))
+            {
+                dlib::deserialize(stdfilename) >> _decision_functions_evacuations.dec_func_gbt;
+                _learning_method = learning_method::gbt_trainer_regression_trees;
+            }
             else
             {
-                throw std::exception("File name does not specify kernel type of decision function! Either RBK, HIK, PK, or LK");
+                throw std::exception("File name does not specify kernel type of decision function! Either RBK, HIK, PK, LK, or GBT");
             }
 
 
             output_text = "\nFinished importing decision function.";
             emit(signal_status(output_text));
             _trained_surrogate_evacuations = true;
+            _regularization_evacuations = -1.0;
+            _cv_rmse_evacuations = 0.0;
+            compile_predictors();
 
         } catch(std::exception& ex)
         {
@@ -3740,15 +5999,23 @@ namespace ml
                 dlib::deserialize(stdfilename) >> _decision_functions_travels.dec_func_lk; // only decision function type matters (RBK, HIK, PK, or LK)
                 _learning_method = learning_method::krr_trainer_linear_kernel;
             }
+            else if(filename.contains("GBT", Qt::CaseInsensitive))
+            {
+                dlib::deserialize(stdfilename) >> _decision_functions_travels.dec_func_gbt;
+                _learning_method = learning_method::gbt_trainer_regression_trees;
+            }
             else
             {
-                throw std::exception("File name does not specify kernel type of decision function! Either RBK, HIK, PK, or LK");
+                throw std::exception("File name does not specify kernel type of decision function! Either RBK, HIK, PK, LK, or GBT");
             }
 
 
             output_text = "\nFinished importing decision function.";
             emit(signal_status(output_text));
             _trained_surrogate_travels = true;
+            _regularization_travels = -1.0;
+            _cv_rmse_travels = 0.0;
+            compile_predictors();
 
         } catch(std::exception& ex)
         {
@@ -3793,37 +6060,8 @@ namespace ml
                 file_name += "_";
             }
 
-            if(_learning_method == learning_method::krr_trainer_radial_basis_kernel
-                    || _learning_method == learning_method::svr_trainer_radial_basis_kernel
-                    || _learning_method == learning_method::rvm_trainer_radial_basis_kernel)
-            {
-                file_name += "RBK.dat";
-                dlib::serialize(file_name) << _decision_functions_evacuations.dec_func_rbk;
-            }
-            else if(_learning_method == learning_method::krr_trainer_histogram_intersection_kernel
-                    || _learning_method == learning_method::svr_trainer_histogram_intersection_kernel
-                    || _learning_method == learning_method::rvm_trainer_histogram_intersection_kernel)
-            {
-                file_name += "HIK.dat";
-                dlib::serialize(file_name) << _decision_functions_evacuations.dec_func_hik;
-            }
-            else if(_learning_method == learning_method::krr_trainer_polynomial_kernel_quadratic
-                    || _learning_method == learning_method::krr_trainer_polynomial_kernel_cubic
-                    || _learning_method == learning_method::svr_trainer_polynomial_kernel_quadratic
-                    || _learning_method == learning_method::svr_trainer_polynomial_kernel_cubic
-                    || _learning_method == learning_method::rvm_trainer_polynomial_kernel_quadratic
-                    || _learning_method == learning_method::rvm_trainer_polynomial_kernel_cubic)
-            {
-                file_name += "PK.dat";
-                dlib::serialize(file_name) << _decision_functions_evacuations.dec_func_pk;
-            }
-            else if(_learning_method == learning_method::krr_trainer_linear_kernel
-                    || _learning_method == learning_method::svr_trainer_linear_kernel
-                    || _learning_method == learning_method::rvm_trainer_linear_kernel)
-            {
-                file_name += "LK.dat";
-                dlib::serialize(file_name) << _decision_functions_evacuations.dec_func_lk;
-            }
+            file_name += _predictor_evacuations.kernel_name() + ".dat";
+            _predictor_evacuations.save(file_name);
 
             emit(signal_status("Decision function evacuations saved"));
         }
@@ -3862,37 +6100,8 @@ namespace ml
                 file_name += "_";
             }
 
-            if(_learning_method == learning_method::krr_trainer_radial_basis_kernel
-                    || _learning_method == learning_method::svr_trainer_radial_basis_kernel
-                    || _learning_method == learning_method::rvm_trainer_radial_basis_kernel)
-            {
-                file_name += "RBK.dat";
-                dlib::serialize(file_name) << _decision_functions_travels.dec_func_rbk;
-            }
-            else if(_learning_method == learning_method::krr_trainer_histogram_intersection_kernel
-                    || _learning_method == learning_method::svr_trainer_histogram_intersection_kernel
-                    || _learning_method == learning_method::rvm_trainer_histogram_intersection_kernel)
-            {
-                file_name += "HIK.dat";
-                dlib::serialize(file_name) << _decision_functions_travels.dec_func_hik;
-            }
-            else if(_learning_method == learning_method::krr_trainer_polynomial_kernel_quadratic
-                    || _learning_method == learning_method::krr_trainer_polynomial_kernel_cubic
-                    || _learning_method == learning_method::svr_trainer_polynomial_kernel_quadratic
-                    || _learning_method == learning_method::svr_trainer_polynomial_kernel_cubic
-                    || _learning_method == learning_method::rvm_trainer_polynomial_kernel_quadratic
-                    || _learning_method == learning_method::rvm_trainer_polynomial_kernel_cubic)
-            {
-                file_name += "PK.dat";
-                dlib::serialize(file_name) << _decision_functions_travels.dec_func_pk;
-            }
-            else if(_learning_method == learning_method::krr_trainer_linear_kernel
-                    || _learning_method == learning_method::svr_trainer_linear_kernel
-                    || _learning_method == learning_method::rvm_trainer_linear_kernel)
-            {
-                file_name += "LK.dat";
-                dlib::serialize(file_name) << _decision_functions_travels.dec_func_lk;
-            }
+            file_name += _predictor_travels.kernel_name() + ".dat";
+            _predictor_travels.save(file_name);
 
             emit(signal_status("Decision function travels saved"));
         }
@@ -3938,5 +6147,7 @@ namespace ml
 
 
 
+
+
 }
 
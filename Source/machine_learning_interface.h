@@ -16,6 +16,8 @@
 #define MACHINE_LEARNING_INTERFACE_H
 
 #include <QObject>
+#include <QFuture>
+#include <QMutex>
 
 #include <vector>
 #include <utility>
@@ -23,13 +25,20 @@
 #include <chrono>
 #include <random>
 #include <unordered_map>
+#include <deque>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <functional>
 
 #include <dlib/svm.h>
 #include <dlib/global_optimization.h>
 
 #include "timetable_solution.h"
 #include "menge_interface.h"
+#include "boosted_trees.h"
 
 #include "logger.h"
 
@@ -77,7 +86,10 @@ namespace ml
         rvm_trainer_histogram_intersection_kernel,      ///< Relevance Vector Machine Regression with Histogram Intersection Kernel
         rvm_trainer_polynomial_kernel_quadratic,        ///< Relevance Vector Machine Regression with Quadratic Polynomial Kernel
         rvm_trainer_polynomial_kernel_cubic,            ///< Relevance Vector Machine Regression with Cubic Polynomial Kernel
-        rvm_trainer_linear_kernel                       ///< Relevance Vector Machine Regression with Linear Kernel
+        rvm_trainer_linear_kernel,                      ///< Relevance Vector Machine Regression with Linear Kernel
+        nystroem_trainer_radial_basis_kernel,           ///< Kernel Ridge Regression with a Nyström approximation of the Radial Basis Kernel (bounded number of basis vectors)
+        gbt_trainer_regression_trees,                   ///< Gradient-Boosted Regression Trees (trained on histograms of the features)
+        krls_trainer_radial_basis_kernel                ///< Kernel Recursive Least Squares with Radial Basis Kernel (online: updated with every observation)
     };
 
 
@@ -93,6 +105,225 @@ namespace ml
         decision_function_histogram_intersection_kernel dec_func_hik;
         decision_function_linear_kernel dec_func_lk;
         decision_function_polynomial_kernel dec_func_pk;
+        boosted_trees dec_func_gbt;
+    };
+
+    struct swap_prediction_cache;
+
+
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /*!
+     *	@brief		A trained surrogate: the decision function of a learning method, compiled once (after training) into the form
+     *              that is cheapest to evaluate.
+     *
+     *  The kernel is resolved when the predictor is compiled, not at every prediction. Every form has its own evaluation,
+     *  specialised at compile time, behind a single virtual call per prediction or per batch of predictions.
+     *  - Linear kernel: 'w.x - b', independent of the number of basis vectors.
+     *  - Polynomial kernel of degree 1, 2 or 3: an explicit polynomial in x (the coefficients of every monomial), if that
+     *    has fewer terms than the sum over the basis vectors. Otherwise the basis vectors are stored contiguously.
+     *  - Radial basis kernel: the basis vectors are stored contiguously in single precision, such that the squared
+     *    distances and the kernel values are computed in a single pass over the memory.
+     *  - Histogram intersection kernel: the decision function itself.
+     *  - Regression trees: the trees themselves, which are already stored flat.
+     *  The predictor also keeps the decision function, e.g. to save it. The incremental prediction of the moves in a
+     *  timeslot, the lower bound, the kernel and the refit are resolved in the same way, such that a new kind of model
+     *  only has to provide its form and these operations, without dispatch on the learning method.
+     *  A compiled decision function is never changed, but replaced as a whole (publish), such that predictions can be
+     *  made concurrently with the publication of a new one.
+     */
+    class predictor
+    {
+    public:
+        /*!
+         *	@brief		Compile the decision function of a learning method.
+         *  @param      lm      The learning method (only its kernel, or the trees, matters).
+         *  @param      df      The decision functions.
+         *  @returns    The predictor.
+         */
+        static predictor compile(learning_method lm, const decision_functions& df);
+
+        /*!
+         *	@brief		Indicates whether the predictor is empty (not compiled).
+         *  @returns    True if the predictor is empty.
+         */
+        bool empty() const { return !std::atomic_load(&_model); }
+
+        /*!
+         *	@brief		A copy of the predictor, which is not affected by later publications.
+         *
+         *  Safe while another thread publishes a new decision function, e.g. to make several predictions with the same one.
+         *
+         *  @returns    The copy.
+         */
+        predictor snapshot() const;
+
+        /*!
+         *	@brief		Replace the compiled decision function by the one of another predictor.
+         *
+         *  The replacement is atomic: a prediction made concurrently uses either the old or the new decision function.
+         *
+         *  @param      other       The predictor with the new decision function.
+         */
+        void publish(const predictor& other);
+
+        /*!
+         *	@brief		Predict the output for an input.
+         *  @param      x       The input.
+         *  @returns    The same value as the decision function (up to rounding), 0 if the predictor is empty.
+         */
+        double operator()(const sample_type& x) const;
+
+        /*!
+         *	@brief		Predict the outputs for a batch of inputs.
+         *  @param      x       The inputs.
+         *  @param      y       The predicted outputs (resized to the number of inputs).
+         */
+        void predict(const std::vector<sample_type>& x, std::vector<double>& y) const;
+
+        /*!
+         *	@brief		Prepare the incremental prediction of the moves (swaps and cycles) in a timeslot.
+         *  @param      input   The input of the timeslot without move.
+         *  @returns    The intermediate results, including a snapshot of this predictor with which the moves are predicted.
+         */
+        swap_prediction_cache prepare_swaps(const sample_type& input) const;
+
+        /*!
+         *	@brief		Predict the output after swapping the elements of the input in two locations.
+         *  @param      cache       The intermediate results of prepare_swaps.
+         *  @param      location1   The first location of the swap.
+         *  @param      location2   The second location of the swap.
+         *  @returns    The same value as the prediction for the input after the swap (up to rounding).
+         */
+        static double predict_swap(const swap_prediction_cache& cache, int location1, int location2);
+
+        /*!
+         *	@brief		Predict the output after rotating the elements of the input in three locations.
+         *
+         *  The element in location1 moves to location2, the one in location2 to location3 and the one in location3 to location1.
+         *
+         *  @param      cache       The intermediate results of prepare_swaps.
+         *  @param      location1   The first location of the cycle.
+         *  @param      location2   The second location of the cycle.
+         *  @param      location3   The third location of the cycle.
+         *  @returns    The same value as the prediction for the input after the rotation (up to rounding).
+         */
+        static double predict_cycle(const swap_prediction_cache& cache, int location1, int location2, int location3);
+
+        /*!
+         *	@brief		A lower bound on the prediction for any non-negative input.
+         *  @returns    The lower bound, or minus infinity if the predictor is not bounded from below (or empty).
+         */
+        double lower_bound() const;
+
+        /*!
+         *	@brief		Evaluate the kernel of the decision function.
+         *  @param      a       The first input.
+         *  @param      b       The second input.
+         *  @returns    The value of the kernel (0 for models without kernel, or if the predictor is empty).
+         */
+        double kernel_value(const sample_type& a, const sample_type& b) const;
+
+        /*!
+         *	@brief		Retrain the decision function with the same kernel (or trees) parameters on other data.
+         *  @param      lm              The learning method (determines the trainer).
+         *  @param      regularization  The regularization parameter of the trainer.
+         *  @param      x               The training inputs.
+         *  @param      y               The training outputs.
+         *  @returns    The decision functions, in which the one of this kind of model is the retrained one.
+         */
+        decision_functions refit(learning_method lm, double regularization, const std::vector<sample_type>& x, const std::vector<double>& y) const;
+
+        /*!
+         *	@brief		The abbreviation of the kernel (RBK, HIK, PK or LK) or GBT for regression trees, as used in the names of saved decision functions.
+         *  @returns    The abbreviation, empty if the predictor is empty.
+         */
+        std::string kernel_name() const;
+
+        /*!
+         *	@brief		Save the decision function (dlib format).
+         *  @param      filename    The name of the file.
+         */
+        void save(const std::string& filename) const;
+
+    private:
+        /*!
+         *	@brief		Interface of a compiled decision function.
+         */
+        struct model;
+
+        /*!
+         *	@brief		A compiled decision function (of a kernel or of trees) and the evaluation of its form.
+         */
+        template<typename function_type, typename evaluator_type>
+        struct model_impl;
+
+        /*!
+         *	@brief		The compiled decision function (shared, since it is not changed after compilation).
+         */
+        std::shared_ptr<const model> _model;
+    };
+
+
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /*!
+     *	@brief		A surrogate that learns online: Kernel Recursive Least Squares (dlib::krls) with a Radial Basis Kernel.
+     *
+     *  Every sample is added in a time that is bounded by the size of the dictionary (the basis vectors), which is
+     *  bounded in turn, such that the surrogate can absorb every simulation of a search without being retrained.
+     *  The samples are added by a single thread; predictions are made with a snapshot (a compiled predictor).
+     */
+    class online_learner
+    {
+    public:
+        /*!
+         *	@brief		Start a new model without samples.
+         *  @param      kernel                  The kernel.
+         *  @param      tolerance               The tolerance of the approximate linear dependence test of the dictionary (larger values give smaller dictionaries).
+         *  @param      max_dictionary_size     The maximum number of basis vectors.
+         */
+        void reset(const radial_basis_kernel& kernel, double tolerance, unsigned long max_dictionary_size);
+
+        /*!
+         *	@brief		Indicates whether the learner has been started (reset).
+         *  @returns    True if the learner has not been started.
+         */
+        bool empty() const { return !_krls; }
+
+        /*!
+         *	@brief		Add a sample to the model.
+         *  @param      x       The input.
+         *  @param      y       The output.
+         */
+        void add_sample(const sample_type& x, double y);
+
+        /*!
+         *	@brief		Add samples to the model, in order.
+         *  @param      x       The inputs.
+         *  @param      y       The outputs.
+         */
+        void add_samples(const std::vector<sample_type>& x, const std::vector<double>& y);
+
+        /*!
+         *	@brief		The current decision function of the model.
+         *  @returns    The decision function (empty if the learner has not been started).
+         */
+        decision_function_radial_basis_kernel decision_function() const;
+
+        /*!
+         *	@brief		A compiled copy of the current model, which is not affected by later samples.
+         *  @returns    The predictor.
+         */
+        predictor snapshot() const;
+
+    private:
+        /*!
+         *	@brief		The model (not copyable, since it is updated in place).
+         */
+        std::unique_ptr<dlib::krls<radial_basis_kernel>> _krls;
     };
 
 
@@ -125,6 +356,19 @@ namespace ml
          */
         bool data_exist() const { return _data_exist; }
 
+        /*!
+         *	@brief		Hash of the surrogate map (nodes and paths), e.g. to recognise stored simulation results.
+         *  @returns    The hash of the surrogate map.
+         */
+        std::uint64_t map_hash() const;
+
+        /*!
+         *	@brief		Get the node of the representation to which a room belongs.
+         *  @param      location        The room.
+         *  @returns    The node of the room.
+         */
+        int room_node(int location) const { return _room_node.at(location); }
+
         /*!
          *	@brief		Transforms a solution to a sample_type that can be used to predict the travel time using the surrogate model.
          *  @param      sol     A timetable::solution for which the travel time is to be predicted.
@@ -135,10 +379,19 @@ namespace ml
 
         /*!
          *	@brief		Generate observations as input for the machine learning tool.
-         *  @param      x_obs       Vector to store the x observations (independent variables).
-         *  @param      y_obs       Vector to store the y observations (dependent variable).
+         *
+         *  Observations stored by previous runs for the same building, surrogate map and pedestrian model are reused.
+         *  The missing samples are generated first and then simulated in parallel. Every observation is added to the
+         *  store as soon as its simulation finishes. If the generation is halted, the samples that were already simulated are kept.
+         *
+         *  @param      menge               Pointer to menge object to run the pedestrian simulations (no ownership).
+         *  @param      x_obs               Vector to store the x observations (independent variables).
+         *  @param      y_obs               Vector to store the y observations (dependent variable).
+         *  @param      nb_observations     The number of observations.
+         *  @param      halt                If not null, the samples that have not been simulated yet are skipped once it is set.
          */
-        void generate_observations(ped::menge_interface *menge, std::vector<sample_type>& x_obs, std::vector<double>& y_obs, int nb_observations);
+        void generate_observations(ped::menge_interface *menge, std::vector<sample_type>& x_obs, std::vector<double>& y_obs, int nb_observations,
+                                   const std::atomic<bool> *halt = nullptr);
 
 
     private:
@@ -179,6 +432,53 @@ namespace ml
          */
         void signal_stat(QString);
 
+        /*!
+         *	@brief      Emits the total number of observations when the generation of the observations starts.
+         */
+        void signal_progress_started(int);
+
+        /*!
+         *	@brief      Emits the number of observations that have been generated and the total number of observations.
+         */
+        void signal_progress(int, int);
+
+    };
+
+
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /*!
+     *	@brief		Intermediate results of the surrogate for evacuations in one timeslot of a solution.
+     *
+     *  A swap of the events in two locations only changes two elements of the input of the surrogate. With these
+     *  intermediate results, the prediction after every swap in the timeslot can be updated in O(number of basis vectors)
+     *  instead of O(number of basis vectors * number of locations).
+     */
+    struct swap_prediction_cache
+    {
+        sample_type input;                  ///< The input of the surrogate for the timeslot (number of people in every location).
+        std::vector<double> basis_values;   ///< Squared distance (radial basis kernel) or dot product (polynomial kernel) with each basis vector, or the weights (linear kernel).
+        double prediction = 0.0;            ///< The prediction for the timeslot without swap.
+        predictor model;                    ///< A snapshot of the surrogate with which the cache was prepared, which predicts the moves (not affected if the surrogate changes during the search).
+    };
+
+
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /*!
+     *	@brief		Model of the predictive variance of a surrogate.
+     *
+     *  The surrogate is treated as the mean of a Gaussian process with the kernel of the learning method, conditioned
+     *  on (a subset of) the training data. The predictive variance of an input x is then
+     *  'scale * (k(x,x) - k_x^T (K + nugget*I)^-1 k_x)': small close to the training data and large far away from it.
+     */
+    struct predictive_variance_model
+    {
+        std::vector<sample_type> inputs;    ///< The training inputs on which the variance is conditioned.
+        dlib::matrix<double> inverse_gram;  ///< The inverse of the (regularised) kernel matrix of the inputs.
+        double scale = 0.0;                 ///< The variance of the training outputs divided by the mean of k(x,x) over the inputs.
     };
 
 
@@ -226,6 +526,178 @@ namespace ml
          */
         double predict_travel_time(const timetable::solution& sol, int first_timeslot) const;
 
+        /*!
+         *	@brief		Predicts the evacuation times of all timeslots of a solution (as one batch).
+         *  @param      sol         A constant reference to the solution.
+         *  @returns    The predicted evacuation time of every timeslot.
+         */
+        std::vector<double> predict_evacuation_times(const timetable::solution& sol) const;
+
+        /*!
+         *	@brief		Predicts the travel times of several timeslot pairs of a solution (as one batch).
+         *  @param      sol                 A constant reference to the solution.
+         *  @param      first_timeslots     The first timeslot of every timeslot pair.
+         *  @returns    The predicted travel time of every timeslot pair.
+         */
+        std::vector<double> predict_travel_times(const timetable::solution& sol, const std::vector<int>& first_timeslots) const;
+
+        /*!
+         *	@brief		Prepare the prediction of the evacuation time after swapping the events in two locations of a timeslot.
+         *  @param      sol         A constant reference to the solution.
+         *  @param      timeslot    The timeslot in which the swaps are made.
+         *  @returns    The intermediate results for predict_evacuation_time_swap.
+         */
+        swap_prediction_cache prepare_evacuation_time_swaps(const timetable::solution& sol, int timeslot) const;
+
+        /*!
+         *	@brief		Predicts the evacuation time after swapping the events in two locations of a timeslot.
+         *
+         *  The prediction is exactly the one of predict_evacuation_time for the solution after the swap, but is
+         *  updated from the intermediate results of prepare_evacuation_time_swaps.
+         *
+         *  @param      cache       The intermediate results for the solution and timeslot.
+         *  @param      location1   The first location of the swap.
+         *  @param      location2   The second location of the swap.
+         *  @returns    The predicted evacuation time after the swap.
+         */
+        double predict_evacuation_time_swap(const swap_prediction_cache& cache, int location1, int location2) const;
+
+        /*!
+         *	@brief		Predicts the evacuation time after rotating the events in three locations of a timeslot.
+         *
+         *  The event in location1 moves to location2, the event in location2 to location3 and the event in location3
+         *  to location1. As for predict_evacuation_time_swap, the prediction is updated from the intermediate results
+         *  of prepare_evacuation_time_swaps.
+         *
+         *  @param      cache       The intermediate results for the solution and timeslot.
+         *  @param      location1   The first location of the cycle.
+         *  @param      location2   The second location of the cycle.
+         *  @param      location3   The third location of the cycle.
+         *  @returns    The predicted evacuation time after the rotation.
+         */
+        double predict_evacuation_time_cycle(const swap_prediction_cache& cache, int location1, int location2, int location3) const;
+
+        /*!
+         *	@brief		A lower bound on the travel time that the surrogate can predict for any (non-negative) input.
+         *  @returns    The lower bound, or minus infinity if the surrogate is not bounded from below.
+         */
+        double lower_bound_travel_time() const;
+
+        /*!
+         *	@brief		Build the models of the predictive variance of the surrogates (see predictive_variance_model).
+         *
+         *  The models are rebuilt automatically when a refinement is installed, and every few observations added to an
+         *  online learner, such that the variance follows the mean. They are replaced atomically, such that the
+         *  variance can be predicted concurrently.
+         */
+        void prepare_predictive_variance();
+
+        /*!
+         *	@brief		Predicts the variance of the prediction of the evacuation time for a given solution and timeslot.
+         *
+         *  The predictive mean is given by predict_evacuation_time. prepare_predictive_variance has to be called first.
+         *  The variance is cached per (hash of the) timeslot configuration until the models are rebuilt.
+         *
+         *  @param      sol         A constant reference to the solution.
+         *  @param      timeslot    The timeslot.
+         *  @returns    The predictive variance (0 if no model of the variance is available).
+         */
+        double predictive_variance_evacuation_time(const timetable::solution& sol, int timeslot) const;
+
+        /*!
+         *	@brief		Predicts the variance of the prediction of the travel time for a given solution and timeslot.
+         *
+         *  The predictive mean is given by predict_travel_time. prepare_predictive_variance has to be called first.
+         *  The variance is cached per (hash of the) timeslot pair configuration until the models are rebuilt.
+         *
+         *  @param      sol                 A constant reference to the solution.
+         *  @param      first_timeslot      The (first) timeslot where the flows originate.
+         *  @returns    The predictive variance (0 if no model of the variance is available).
+         */
+        double predictive_variance_travel_time(const timetable::solution& sol, int first_timeslot) const;
+
+        /*!
+         *	@brief		Add an observation of the evacuation time of a timeslot to the training data (online refinement).
+         *
+         *  Replications of an observed timeslot configuration are averaged into one row, and at most _max_observed_rows
+         *  observed configurations are kept (the oldest ones are evicted), such that the training data stays bounded.
+         *  An online learning method also adds it to its model and publishes the updated surrogate at once.
+         *
+         *  @param      sol                 A constant reference to the solution.
+         *  @param      timeslot            The timeslot.
+         *  @param      evacuation_time     The evacuation time simulated with Menge.
+         */
+        void add_observation_evacuations(const timetable::solution& sol, int timeslot, double evacuation_time);
+
+        /*!
+         *	@brief		Add an observation of the travel time of a timeslot pair to the training data (online refinement).
+         *
+         *  Replications are averaged and the number of observed rows is bounded as in add_observation_evacuations.
+         *  An online learning method also adds it to its model and publishes the updated surrogate at once.
+         *
+         *  @param      sol                 A constant reference to the solution.
+         *  @param      first_timeslot      The first timeslot of the timeslot pair.
+         *  @param      travel_time         The travel time simulated with Menge.
+         */
+        void add_observation_travels(const timetable::solution& sol, int first_timeslot, double travel_time);
+
+        /*!
+         *	@brief		Get the number of observations that were added to the training data since the last refinement was started.
+         *  @returns    The number of observations.
+         */
+        size_t nb_observations_added() const { return _nb_observations_added; }
+
+        /*!
+         *	@brief		Get the version of the surrogates, which changes whenever new surrogates are published.
+         *
+         *  Predictions of different versions are not comparable, e.g. scores of moves that are kept for later use.
+         *
+         *  @returns    The version of the surrogates.
+         */
+        std::uint64_t surrogate_version() const { return _surrogate_version; }
+
+        /*!
+         *	@brief		Check whether the learning method is an online learning method, which absorbs every observation when it is added.
+         *  @returns    True if the learning method is an online learning method.
+         */
+        bool is_online() const;
+
+        /*!
+         *	@brief		Check whether the surrogates can be refined, i.e. whether the hyperparameters of the trained surrogates are known.
+         *
+         *  Online learning methods are never refined, since they absorb every observation when it is added.
+         *
+         *  @returns    True if the surrogates can be refined.
+         */
+        bool can_refine() const;
+
+        /*!
+         *	@brief		Start retraining the surrogates on all training data in the background.
+         *
+         *  The learning method and the hyperparameters of the trained surrogates are kept, only the decision functions are refitted.
+         *  The predictions keep using the current surrogates until the refined surrogates are installed.
+         */
+        void start_refinement();
+
+        /*!
+         *	@brief		Check whether a refinement has been started and not installed yet.
+         *  @returns    True if a refinement is running or ready to be installed.
+         */
+        bool is_refinement_running() const { return _refinement_running; }
+
+        /*!
+         *	@brief		Check whether a refinement is ready to be installed.
+         *  @returns    True if the refinement is finished.
+         */
+        bool is_refinement_finished() const { return _refinement_running && _refinement.isFinished(); }
+
+        /*!
+         *	@brief		Replace the surrogates by the refined surrogates (waits until the refinement is finished).
+         *
+         *  The caller has to make sure that no predictions are made at the same time.
+         */
+        void install_refinement();
+
         /*!
          *	@brief		Sets the menge interface.
          *
@@ -293,14 +765,14 @@ namespace ml
         void train();
 
         /*!
-         *	@brief		Compare different learning methods and return the best one.
+         *	@brief		Compare all learning methods on the training data and report their accuracy and cost.
          *
-         *  If alpha < 0.01, only a surrogate model for evacuations is trained. If alpha > 0.99 only a surrogate model
-         *  for travel between consecutive events is trained. Otherwise, both surrogate models are trained.
+         *  If alpha > 0.99, only the learning methods for evacuations are compared. If alpha < 0.01 only the learning methods
+         *  for travel between consecutive events are compared. Otherwise, both are compared.
          *
-         *  @param      alpha       The weight of both objective function elements,
-         *                          viz. evacuations and travels between consecutive events.
-         *  @returns    The best learning method.
+         *  All learning methods are trained (with hyperparameter search) and cross-validated concurrently on the same folds.
+         *  The report lists the cross-validated MSE, MAE and correlation, the training time, the number of basis vectors and
+         *  the time of a single prediction of every learning method. The surrogates of this object are not changed.
          */
         void compare_learning_methods();
 
@@ -316,6 +788,18 @@ namespace ml
          */
         int get_number_training_data() const { return _nb_training_data; }
 
+        /*!
+         *	@brief		Set the time budget of the search for the best hyperparameters of a learning method.
+         *  @param      seconds     The time budget in seconds.
+         */
+        void set_hyperparameter_search_time_budget(int seconds) { _hyperparameter_search_time_budget = seconds; }
+
+        /*!
+         *	@brief		Get the time budget of the search for the best hyperparameters of a learning method.
+         *  @returns    The time budget in seconds.
+         */
+        int get_hyperparameter_search_time_budget() const { return _hyperparameter_search_time_budget; }
+
         /*!
          *	@brief      Set the learning method that is used to train the surrogates.
          *  @param      lm      The learning method.
@@ -346,6 +830,30 @@ namespace ml
          */
         bool is_trained() const;
 
+        /*!
+         *	@brief      Check whether the surrogate model for evacuations has been trained.
+         *  @returns    True if the surrogate model for evacuations has been trained.
+         */
+        bool is_trained_evacuations() const { return _trained_surrogate_evacuations; }
+
+        /*!
+         *	@brief      Check whether the surrogate model for travels has been trained.
+         *  @returns    True if the surrogate model for travels has been trained.
+         */
+        bool is_trained_travels() const { return _trained_surrogate_travels; }
+
+        /*!
+         *	@brief      The root mean squared error of the surrogate for evacuations on held-out data (10-fold cross-validation at the last training or refinement).
+         *  @returns    The root mean squared error (0 if unknown, e.g. an imported decision function).
+         */
+        double cross_validation_rmse_evacuation_time() const { return _cv_rmse_evacuations; }
+
+        /*!
+         *	@brief      The root mean squared error of the surrogate for travels on held-out data (10-fold cross-validation at the last training or refinement).
+         *  @returns    The root mean squared error (0 if unknown, e.g. an imported decision function).
+         */
+        double cross_validation_rmse_travel_time() const { return _cv_rmse_travels; }
+
         /*!
          *	@brief      Clear all training data.
          */
@@ -359,6 +867,11 @@ namespace ml
          */
         ped::menge_interface *_menge;
 
+        /*!
+         *	@brief      Indicates whether the generation of the training data has been halted.
+         */
+        std::atomic<bool> _halt_training_data{false};
+
         /*!
          *	@brief      Computation time in seconds that was required to generate training data for evacuations.
          */
@@ -414,6 +927,13 @@ namespace ml
          */
         size_t _nb_training_data = 500;
 
+        /*!
+         *	@brief      The time budget in seconds of the search for the best hyperparameters of a learning method.
+         *
+         *  The search stops after this time (or after 50 evaluations), once the batch of evaluations that is running has finished.
+         */
+        int _hyperparameter_search_time_budget = 1000;
+
         /*!
          *	@brief      Which machine learning method will be used to train the surrogate models.
          */
@@ -446,6 +966,228 @@ namespace ml
          */
         decision_functions _decision_functions_travels;
 
+        /*!
+         *	@brief      The compiled decision function that predicts evacuation times.
+         */
+        predictor _predictor_evacuations;
+
+        /*!
+         *	@brief      The compiled decision function that predicts travel times.
+         */
+        predictor _predictor_travels;
+
+        /*!
+         *	@brief      The online model for evacuations (online learning methods only).
+         */
+        online_learner _online_evacuations;
+
+        /*!
+         *	@brief      The online model for travels (online learning methods only).
+         */
+        online_learner _online_travels;
+
+        /*!
+         *	@brief      The regularization parameter (lambda for KRR and GBT, c for SVR, the tolerance for KRLS) of the surrogate for evacuations.
+         *
+         *  Negative if unknown (e.g. an imported decision function).
+         */
+        double _regularization_evacuations = -1.0;
+
+        /*!
+         *	@brief      The regularization parameter (lambda for KRR and GBT, c for SVR, the tolerance for KRLS) of the surrogate for travels.
+         *
+         *  Negative if unknown (e.g. an imported decision function).
+         */
+        double _regularization_travels = -1.0;
+
+        /*!
+         *	@brief      The root mean squared error of the surrogate for evacuations in the cross-validation (0 if unknown).
+         */
+        double _cv_rmse_evacuations = 0.0;
+
+        /*!
+         *	@brief      The root mean squared error of the surrogate for travels in the cross-validation (0 if unknown).
+         */
+        double _cv_rmse_travels = 0.0;
+
+        /*!
+         *	@brief      The version of the surrogates, incremented whenever new surrogates are published.
+         */
+        std::uint64_t _surrogate_version = 0;
+
+        /*!
+         *	@brief      The rows of the training data added by observations (online refinement).
+         */
+        struct observed_rows
+        {
+            /*!
+             *	@brief      The row of the training data and the number of averaged replications per hash of the configuration.
+             */
+            std::unordered_map<std::uint64_t, std::pair<size_t, size_t>> rows;
+
+            /*!
+             *	@brief      The hashes of the observed configurations, from oldest to newest.
+             */
+            std::deque<std::uint64_t> order;
+        };
+
+        /*!
+         *	@brief      The rows of the training data for evacuations added by observations.
+         */
+        observed_rows _observed_evacuations;
+
+        /*!
+         *	@brief      The rows of the training data for travels added by observations.
+         */
+        observed_rows _observed_travels;
+
+        /*!
+         *	@brief      The maximum number of rows added by observations per surrogate.
+         */
+        static constexpr size_t _max_observed_rows = 5000;
+
+        /*!
+         *	@brief      The number of observations added to the training data since the last refinement was started.
+         */
+        size_t _nb_observations_added = 0;
+
+        /*!
+         *	@brief      Has a refinement been started that has not been installed yet?
+         */
+        bool _refinement_running = false;
+
+        /*!
+         *	@brief      The refined decision functions for evacuations and travels and their errors in the cross-validation.
+         */
+        struct refined_surrogates
+        {
+            decision_functions evacuations;         ///< The refined decision functions for evacuations.
+            decision_functions travels;             ///< The refined decision functions for travels.
+            double cv_rmse_evacuations = 0.0;       ///< The root mean squared error in the cross-validation for evacuations.
+            double cv_rmse_travels = 0.0;           ///< The root mean squared error in the cross-validation for travels.
+        };
+
+        /*!
+         *	@brief      The refined surrogates (computed in the background).
+         */
+        QFuture<refined_surrogates> _refinement;
+
+        /*!
+         *	@brief      Have the models of the predictive variance been built?
+         */
+        bool _predictive_variance_prepared = false;
+
+        /*!
+         *	@brief      The model of the predictive variance of the surrogate for evacuations (only accessed with atomic load and store).
+         */
+        std::shared_ptr<const predictive_variance_model> _variance_model_evacuations;
+
+        /*!
+         *	@brief      The model of the predictive variance of the surrogate for travels (only accessed with atomic load and store).
+         */
+        std::shared_ptr<const predictive_variance_model> _variance_model_travels;
+
+        /*!
+         *	@brief      The version of the models of the predictive variance, incremented after they are replaced.
+         */
+        std::atomic<std::uint64_t> _variance_version{0};
+
+        /*!
+         *	@brief      Guards the caches of the predictive variance.
+         */
+        mutable QMutex _variance_cache_mutex;
+
+        /*!
+         *	@brief      The predictive variance of the evacuation time per hash of the timeslot (with the version of the models).
+         */
+        mutable std::unordered_map<std::uint64_t, std::pair<std::uint64_t, double>> _variance_cache_evacuations;
+
+        /*!
+         *	@brief      The predictive variance of the travel time per hash of the timeslot pair (with the version of the models).
+         */
+        mutable std::unordered_map<std::uint64_t, std::pair<std::uint64_t, double>> _variance_cache_travels;
+
+        /*!
+         *	@brief      The maximum number of variances in a cache (it is cleared when full).
+         */
+        static constexpr size_t _variance_cache_max_size = 1 << 20;
+
+        /*!
+         *	@brief      The number of observations of an online learner after which the models of the predictive variance are rebuilt.
+         */
+        static constexpr size_t _online_variance_update_interval = 20;
+
+        /*!
+         *	@brief      The maximum number of training inputs on which the predictive variance is conditioned.
+         *
+         *  Every prediction of the variance takes O(n^2) operations for n inputs.
+         */
+        static constexpr size_t _predictive_variance_max_inputs = 300;
+
+        /*!
+         *	@brief      The nugget added to the diagonal of the kernel matrix, relative to the mean of k(x,x).
+         *
+         *  It models the noise on the simulated outputs and keeps the kernel matrix well conditioned.
+         */
+        static constexpr double _predictive_variance_nugget = 1e-2;
+
+        /*!
+         *	@brief      Build the model of the predictive variance of a surrogate.
+         *  @param      surrogate   The surrogate (for its kernel).
+         *  @param      x           The training inputs.
+         *  @param      y           The training outputs.
+         *  @returns    The model of the predictive variance (without inputs if it cannot be built).
+         */
+        predictive_variance_model build_predictive_variance_model(const predictor& surrogate, const std::vector<sample_type>& x,
+                                                                  const std::vector<double>& y) const;
+
+        /*!
+         *	@brief      Predict the variance of a surrogate for an input.
+         *  @param      model       The model of the predictive variance.
+         *  @param      surrogate   The surrogate (for its kernel).
+         *  @param      input       The input.
+         *  @returns    The predictive variance.
+         */
+        double predictive_variance(const predictive_variance_model& model, const predictor& surrogate, const sample_type& input) const;
+
+        /*!
+         *	@brief      Look up a predictive variance in a cache, or compute and cache it.
+         *  @param      cache       The cache.
+         *  @param      hash        The hash of the (timeslot or timeslot pair) configuration.
+         *  @param      version     The version of the models of the predictive variance, read before the model was loaded.
+         *  @param      compute     Computes the predictive variance.
+         *  @returns    The predictive variance.
+         */
+        double cached_predictive_variance(std::unordered_map<std::uint64_t, std::pair<std::uint64_t, double>>& cache, std::uint64_t hash,
+                                          std::uint64_t version, const std::function<double()>& compute) const;
+
+        /*!
+         *	@brief      Add an observation to the training data, averaging it into the row of the same configuration if present.
+         *  @param      observed    The rows added by observations.
+         *  @param      x           The inputs of the training data.
+         *  @param      y           The outputs of the training data.
+         *  @param      hash        The hash of the (timeslot or timeslot pair) configuration.
+         *  @param      sample      The input of the observation.
+         *  @param      value       The observed output.
+         */
+        void add_observed_row(observed_rows& observed, std::vector<sample_type>& x, std::vector<double>& y,
+                              std::uint64_t hash, const sample_type& sample, double value);
+
+        /*!
+         *	@brief      Compile the current decision functions into compact predictors.
+         *
+         *  Called whenever the decision functions change (training, refinement and import).
+         */
+        void compile_predictors();
+
+        /*!
+         *	@brief      Transform a timeslot of a solution into the input of the surrogate for evacuations.
+         *  @param      sol         A constant reference to the solution.
+         *  @param      timeslot    The timeslot.
+         *  @returns    The number of people in every location.
+         */
+        sample_type evacuation_sample(const timetable::solution& sol, int timeslot) const;
+
 
 
         /*!
@@ -522,11 +1264,76 @@ namespace ml
          */
         static constexpr double _svr_c_max = 1e6;
 
+        /*!
+         *	@brief      The minimum depth of the trees of Gradient-Boosted Regression Trees.
+         *
+         *  A tree of depth d models interactions of up to d features (e.g. rooms that share a stairwell).
+         */
+        static constexpr double _gbt_depth_min = 2.0;
+
+        /*!
+         *	@brief      The maximum depth of the trees of Gradient-Boosted Regression Trees.
+         *
+         *  A tree of depth d models interactions of up to d features (e.g. rooms that share a stairwell).
+         */
+        static constexpr double _gbt_depth_max = 6.0;
+
+        /*!
+         *	@brief      The minimum number of trees of Gradient-Boosted Regression Trees.
+         */
+        static constexpr double _gbt_nb_trees_min = 50.0;
+
+        /*!
+         *	@brief      The maximum number of trees of Gradient-Boosted Regression Trees.
+         */
+        static constexpr double _gbt_nb_trees_max = 500.0;
+
+        /*!
+         *	@brief      The minimum learning rate (shrinkage of every tree) of Gradient-Boosted Regression Trees.
+         *
+         *  Smaller values need more trees, but usually generalize better.
+         */
+        static constexpr double _gbt_learning_rate_min = 0.01;
+
+        /*!
+         *	@brief      The maximum learning rate (shrinkage of every tree) of Gradient-Boosted Regression Trees.
+         *
+         *  Smaller values need more trees, but usually generalize better.
+         */
+        static constexpr double _gbt_learning_rate_max = 0.3;
+
+        /*!
+         *	@brief      The minimum value for the lambda parameter (L2-regularization of the leaf values) of Gradient-Boosted Regression Trees.
+         */
+        static constexpr double _gbt_lambda_min = 1e-3;
+
+        /*!
+         *	@brief      The maximum value for the lambda parameter (L2-regularization of the leaf values) of Gradient-Boosted Regression Trees.
+         */
+        static constexpr double _gbt_lambda_max = 1e3;
+
+        /*!
+         *	@brief      The minimum value for the tolerance of Kernel Recursive Least Squares.
+         *
+         *  A sample is only added to the dictionary if its approximation by the dictionary has a larger error than the tolerance.
+         */
+        static constexpr double _krls_tolerance_min = 1e-4;
+
+        /*!
+         *	@brief      The maximum value for the tolerance of Kernel Recursive Least Squares.
+         *
+         *  A sample is only added to the dictionary if its approximation by the dictionary has a larger error than the tolerance.
+         */
+        static constexpr double _krls_tolerance_max = 0.1;
+
 
 
 
         /*!
          *	@brief      Uses Latin Hypercube Sampling to generate training data for evacuations.
+         *
+         *  Observations stored by previous runs for the same building and pedestrian model are reused, and the store is
+         *  extended with the observations that are simulated.
          */
         void generate_training_data_evacuations();
 
@@ -537,6 +1344,22 @@ namespace ml
 
 
 
+        /*!
+         *	@brief      The functions that train the surrogates for evacuations and for travels with a learning method.
+         */
+        struct training_functions
+        {
+            void (machine_learning_interface::*evacuations)();
+            void (machine_learning_interface::*travels)();
+        };
+
+        /*!
+         *	@brief      Get the functions that train the surrogates with a learning method.
+         *  @param      lm      The learning method.
+         *  @returns    The training functions.
+         */
+        static training_functions training_functions_of(learning_method lm);
+
         /*!
          *	@brief      Function to train a krr_trainer with radial_basis_kernel.
          */
@@ -612,6 +1435,21 @@ namespace ml
          */
         void train_rvm_cubic_evacuations();
 
+        /*!
+         *	@brief      Function to train a nystroem_trainer (approximate kernel ridge regression) with radial_basis_kernel.
+         */
+        void train_nystroem_radial_basis_evacuations();
+
+        /*!
+         *	@brief      Function to train a boosted_trees_trainer (gradient-boosted regression trees).
+         */
+        void train_gbt_evacuations();
+
+        /*!
+         *	@brief      Function to train an online_learner (krls) with radial_basis_kernel.
+         */
+        void train_krls_radial_basis_evacuations();
+
 
 
         /*!
@@ -689,6 +1527,21 @@ namespace ml
          */
         void train_rvm_cubic_travels();
 
+        /*!
+         *	@brief      Function to train a nystroem_trainer (approximate kernel ridge regression) with radial_basis_kernel.
+         */
+        void train_nystroem_radial_basis_travels();
+
+        /*!
+         *	@brief      Function to train a boosted_trees_trainer (gradient-boosted regression trees).
+         */
+        void train_gbt_travels();
+
+        /*!
+         *	@brief      Function to train an online_learner (krls) with radial_basis_kernel.
+         */
+        void train_krls_radial_basis_travels();
+
 
 
 
@@ -710,6 +1563,23 @@ namespace ml
          */
         void signal_status(QString);
 
+        /*!
+         *	@brief      Emits the total number of observations when the generation of the training data starts.
+         */
+        void signal_training_data_started(int);
+
+        /*!
+         *	@brief      Emits the number of observations of the training data that have been generated and the total number of observations.
+         */
+        void signal_training_data_progress(int, int);
+
+
+    public slots:
+        /*!
+         *	@brief      Stop generating training data. The samples that were already simulated are kept.
+         */
+        void halt_training_data_generation();
+
 
     };
 
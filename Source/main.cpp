@@ -1,8 +1,17 @@
 #include "mainwindow.h"
+#include "menge_interface.h"
 #include <QApplication>
+#include <QCoreApplication>
 
 int main(int argc, char *argv[])
 {
+    // a worker process only runs a single simulation (see ped::menge_interface)
+    if(ped::menge_interface::is_worker(argc, argv))
+    {
+        QCoreApplication worker(argc, argv);
+        return ped::menge_interface::run_worker(worker.arguments());
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.setWindowTitle("Timetable Analyser and Optimiser");
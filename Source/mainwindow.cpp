@@ -63,6 +63,10 @@ void MainWindow::make_connections()
     connect(&future_watcher_ml, SIGNAL(finished()), this, SLOT(clear_time()));
     connect(&future_watcher_ml, SIGNAL(finished()), &timer_comptime, SLOT(stop()));
     connect(&ml_surrogate_paths, SIGNAL(signal_stat(QString)), this, SLOT(output_algorithm_info(QString)));
+    connect(&machine_learning_interface, SIGNAL(signal_training_data_started(int)), this, SLOT(training_data_started(int)));
+    connect(&machine_learning_interface, SIGNAL(signal_training_data_progress(int,int)), this, SLOT(training_data_update(int,int)));
+    connect(&ml_surrogate_paths, SIGNAL(signal_progress_started(int)), this, SLOT(training_data_started(int)));
+    connect(&ml_surrogate_paths, SIGNAL(signal_progress(int,int)), this, SLOT(training_data_update(int,int)));
     connect(&mengeinterface, SIGNAL(signal_status(QString)), this, SLOT(output_algorithm_info(QString)));
 
 
@@ -1229,10 +1233,25 @@ void MainWindow::settings_algorithm()
     dialog.set_algorithm_analyze_performance(timetable_algorithm.get_analyze_performance());
     dialog.set_replicationbudget_IS(timetable_algorithm.get_replication_budget_identification_step());
     dialog.set_replicationbudget_TS(timetable_algorithm.get_replication_budget_tabu_search());
+    dialog.set_common_random_numbers(timetable_algorithm.get_common_random_numbers());
+    dialog.set_adaptive_timeslot_selection(timetable_algorithm.get_adaptive_timeslot_selection());
+    dialog.set_full_neighbourhood_scan(timetable_algorithm.get_full_neighbourhood_scan());
+    dialog.set_evaluation_memo(timetable_algorithm.get_evaluation_memo());
+    dialog.set_reactive_tabu(timetable_algorithm.get_reactive_tabu());
+    dialog.set_pipelined_search(timetable_algorithm.get_pipelined_search());
+    dialog.set_online_refinement(timetable_algorithm.get_online_refinement());
+    dialog.set_exhaustive_symmetry_pruning(timetable_algorithm.get_exhaustive_symmetry_pruning());
+    dialog.set_exhaustive_branch_and_bound(timetable_algorithm.get_exhaustive_branch_and_bound());
+    dialog.set_compound_moves(timetable_algorithm.get_compound_moves());
+    dialog.set_path_relinking(timetable_algorithm.get_path_relinking());
+    dialog.set_acquisition_function(timetable_algorithm.get_acquisition_function());
+    dialog.set_search_strategy(timetable_algorithm.get_search_strategy());
+    dialog.set_seed(global::_random_streams.is_random_seed() ? 0 : global::_random_streams.get_seed());
 
     // machine learning
     dialog.set_machine_learning_method(machine_learning_interface.get_learning_method());
     dialog.set_nb_training_data(machine_learning_interface.get_number_training_data());
+    dialog.set_hyperparameter_time_budget(machine_learning_interface.get_hyperparameter_search_time_budget());
 
     // logger
     dialog.set_logger_verbose(global::_logger.is_verbose());
@@ -1249,10 +1268,26 @@ void MainWindow::settings_algorithm()
         timetable_algorithm.set_nb_eval_local_minimum(dialog.get_maxnbevallocalmin());
         timetable_algorithm.set_replication_budget_identification_step(dialog.get_replicationbudget_IS());
         timetable_algorithm.set_replication_budget_tabu_search(dialog.get_replicationbudget_TS());
+        timetable_algorithm.set_common_random_numbers(dialog.get_common_random_numbers());
+        timetable_algorithm.set_adaptive_timeslot_selection(dialog.get_adaptive_timeslot_selection());
+        timetable_algorithm.set_full_neighbourhood_scan(dialog.get_full_neighbourhood_scan());
+        timetable_algorithm.set_evaluation_memo(dialog.get_evaluation_memo());
+        timetable_algorithm.set_reactive_tabu(dialog.get_reactive_tabu());
+        timetable_algorithm.set_pipelined_search(dialog.get_pipelined_search());
+        timetable_algorithm.set_online_refinement(dialog.get_online_refinement());
+        timetable_algorithm.set_exhaustive_symmetry_pruning(dialog.get_exhaustive_symmetry_pruning());
+        timetable_algorithm.set_exhaustive_branch_and_bound(dialog.get_exhaustive_branch_and_bound());
+        timetable_algorithm.set_compound_moves(dialog.get_compound_moves());
+        timetable_algorithm.set_path_relinking(dialog.get_path_relinking());
+        timetable_algorithm.set_acquisition_function(dialog.get_acquisition_function());
+        timetable_algorithm.set_search_strategy(dialog.get_search_strategy());
+        if(dialog.get_seed() != 0 || !global::_random_streams.is_random_seed())
+            global::_random_streams.set_seed(dialog.get_seed());
 
         // machine learning
         machine_learning_interface.set_learning_method(dialog.get_machine_learning_method());
         machine_learning_interface.set_number_training_data(dialog.get_nb_training_data());
+        machine_learning_interface.set_hyperparameter_search_time_budget(dialog.get_hyperparameter_time_budget());
 
         // logger
         global::_logger.set_verbose(dialog.is_logger_verbose());
@@ -1549,7 +1584,11 @@ void MainWindow::do_exhaustive_search()
 
         // initialize algorithm
         timetable_algorithm.set_Menge(&mengeinterface);
+        timetable_algorithm.set_surrogate_paths(&ml_surrogate_paths);
+        timetable_algorithm.set_machine_learning_interface(&machine_learning_interface);
         timetable_algorithm.set_start_solution(timetable_solution);
+        machine_learning_interface.set_menge_interface(&mengeinterface);
+        machine_learning_interface.set_surrogate_paths(&ml_surrogate_paths);
 
         // set parameters
         timetable_algorithm.set_alpha_objective(dialog.get_alpha());
@@ -1740,6 +1779,28 @@ void MainWindow::analyze_solution_update(int value)
 }
 
 
+void MainWindow::training_data_started(int maximum)
+{
+    // a new set of training data is generated (possibly resumed from stored observations)
+    if(progressdialog_training)
+        progressdialog_training->deleteLater();
+
+    progressdialog_training = new QProgressDialog("Generating training data for the surrogates ...", "Cancel", 0, maximum);
+    progressdialog_training->setMinimumDuration(0);
+    connect(progressdialog_training, SIGNAL(canceled()), &machine_learning_interface, SLOT(halt_training_data_generation()));
+}
+
+
+void MainWindow::training_data_update(int value, int maximum)
+{
+    if(progressdialog_training)
+    {
+        progressdialog_training->setMaximum(maximum);
+        progressdialog_training->setValue(value);
+    }
+}
+
+
 void MainWindow::analyze_solution_finalize_view()
 {
     // delete old series
@@ -67,6 +67,7 @@
 #include "menge_dialog_parameter_settings.h"
 #include "machine_learning_interface.h"
 #include "logger.h"
+#include "random_streams.h"
 #include "dialog_instance_generator.h"
 #include "timetable_instance_generator.h"
 
@@ -226,6 +227,19 @@ private slots:
      */
     void analyze_solution_finalize_view();
 
+    /*!
+     *	@brief		Open a new progress dialog when the generation of the training data of the surrogates starts.
+     *  @param      maximum     The total number of observations.
+     */
+    void training_data_started(int maximum);
+
+    /*!
+     *	@brief		Update the progress bar during the generation of the training data of the surrogates.
+     *  @param      value       The number of observations already generated.
+     *  @param      maximum     The total number of observations.
+     */
+    void training_data_update(int value, int maximum);
+
     /*!
      *	@brief		Generate a timetable instance to test the algorithm.
      */
@@ -409,6 +423,11 @@ private:
      */
     QProgressDialog *progressdialog;
 
+    /*!
+     *	@brief		A progress dialog to indicate the remaining time required for the generation of the training data.
+     */
+    QProgressDialog *progressdialog_training = nullptr;
+
     /*!
      *	@brief		The future watcher for the solution analysis by Menge.
      */
@@ -4,6 +4,12 @@
 #include <QFileDialog>
 #include <QFile>
 #include <QMessageBox>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDir>
+#include <QTemporaryDir>
+#include <QProcess>
+#include <QCoreApplication>
 
 #include "MengeCore/Agents/SimulatorInterface.h"
 #include "MengeCore/Math/RandGenerator.h"
@@ -27,6 +33,8 @@
 #include "thirdParty/tclap/CmdLine.h"
 
 #include "logger.h"
+#include "random_streams.h"
+#include "data_hash.h"
 
 #include <random>
 #include <chrono>
@@ -34,16 +42,25 @@
 #include "scenario.h"
 
 #include <cstdio>
+#include <cstring>
 
 
 
 namespace
 {
-    std::random_device randdev;
-    std::seed_seq seedseq{ randdev(), randdev(), randdev(), randdev(), randdev(), randdev(), randdev(), randdev() };
-    std::mt19937 generator(seedseq);
+    std::mt19937_64 generator;
 
     constexpr double NANO = 1000000000.0;
+
+    // Menge keeps global state (simulation clock, default random generator), so only one simulation runs at a time
+    // in this process; concurrent simulations run in worker processes (see menge_interface::simulate_in_worker)
+    QMutex simulation_mutex;
+
+    // the scenario files are written with the generator above and the settings of the next simulation (visualisation)
+    QMutex scenario_mutex;
+
+    // the first argument of the executable in a worker process
+    const char* const worker_argument = "--menge-worker";
 }
 
 
@@ -72,32 +89,14 @@ namespace ped
     // VISUALIZATION
     double menge_interface::visualise_evacuation(const timetable::solution& sol, int timeslot)
     {
-        VISUALIZE = true;
-
-        // 1. MAKE XML FILES
-        write_behavior_xml();
-        write_scene_xml_evacuation(sol, timeslot);
-        //write_view_xml();
-
-
-        // 2. RUN MENGE
-        double evactime = sim_main();
-        return evactime;
+        return simulate_in_process(true, global::random_stream::simulation, _replication_number++,
+                                   [&](const QString& directory) { write_scene_xml_evacuation(sol, timeslot, directory); });
     }
 
     double menge_interface::visualise_flows(const timetable::solution& sol, int first_timeslot)
     {
-        VISUALIZE = true;
-
-        // 1. MAKE XML FILES
-        write_behavior_xml();
-        write_scene_xml_travel(sol, first_timeslot);
-        //write_view_xml();
-
-
-        // 2. RUN MENGE
-        double traveltime = sim_main();
-        return traveltime;
+        return simulate_in_process(true, global::random_stream::simulation, _replication_number++,
+                                   [&](const QString& directory) { write_scene_xml_travel(sol, first_timeslot, directory); });
     }
 
 
@@ -105,32 +104,26 @@ namespace ped
     // CALCULATIONS
     double menge_interface::calculate_evacuation_time(const timetable::solution& sol, int timeslot)
     {
-        VISUALIZE = false;
-
-        // 1. MAKE XML FILES
-        write_behavior_xml();
-        write_scene_xml_evacuation(sol, timeslot);
-        //write_view_xml();
-
-
-        // 2. RUN MENGE
-        double evactime = sim_main();
-        return evactime;
+        return simulate_in_process(false, global::random_stream::simulation, _replication_number++,
+                                   [&](const QString& directory) { write_scene_xml_evacuation(sol, timeslot, directory); });
     }
 
     double menge_interface::calculate_flows_time(const timetable::solution& sol, int first_timeslot)
     {
-        VISUALIZE = false;
-
-        // 1. MAKE XML FILES
-        write_behavior_xml();
-        write_scene_xml_travel(sol, first_timeslot);
-        //write_view_xml();
+        return simulate_in_process(false, global::random_stream::simulation, _replication_number++,
+                                   [&](const QString& directory) { write_scene_xml_travel(sol, first_timeslot, directory); });
+    }
 
+    double menge_interface::calculate_evacuation_time(const timetable::solution& sol, int timeslot, std::uint64_t replication)
+    {
+        return simulate_in_worker(global::random_stream::common_random_numbers, replication,
+                                  [&](const QString& directory) { write_scene_xml_evacuation(sol, timeslot, directory); });
+    }
 
-        // 2. RUN MENGE
-        double traveltime = sim_main();
-        return traveltime;
+    double menge_interface::calculate_flows_time(const timetable::solution& sol, int first_timeslot, std::uint64_t replication)
+    {
+        return simulate_in_worker(global::random_stream::common_random_numbers, replication,
+                                  [&](const QString& directory) { write_scene_xml_travel(sol, first_timeslot, directory); });
     }
 
 
@@ -355,54 +348,161 @@ namespace ped
 
 
     // TO TRAIN SURROGATE
-    double menge_interface::calculate_custom_evacuation_time(const std::vector<int> &nb_people_per_room)
+    double menge_interface::calculate_custom_evacuation_time(const std::vector<int> &nb_people_per_room, std::uint64_t sample)
     {
-        VISUALIZE = false;
+        return simulate_in_worker(global::random_stream::training_data_evacuations, sample,
+                                  [&](const QString& directory) { write_scene_xml_evacuation(nb_people_per_room, directory); });
+    }
+
+    double menge_interface::calculate_custom_travel_time(const std::vector<int> &nb_people_from_room_to_room, std::uint64_t sample)
+    {
+        return simulate_in_worker(global::random_stream::training_data_travels, sample,
+                                  [&](const QString& directory) { write_scene_xml_travel(nb_people_from_room_to_room, directory); });
+    }
+
 
-        // 1. MAKE XML FILES
-        write_behavior_xml();
-        write_scene_xml_evacuation(nb_people_per_room);
-        //write_view_xml();
 
 
-        // 2. RUN MENGE
-        double evactime = sim_main();
-        return evactime;
-    }
 
-    double menge_interface::calculate_custom_travel_time(const std::vector<int> &nb_people_from_room_to_room)
+
+    // PARAMETERS
+    std::uint64_t menge_interface::parameters_hash() const
     {
-        VISUALIZE = false;
+        global::data_hash hash;
+        hash << MODEL << TIME_STEP << SUB_STEPS << SIM_DURATION << _percentile_simulation_stopping_criterion;
+        hash << _ORCA_tau << _ORCA_tauObst;
+        hash << _PedVO_factor << _PedVO_buffer << _PedVO_tau << _PedVO_tauObst << _PedVO_turningBias;
+        hash << _OpenSteer_max_force << _OpenSteer_leak_through << _OpenSteer_reaction_time << _OpenSteer_tau << _OpenSteer_tauObst;
+        hash << _GCF_reaction_time << _GCF_max_agent_dist << _GCF_max_agent_force << _GCF_agent_interp_width << _GCF_agent_force_strength
+             << _GCF_stand_depth << _GCF_move_scale << _GCF_slow_width << _GCF_sway_change;
+        hash << _Helbing_agent_scale << _Helbing_obstacle_scale << _Helbing_reaction_time << _Helbing_body_force << _Helbing_friction
+             << _Helbing_force_distance << _Helbing_mass;
+        hash << _Karamouzas_orient_weight << _Karamouzas_fov << _Karamouzas_reaction_time << _Karamouzas_wall_steepness << _Karamouzas_wall_distance
+             << _Karamouzas_colliding_count << _Karamouzas_d_min << _Karamouzas_d_mid << _Karamouzas_d_max << _Karamouzas_agent_force
+             << _Karamouzas_personal_space << _Karamouzas_anticipation;
+        hash << _Zanlungo_agent_scale << _Zanlungo_obstacle_scale << _Zanlungo_reaction_time << _Zanlungo_force_distance << _Zanlungo_mass
+             << _Zanlungo_orient_weight;
+        hash << _Dummy_stddev;
+        hash << _Common_time_step << _Common_max_angle_vel << _Common_max_neighbors << _Common_obstacleSet << _Common_neighbor_dist << _Common_r
+             << _Common_class << _Common_pref_speed << _Common_pref_speed_stddev << _Common_max_speed << _Common_max_accel;
+        return hash.value();
+    }
 
-        // 1. MAKE XML FILES
-        write_behavior_xml();
-        write_scene_xml_travel(nb_people_from_room_to_room);
-        //write_view_xml();
 
 
-        // 2. RUN MENGE
-        double traveltime = sim_main();
-        return traveltime;
+    // RANDOM STREAMS
+    int menge_interface::start_replication(global::random_stream stream, std::uint64_t replication)
+    {
+        generator = global::_random_streams.make_generator(stream, replication);
+        return global::_random_streams.derive_int_seed(stream, replication);
     }
 
 
 
+    // WORKER PROCESSES
+    bool menge_interface::is_worker(int argc, char *argv[])
+    {
+        return argc > 1 && std::strcmp(argv[1], worker_argument) == 0;
+    }
 
+    int menge_interface::run_worker(const QStringList& arguments)
+    {
+        // program, worker argument, model, time step, sub steps, maximum duration, stopping criterion, seed
+        if(arguments.size() != 8)
+            return 1;
+
+        menge_interface menge;
+        menge.MODEL = arguments[2].toStdString();
+        menge.TIME_STEP = arguments[3].toFloat();
+        menge.SUB_STEPS = arguments[4].toULongLong();
+        menge.SIM_DURATION = arguments[5].toFloat();
+        menge._percentile_simulation_stopping_criterion = arguments[6].toDouble();
+
+        // the scenario files are in the working directory
+        double result = menge.sim_main(QDir::currentPath(), arguments[7].toInt(), false);
+        std::printf("%.17g\n", result);
+        std::fflush(stdout);
+        return 0;
+    }
 
+    double menge_interface::simulate_in_process(bool visualize, global::random_stream stream, std::uint64_t replication,
+                                                const std::function<void(const QString&)>& write_scene)
+    {
+        // the scenario files in the working directory are used until the simulation has finished
+        QMutexLocker locker(&simulation_mutex);
+        const QString directory = QDir::currentPath();
+        int seed = 0;
+        {
+            QMutexLocker scenario_locker(&scenario_mutex);
+            VISUALIZE = visualize;
+            seed = start_replication(stream, replication);
+
+            // 1. MAKE XML FILES
+            write_behavior_xml(directory);
+            write_scene(directory);
+            //write_view_xml();
+        }
 
+        // 2. RUN MENGE
+        return sim_main(directory, seed, visualize);
+    }
 
+    double menge_interface::simulate_in_worker(global::random_stream stream, std::uint64_t replication,
+                                               const std::function<void(const QString&)>& write_scene)
+    {
+        // every simulation has its own scenario files and its own process (with its own Menge state), such that
+        // concurrent simulations run in parallel
+        QTemporaryDir directory(QDir(QDir::tempPath()).filePath("menge_XXXXXX"));
+        if(!directory.isValid())
+            return simulate_in_process(false, stream, replication, write_scene);
 
+        int seed = 0;
+        {
+            QMutexLocker scenario_locker(&scenario_mutex);
+            VISUALIZE = false;
+            seed = start_replication(stream, replication);
 
+            // 1. MAKE XML FILES
+            write_behavior_xml(directory.path());
+            write_scene(directory.path());
+        }
 
+        // 2. RUN MENGE IN A WORKER PROCESS
+        QStringList arguments;
+        arguments << worker_argument << QString::fromStdString(MODEL) << QString::number(TIME_STEP, 'g', 9)
+                  << QString::number(SUB_STEPS) << QString::number(SIM_DURATION, 'g', 9)
+                  << QString::number(_percentile_simulation_stopping_criterion, 'g', 17) << QString::number(seed);
+        QProcess worker;
+        worker.setWorkingDirectory(directory.path());
+        worker.start(QCoreApplication::applicationFilePath(), arguments);
+        if(!worker.waitForStarted(-1))
+        {
+            // no worker process available: the same scenario (same seed) is simulated in this process
+            QMutexLocker locker(&simulation_mutex);
+            return sim_main(directory.path(), seed, false);
+        }
+        worker.waitForFinished(-1);
+
+        // the result is the last line of the output
+        bool ok = false;
+        double result = -1;
+        if(worker.exitStatus() == QProcess::NormalExit && worker.exitCode() == 0)
+            result = worker.readAllStandardOutput().trimmed().split('\n').last().trimmed().toDouble(&ok);
+        return ok ? result : -1;
+    }
 
 
 
     // SIM MAIN
-    double menge_interface::sim_main()
+    double menge_interface::sim_main(const QString& directory, int seed, bool visualize)
     {
+        const std::string behavior_file = QDir(directory).filePath("behavior.xml").toStdString();
+        const std::string scene_file = QDir(directory).filePath("scene.xml").toStdString();
+        const std::string output_file = QDir(directory).filePath("Menge_simulation_output.txt").toStdString();
+
         Menge::SimulatorDB simDB;
 
-        logger.setFile( "log.html" );
+        logger.setFile( QDir(directory).filePath("log.html").toStdString() );
         logger << Logger::INFO_MSG << "initialized logger";
 
         CorePluginEngine plugins( &simDB );
@@ -416,7 +516,8 @@ namespace ped
         }
 
 
-        Menge::Math::setDefaultGeneratorSeed(0);
+        // seed of this replication, derived from the run-level seed (0 would seed Menge on the clock)
+        Menge::Math::setDefaultGeneratorSeed(seed);
 
 
 
@@ -429,11 +530,11 @@ namespace ped
 
         double result;
         if(timetable::nb_locations > 25)
-             result = simulate( simDBEntry, "behavior.xml", "scene.xml",
-                                       "Menge_simulation_output.txt", "Hendrik", VISUALIZE, "officeV.xml", "" );
+             result = simulate( simDBEntry, behavior_file, scene_file,
+                                       output_file, "Hendrik", visualize, "officeV.xml", "" );
         else
-             result = simulate( simDBEntry, "behavior.xml", "scene.xml",
-                                       "Menge_simulation_output.txt", "Hendrik", VISUALIZE, "officeV2.xml", "" );
+             result = simulate( simDBEntry, behavior_file, scene_file,
+                                       output_file, "Hendrik", visualize, "officeV2.xml", "" );
 
         if ( std::fabs(result - 1) < 0.001 ) {
             //std::cerr << "Simulation terminated through error.  See error log for details.\n";
@@ -558,7 +659,7 @@ namespace ped
         else
         {
             std::ifstream file;
-            file.open("Menge_simulation_output.txt");
+            file.open(outFile);
 
             std::string txt;
             size_t agt_count;
@@ -615,9 +716,9 @@ namespace ped
 
 
     // XMLs
-    void menge_interface::write_behavior_xml()
+    void menge_interface::write_behavior_xml(const QString& directory)
     {
-        QFile file("behavior.xml");
+        QFile file(QDir(directory).filePath("behavior.xml"));
         if (file.open(QIODevice::WriteOnly | QIODevice::Text))
         {
             QTextStream stream(&file);
@@ -853,9 +954,9 @@ namespace ped
         }
     }
 
-    void menge_interface::write_scene_xml_evacuation(const timetable::solution &sol, int timeslot)
+    void menge_interface::write_scene_xml_evacuation(const timetable::solution &sol, int timeslot, const QString& directory)
     {
-        QFile file("scene.xml");
+        QFile file(QDir(directory).filePath("scene.xml"));
         if (file.open(QIODevice::WriteOnly | QIODevice::Text))
         {
             QTextStream stream(&file);
@@ -1030,9 +1131,9 @@ namespace ped
 
     }
 
-    void menge_interface::write_scene_xml_travel(const timetable::solution &sol, int first_timeslot)
+    void menge_interface::write_scene_xml_travel(const timetable::solution &sol, int first_timeslot, const QString& directory)
     {
-        QFile file("scene.xml");
+        QFile file(QDir(directory).filePath("scene.xml"));
         if (file.open(QIODevice::WriteOnly | QIODevice::Text))
         {
             QTextStream stream(&file);
@@ -1348,9 +1449,9 @@ namespace ped
 
 
 
-    void menge_interface::write_scene_xml_evacuation(const std::vector<int> &nb_people_per_room)
+    void menge_interface::write_scene_xml_evacuation(const std::vector<int> &nb_people_per_room, const QString& directory)
     {
-        QFile file("scene.xml");
+        QFile file(QDir(directory).filePath("scene.xml"));
         if (file.open(QIODevice::WriteOnly | QIODevice::Text))
         {
             QTextStream stream(&file);
@@ -1488,9 +1589,9 @@ namespace ped
         }
     }
 
-    void menge_interface::write_scene_xml_travel(const std::vector<int>& nb_people_from_room_to_room)
+    void menge_interface::write_scene_xml_travel(const std::vector<int>& nb_people_from_room_to_room, const QString& directory)
     {
-        QFile file("scene.xml");
+        QFile file(QDir(directory).filePath("scene.xml"));
         if (file.open(QIODevice::WriteOnly | QIODevice::Text))
         {
             QTextStream stream(&file);
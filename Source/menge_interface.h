@@ -15,12 +15,18 @@
 #define MENGE_INTERFACE_H
 
 #include <QObject>
+#include <QString>
+#include <QStringList>
 
 #include "building_data.h"
 #include "timetable_global_data.h"
 #include "timetable_solution.h"
+#include "random_streams.h"
 #include <string>
 #include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <functional>
 
 // forward declaration
 namespace Menge
@@ -37,6 +43,11 @@ namespace ped
 {
     /*!
      *	@brief		The interface to use the Menge simulator.
+     *
+     *  Menge keeps process-wide state, so only one simulation runs at a time in this process. The simulations of a
+     *  given replication (or sample of the training data) can be requested from several threads: each is written to
+     *  its own scenario files and simulated in a worker process of its own (this executable, see run_worker), such
+     *  that they run in parallel. The other simulations and the visualisations run in this process.
      */
     class menge_interface: public QObject
     {
@@ -81,6 +92,28 @@ namespace ped
          */
         double calculate_flows_time(const timetable::solution& sol, int first_timeslot);
 
+        /*!
+         *	@brief		Calculate the evacuation time without visualisation for a given timeslot with a given replication
+         *              of the common random number stream.
+         *
+         *  Two calls with the same replication use the same random numbers, such that the difference between two
+         *  solutions can be estimated with less variance (common random numbers).
+         *
+         *  @param      sol     The solution for which an evacuation will be simulated.
+         *  @param      timeslot        The timeslot for which an evacuation will be simulated.
+         *  @param      replication     The index of the replication in the common random number stream.
+         */
+        double calculate_evacuation_time(const timetable::solution& sol, int timeslot, std::uint64_t replication);
+
+        /*!
+         *	@brief		Calculate the travel time without visualisation for a given timeslot pair with a given replication
+         *              of the common random number stream.
+         *  @param      sol     The solution for which an evacuation will be simulated.
+         *  @param      timeslot        The first timeslot of the timeslot pair for which an evacuation will be simulated.
+         *  @param      replication     The index of the replication in the common random number stream.
+         */
+        double calculate_flows_time(const timetable::solution& sol, int first_timeslot, std::uint64_t replication);
+
         /*!
          *	@brief		Calculate the travel time without visualisation for a given timeslot pair.
          *  @param      sol     The solution for which an evacuation will be simulated.
@@ -151,18 +184,28 @@ namespace ped
         int replications() { return m_replications; }
 
         /*!
-         *	@brief		Calculate the evacuation time given a number of people in each room.
+         *	@brief		Calculate the evacuation time of a sample of the training data given a number of people in each room.
+         *
+         *  The random numbers only depend on the index of the sample, such that the training data do not depend on
+         *  the order in which the samples are simulated. Concurrent calls are simulated in parallel.
+         *
          *  @param      nb_people_per_room     The number of people in each room of the building.
+         *  @param      sample                 The index of the sample in the training data.
          *  @returns    The mean evacuation time.
          */
-        double calculate_custom_evacuation_time(const std::vector<int>& nb_people_per_room);
+        double calculate_custom_evacuation_time(const std::vector<int>& nb_people_per_room, std::uint64_t sample);
 
         /*!
-         *	@brief		Calculate the travel time given a number of people in travelling between each pair of rooms.
-         *  @param      nb_people_per_room     The number of people in travelling between each pair of rooms.
+         *	@brief		Calculate the travel time of a sample of the training data given a number of people travelling between each pair of rooms.
+         *
+         *  The random numbers only depend on the index of the sample, such that the training data do not depend on
+         *  the order in which the samples are simulated. Concurrent calls are simulated in parallel.
+         *
+         *  @param      nb_people_from_room_to_room     The number of people in travelling between each pair of rooms.
+         *  @param      sample                          The index of the sample in the training data.
          *  @returns    The mean travel time.
          */
-        double calculate_custom_travel_time(const std::vector<int>& nb_people_from_room_to_room);
+        double calculate_custom_travel_time(const std::vector<int>& nb_people_from_room_to_room, std::uint64_t sample);
 
         /*!
          *	@brief		Get the maximum duration for a single simulation.
@@ -170,6 +213,44 @@ namespace ped
          */
         float max_sim_duration() { return SIM_DURATION; }
 
+        /*!
+         *	@brief		Restart the numbering of the replications, such that the simulations use the same
+         *              random number streams as in a previous run with the same run-level seed.
+         */
+        void reset_replications() { _replication_number = 0; }
+
+        /*!
+         *	@brief		Get the number of replications simulated since the last reset.
+         *  @returns    The number of replications simulated since the last reset.
+         */
+        std::uint64_t replication_number() const { return _replication_number; }
+
+        /*!
+         *	@brief		Hash of all parameters of the pedestrian model and of the simulations (including the stopping criterion),
+         *              e.g. to recognise stored simulation results.
+         *  @returns    The hash of the parameters.
+         */
+        std::uint64_t parameters_hash() const;
+
+        /*!
+         *	@brief		Check whether the executable is started as a worker process of a simulation.
+         *  @param      argc    The number of arguments of the executable.
+         *  @param      argv    The arguments of the executable.
+         *  @returns    True if the executable is started as a worker process.
+         */
+        static bool is_worker(int argc, char *argv[]);
+
+        /*!
+         *	@brief		Run the simulation of a worker process.
+         *
+         *  The scenario files are in the working directory, the settings of the simulation are passed as arguments.
+         *  The simulation time is written to the standard output.
+         *
+         *  @param      arguments   The arguments of the executable.
+         *  @returns    The exit code of the worker process.
+         */
+        static int run_worker(const QStringList& arguments);
+
         /*!
          *	@brief		The percentile of people who have reached their destination,
          *              that is used to calculate the simulation (travel/evacuation)
@@ -409,10 +490,51 @@ namespace ped
          */
         bool stop = false;
 
+        /*!
+         *	@brief		The number of the next replication (index in the simulation random number stream).
+         */
+        std::atomic<std::uint64_t> _replication_number{0};
+
+        /*!
+         *	@brief		Seed the random number generator of the scenario files for a given replication of a given stream.
+         *  @param      stream      The random number stream.
+         *  @param      replication     The index of the replication in the stream.
+         *  @returns    The seed of Menge for the replication.
+         */
+        int start_replication(global::random_stream stream, std::uint64_t replication);
+
+        /*!
+         *	@brief		Write the scenario files to the working directory and simulate them in this process.
+         *  @param      visualize       Indicates whether the simulation should be visualised.
+         *  @param      stream          The random number stream.
+         *  @param      replication     The index of the replication in the stream.
+         *  @param      write_scene     Writes the scene file to a given directory.
+         *  @returns    The simulation time in seconds.
+         */
+        double simulate_in_process(bool visualize, global::random_stream stream, std::uint64_t replication,
+                                   const std::function<void(const QString&)>& write_scene);
+
+        /*!
+         *	@brief		Write the scenario files to a directory of their own and simulate them in a worker process.
+         *
+         *  If no worker process can be started, the scenario is simulated in this process.
+         *
+         *  @param      stream          The random number stream.
+         *  @param      replication     The index of the replication in the stream.
+         *  @param      write_scene     Writes the scene file to a given directory.
+         *  @returns    The simulation time in seconds (-1 if the worker process failed).
+         */
+        double simulate_in_worker(global::random_stream stream, std::uint64_t replication,
+                                  const std::function<void(const QString&)>& write_scene);
+
         /*!
          *	@brief		The main simulation function.
+         *  @param      directory   The directory of the scenario files.
+         *  @param      seed        The seed of Menge.
+         *  @param      visualize   Indicates whether the simulation should be visualised.
+         *  @returns    The simulation time in seconds.
          */
-        double sim_main();
+        double sim_main(const QString& directory, int seed, bool visualize);
 
         /*!
          *	@brief		Function that calls the Menge simulator with the correct specifications.
@@ -433,22 +555,25 @@ namespace ped
 
         /*!
          *	@brief		Write an xml file that contains the behaviour specification for the simulation.
+         *  @param      directory       The directory of the scenario files.
          */
-        void write_behavior_xml();
+        void write_behavior_xml(const QString& directory);
 
         /*!
          *	@brief		Write an xml file that contains the scene specification for the simulation.
          *  @param      sol     The solution for which an evacuation will be simulated.
          *  @param      timeslot        The timeslot in which an evacuation will be simulated.
+         *  @param      directory       The directory of the scenario files.
          */
-        void write_scene_xml_evacuation(const timetable::solution& sol, int timeslot);
+        void write_scene_xml_evacuation(const timetable::solution& sol, int timeslot, const QString& directory);
 
         /*!
          *	@brief		Write an xml file that contains the scene specification for the simulation.
          *  @param      sol     The solution for which the people flows between events in consecutive timeslots will be simulated.
          *  @param      timeslot        The first timeslot in the timeslot pair for which the people flows between events in consecutive timeslots will be simulated.
+         *  @param      directory       The directory of the scenario files.
          */
-        void write_scene_xml_travel(const timetable::solution& sol, int first_timeslot);
+        void write_scene_xml_travel(const timetable::solution& sol, int first_timeslot, const QString& directory);
 
         /*!
          *	@brief		Write an xml file that contains the visualisation specification for the simulation.
@@ -458,14 +583,16 @@ namespace ped
         /*!
          *	@brief		Write an xml file that contains the scene specification for the simulation.
          *  @param      nb_people_per_room     The number of people in each room of the building.
+         *  @param      directory              The directory of the scenario files.
          */
-        void write_scene_xml_evacuation(const std::vector<int> &nb_people_per_room);
+        void write_scene_xml_evacuation(const std::vector<int> &nb_people_per_room, const QString& directory);
 
         /*!
          *	@brief		Write an xml file that contains the scene specification for the simulation.
          *  @param      nb_people_per_room     The number of people travelling between each pair of rooms in the building.
+         *  @param      directory              The directory of the scenario files.
          */
-        void write_scene_xml_travel(const std::vector<int>& nb_people_from_room_to_room);
+        void write_scene_xml_travel(const std::vector<int>& nb_people_from_room_to_room, const QString& directory);
     };
 
 } // namespace ped
@@ -0,0 +1,96 @@
+/*
+ *	Code for the surrogate-based tabu search algorithm
+ *  to optimise people flows in a timetable.
+ *
+ *	Code author: Hendrik Vermuyten
+ */
+
+/*!
+ *	@file		random_streams.cpp
+ *  @author     Hendrik Vermuyten
+ *	@brief		The implementation of the run-level seed from which all random number streams of the program are derived.
+ */
+
+#include "random_streams.h"
+
+namespace
+{
+    /////////////////////////////////////////////////////////////////////
+    ///					Seed mixing
+    /////////////////////////////////////////////////////////////////////
+
+    /*!
+     *	@brief		The SplitMix64 mixing function.
+     */
+    std::uint64_t splitmix64(std::uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+}
+
+
+
+namespace global
+{
+    /////////////////////////////////////////////////////////////////////
+    ///					Implementation of random_streams
+    /////////////////////////////////////////////////////////////////////
+
+    random_streams _random_streams;
+
+    /////////////////////////////////////////////////////////////////////
+
+    random_streams::random_streams()
+    {
+        set_seed(0);
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    void random_streams::set_seed(std::uint64_t seed)
+    {
+        if(seed == 0)
+        {
+            std::random_device randdev;
+            _seed = (static_cast<std::uint64_t>(randdev()) << 32) | randdev();
+            if(_seed == 0)
+                _seed = 1;
+            _random_seed = true;
+        }
+        else
+        {
+            _seed = seed;
+            _random_seed = false;
+        }
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    std::uint64_t random_streams::derive_seed(random_stream stream, std::uint64_t index) const
+    {
+        std::uint64_t x = splitmix64(_seed);
+        x = splitmix64(x ^ static_cast<std::uint64_t>(stream));
+        return splitmix64(x ^ index);
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    int random_streams::derive_int_seed(random_stream stream, std::uint64_t index) const
+    {
+        int seed = static_cast<int>(derive_seed(stream, index) & 0x7FFFFFFFULL);
+        return (seed == 0) ? 1 : seed;
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    std::mt19937_64 random_streams::make_generator(random_stream stream, std::uint64_t index) const
+    {
+        std::uint64_t seed = derive_seed(stream, index);
+        std::seed_seq seedseq{ static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) };
+        return std::mt19937_64(seedseq);
+    }
+
+}   // namespace global
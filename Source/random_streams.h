@@ -0,0 +1,118 @@
+/*
+ *	Code for the surrogate-based tabu search algorithm
+ *  to optimise people flows in a timetable.
+ *
+ *	Code author: Hendrik Vermuyten
+ */
+
+/*!
+ *	@file		random_streams.h
+ *  @author     Hendrik Vermuyten
+ *	@brief		A single run-level seed from which all random number streams of the program are derived.
+ */
+
+#ifndef RANDOM_STREAMS_H
+#define RANDOM_STREAMS_H
+
+#include <cstdint>
+#include <random>
+
+/*!
+ *  @namespace global
+ *  @brief	The namespace containing all global elements.
+ */
+namespace global
+{
+    /*!
+     *	@brief		The independent random number streams used in the program.
+     */
+    enum class random_stream : std::uint64_t
+    {
+        neighbourhood = 1,      ///< Random choices of the tabu search (e.g. the timeslot of the neighbourhood).
+        latin_hypercube = 2,    ///< Latin hypercube sampling of the training data of the surrogates.
+        simulation = 3,         ///< The replications of the pedestrian simulator.
+        common_random_numbers = 4,  ///< Replications of the pedestrian simulator that are synchronised between solutions (common random numbers).
+        training_data_evacuations = 5,  ///< The simulations of the training data of the surrogate for evacuations (one index per sample).
+        training_data_travels = 6       ///< The simulations of the training data of the surrogate for travels (one index per sample).
+    };
+
+    /*!
+     *	@brief		Generates the seeds of all random number streams from one run-level seed.
+     *
+     *  Every stream (and every index within a stream, e.g. a simulation replication)
+     *  gets its own seed by hashing the run-level seed together with the stream and the index
+     *  (SplitMix64). The streams are therefore independent of each other and of the order in which
+     *  they are requested, such that a run is reproducible given its seed.
+     */
+    class random_streams
+    {
+    public:
+        /*!
+         *	@brief		Constructor. Draws a random run-level seed.
+         */
+        random_streams();
+
+        /*!
+         *	@brief		Set the run-level seed.
+         *  @param      seed     The run-level seed. If 0, a random seed is drawn.
+         */
+        void set_seed(std::uint64_t seed);
+
+        /*!
+         *	@brief		Get the run-level seed that is currently used.
+         *  @returns    The run-level seed that is currently used.
+         */
+        std::uint64_t get_seed() const { return _seed; }
+
+        /*!
+         *	@brief		Indicates whether the run-level seed was drawn randomly or set by the user.
+         *  @returns    True if the run-level seed was drawn randomly, false otherwise.
+         */
+        bool is_random_seed() const { return _random_seed; }
+
+        /*!
+         *	@brief		Derive the seed of a given stream.
+         *  @param      stream      The random number stream.
+         *  @param      index       The index within the stream (e.g. the number of the replication).
+         *  @returns    The seed of the stream.
+         */
+        std::uint64_t derive_seed(random_stream stream, std::uint64_t index = 0) const;
+
+        /*!
+         *	@brief		Derive a strictly positive 32-bit seed of a given stream (e.g. for Menge, where 0 means seeding on the clock).
+         *  @param      stream      The random number stream.
+         *  @param      index       The index within the stream (e.g. the number of the replication).
+         *  @returns    The seed of the stream.
+         */
+        int derive_int_seed(random_stream stream, std::uint64_t index = 0) const;
+
+        /*!
+         *	@brief		Construct a random number generator for a given stream.
+         *  @param      stream      The random number stream.
+         *  @param      index       The index within the stream.
+         *  @returns    A random number generator seeded for the stream.
+         */
+        std::mt19937_64 make_generator(random_stream stream, std::uint64_t index = 0) const;
+
+    private:
+        /*!
+         *	@brief		The run-level seed.
+         */
+        std::uint64_t _seed;
+
+        /*!
+         *	@brief		Indicates whether the run-level seed was drawn randomly.
+         */
+        bool _random_seed;
+    };
+
+
+
+    /*!
+     *  @brief The single globally available set of random number streams.
+     */
+    extern random_streams _random_streams;
+
+}   // namespace global
+
+#endif // RANDOM_STREAMS_H
@@ -0,0 +1,181 @@
+#include "timetable_evaluator.h"
+#include <algorithm>
+
+namespace timetable
+{
+    /////////////////////////////////////////////////////////////////////
+    ///					Implementation of evaluator
+    /////////////////////////////////////////////////////////////////////
+
+    evaluator::evaluator()
+    {
+
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    std::uint64_t evaluator::common_random_number_index(bool travels, int timeslot, int replication, int attempt)
+    {
+        // the same for every solution, different for every timeslot, type of simulation and reattempt of a stuck simulation
+        std::uint64_t index = static_cast<std::uint64_t>(replication);
+        index = index * 4 + static_cast<std::uint64_t>(attempt);
+        index = index * 2 + (travels ? 1 : 0);
+        index = index * static_cast<std::uint64_t>(std::max(nb_timeslots, 1)) + static_cast<std::uint64_t>(timeslot);
+        return index;
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    void evaluator::reset()
+    {
+        _memo_evac.clear();
+        _memo_travels.clear();
+        _nb_simulations = 0;
+        _nb_reused_simulations = 0;
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    // SURROGATE SCORES
+    double evaluator::predict_objective_value(const solution& sol) const
+    {
+        double value = 0.0;
+        if(_alpha_objective > 0.01)
+        {
+            for(double evacuation_time : _surrogate->predict_evacuation_times(sol))
+                value += _alpha_objective * evacuation_time;
+        }
+        if(_alpha_objective < 0.99)
+        {
+            for(double travel_time : _surrogate->predict_travel_times(sol, _timeslots_to_calculate_traveltimes))
+                value += (1-_alpha_objective) * travel_time;
+        }
+        return value;
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    double evaluator::predict_objective_value_timeslot(const solution& sol, int timeslot) const
+    {
+        double value = 0.0;
+        if(_alpha_objective > 0.01)
+            value += _alpha_objective * _surrogate->predict_evacuation_time(sol, timeslot);
+        if(_alpha_objective < 0.99)
+        {
+            if(timeslot > 0)
+                value += (1-_alpha_objective) * _surrogate->predict_travel_time(sol, timeslot - 1);
+            if(timeslot < nb_timeslots - 1)
+                value += (1-_alpha_objective) * _surrogate->predict_travel_time(sol, timeslot);
+        }
+        return value;
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    // SIMULATIONS
+    double evaluator::simulate_evacuation(const solution& sol, int timeslot, int replication)
+    {
+        std::vector<double> *memo = nullptr;
+        if(_evaluation_memo)
+        {
+            memo = &_memo_evac[sol.hash_timeslot(timeslot)];
+            if(replication >= 0 && replication < (int)memo->size())
+            {
+                ++_nb_reused_simulations;
+                return (*memo)[replication];
+            }
+        }
+
+        double evactt = _menge->max_sim_duration();
+        int again = 0;
+        do { // if simulation gets stuck, recalculate
+            if(_common_random_numbers)
+                evactt = _menge->calculate_evacuation_time(sol, timeslot, common_random_number_index(false, timeslot, replication, again));
+            else
+                evactt = _menge->calculate_evacuation_time(sol, timeslot);
+            ++again;
+        } while(evactt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
+        ++_nb_simulations;
+
+        // simulations that got stuck are not used to train the surrogates
+        if(learns_from_simulations() && evactt <= _menge->max_sim_duration() - 1.f)
+            _surrogate->add_observation_evacuations(sol, timeslot, evactt);
+
+        if(memo && replication == (int)memo->size())
+            memo->push_back(evactt);
+        return evactt;
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    double evaluator::simulate_travels(const solution& sol, int first_timeslot, int replication)
+    {
+        std::vector<double> *memo = nullptr;
+        if(_evaluation_memo)
+        {
+            memo = &_memo_travels[sol.hash_timeslot_pair(first_timeslot)];
+            if(replication >= 0 && replication < (int)memo->size())
+            {
+                ++_nb_reused_simulations;
+                return (*memo)[replication];
+            }
+        }
+
+        double traveltt = _menge->max_sim_duration();
+        int again = 0;
+        do { // if simulation gets stuck, recalculate
+            if(_common_random_numbers)
+                traveltt = _menge->calculate_flows_time(sol, first_timeslot, common_random_number_index(true, first_timeslot, replication, again));
+            else
+                traveltt = _menge->calculate_flows_time(sol, first_timeslot);
+            ++again;
+        } while(traveltt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
+        ++_nb_simulations;
+
+        // simulations that got stuck are not used to train the surrogates
+        if(learns_from_simulations() && traveltt <= _menge->max_sim_duration() - 1.f)
+            _surrogate->add_observation_travels(sol, first_timeslot, traveltt);
+
+        if(memo && replication == (int)memo->size())
+            memo->push_back(traveltt);
+        return traveltt;
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    void evaluator::simulate_timeslots(solution& sol, const std::vector<bool>& timeslot_changed, int nb_replications)
+    {
+        if(_alpha_objective > 0.01)
+        {
+            for(int t = 0; t < nb_timeslots; ++t)
+            {
+                if(!timeslot_changed[t])
+                    continue;
+                sol.reset_objective_values_evac(t);
+                for(int j = 0; j < nb_replications; ++j)
+                    sol.add_objective_value_evac(t, simulate_evacuation(sol, t, j));
+                sol.calculate_means_and_stddevs_evac(t);
+            }
+        }
+        if(_alpha_objective < 0.99)
+        {
+            for(int t : _timeslots_to_calculate_traveltimes)
+            {
+                if(!timeslot_changed[t] && !timeslot_changed[t+1])
+                    continue;
+                sol.reset_objective_values_travels(t);
+                for(int j = 0; j < nb_replications; ++j)
+                    sol.add_objective_value_travels(t, simulate_travels(sol, t, j));
+                sol.calculate_means_and_stddevs_travels(t);
+            }
+        }
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    void evaluator::simulate_solution(solution& sol, int nb_replications)
+    {
+        simulate_timeslots(sol, std::vector<bool>(nb_timeslots, true), nb_replications);
+    }
+
+}   // namespace timetable
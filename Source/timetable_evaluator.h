@@ -0,0 +1,257 @@
+/*
+ *	Code for the surrogate-based tabu search algorithm
+ *  to optimise people flows in a timetable.
+ *
+ *	Code author: Hendrik Vermuyten
+ */
+
+/*!
+ *	@file		timetable_evaluator.h
+ *  @author     Hendrik Vermuyten
+ *	@brief		The evaluation layer that is shared by all search strategies: surrogate scores, simulations, caching and statistics.
+ */
+
+#ifndef TIMETABLE_EVALUATOR_H
+#define TIMETABLE_EVALUATOR_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+#include "menge_interface.h"
+#include "machine_learning_interface.h"
+#include "timetable_global_data.h"
+#include "timetable_solution.h"
+
+/*!
+ *  @namespace timetable
+ *  @brief	The namespace containing all elements related to the timetable and its optimisation.
+ */
+namespace timetable
+{
+    /*!
+     *	@brief		The evaluation of timetable solutions with the surrogates and with Menge.
+     *
+     *  All search strategies evaluate their solutions through this class, such that the memo of the simulations,
+     *  the common random numbers, the online refinement of the surrogates and the statistics are shared.
+     */
+    class evaluator
+    {
+    public:
+        /*!
+         *	@brief      Default constructor.
+         */
+        evaluator();
+
+        /*!
+         *	@brief      Set the menge interface.
+         *  @param      menge       A pointer to a menge_interface instance (no ownership).
+         */
+        void set_Menge(ped::menge_interface *menge) { _menge = menge; }
+
+        /*!
+         *	@brief      Set the surrogates.
+         *  @param      surrogate       A pointer to a machine_learning_interface instance (no ownership).
+         */
+        void set_surrogate(ml::machine_learning_interface *surrogate) { _surrogate = surrogate; }
+
+        /*!
+         *	@brief      Set the weight of the evacuation time in the objective value.
+         *  @param      alpha       The weight of the evacuation time (between 0 and 1).
+         */
+        void set_alpha_objective(double alpha) { _alpha_objective = alpha; }
+
+        /*!
+         *	@brief      Set the timeslots for which the travel times are part of the objective value.
+         *  @param      timeslots       The first timeslot of every relevant timeslot pair.
+         */
+        void set_timeslots_to_calculate_traveltimes(const std::vector<int>& timeslots) { _timeslots_to_calculate_traveltimes = timeslots; }
+
+        /*!
+         *	@brief      Set whether the replications of all solutions are synchronised (common random numbers).
+         *  @param      crn     True if common random numbers are used.
+         */
+        void set_common_random_numbers(bool crn) { _common_random_numbers = crn; }
+
+        /*!
+         *	@brief      Set whether the observations of Menge are memorised and reused for re-visited configurations.
+         *  @param      memo    True if the observations are memorised.
+         */
+        void set_evaluation_memo(bool memo) { _evaluation_memo = memo; }
+
+        /*!
+         *	@brief      Set whether the simulations are added as observations to refine the surrogates.
+         *  @param      refinement      True if the surrogates are refined with the simulations.
+         */
+        void set_online_refinement(bool refinement) { _online_refinement = refinement; }
+
+        /*!
+         *	@brief      Clear the memo and the statistics.
+         */
+        void reset();
+
+
+
+        /*!
+         *	@brief      Predict the objective value of a solution with the surrogates.
+         *  @param      sol     The solution.
+         *  @returns    The predicted objective value.
+         */
+        double predict_objective_value(const solution& sol) const;
+
+        /*!
+         *	@brief      Predict the terms of the objective value that depend on a timeslot with the surrogates.
+         *
+         *  These are the evacuation time of the timeslot and the travel times from the previous and to the next timeslot.
+         *
+         *  @param      sol         The solution.
+         *  @param      timeslot    The timeslot.
+         *  @returns    The predicted (weighted) sum of the terms.
+         */
+        double predict_objective_value_timeslot(const solution& sol, int timeslot) const;
+
+
+
+        /*!
+         *	@brief      Simulate the evacuation of a solution in a timeslot with Menge (recalculated if the simulation gets stuck).
+         *
+         *  If the memo is used and the replication of the timeslot configuration has been simulated before, that observation is returned.
+         *
+         *  @param      sol             The solution.
+         *  @param      timeslot        The timeslot.
+         *  @param      replication     The number of the replication of the solution (used for common random numbers).
+         *  @returns    The evacuation time.
+         */
+        double simulate_evacuation(const solution& sol, int timeslot, int replication);
+
+        /*!
+         *	@brief      Simulate the travels of a solution in a timeslot pair with Menge (recalculated if the simulation gets stuck).
+         *
+         *  If the memo is used and the replication of the timeslot pair configuration has been simulated before, that observation is returned.
+         *
+         *  @param      sol             The solution.
+         *  @param      first_timeslot  The first timeslot of the timeslot pair.
+         *  @param      replication     The number of the replication of the solution (used for common random numbers).
+         *  @returns    The travel time.
+         */
+        double simulate_travels(const solution& sol, int first_timeslot, int replication);
+
+        /*!
+         *	@brief      Simulate all terms of the objective value of a solution that depend on some timeslots.
+         *
+         *  The observations of the evacuations of the changed timeslots and of the travels of the timeslot pairs
+         *  that contain a changed timeslot are replaced by new replications. The other observations are kept.
+         *
+         *  @param      sol                 The solution.
+         *  @param      timeslot_changed    Indicates for every timeslot whether it is simulated.
+         *  @param      nb_replications     The number of replications.
+         */
+        void simulate_timeslots(solution& sol, const std::vector<bool>& timeslot_changed, int nb_replications);
+
+        /*!
+         *	@brief      Simulate all terms of the objective value of a solution.
+         *  @param      sol                 The solution.
+         *  @param      nb_replications     The number of replications.
+         */
+        void simulate_solution(solution& sol, int nb_replications);
+
+
+
+        /*!
+         *	@brief      The number of simulations actually run with Menge (i.e. not reused from the memo).
+         *  @returns    The number of simulations.
+         */
+        std::size_t nb_simulations() const { return _nb_simulations; }
+
+        /*!
+         *	@brief      The number of simulations that were reused from the memo.
+         *  @returns    The number of reused simulations.
+         */
+        std::size_t nb_reused_simulations() const { return _nb_reused_simulations; }
+
+        /*!
+         *	@brief      Index of a replication in the common random number stream.
+         *  @param      travels         True for the travels of a timeslot pair, false for the evacuation of a timeslot.
+         *  @param      timeslot        The (first) timeslot.
+         *  @param      replication     The number of the replication.
+         *  @param      attempt         The number of the reattempt of a simulation that got stuck.
+         *  @returns    The index in the common random number stream.
+         */
+        static std::uint64_t common_random_number_index(bool travels, int timeslot, int replication, int attempt);
+
+        /*!
+         *	@brief      Check whether the simulations are added as observations to the surrogates.
+         *
+         *  This is the case with online refinement, and always with an online learning method, whose surrogates are
+         *  only useful if they absorb the simulations of the search.
+         *
+         *  @returns    True if the simulations are added to the surrogates.
+         */
+        bool learns_from_simulations() const { return _online_refinement || (_surrogate && _surrogate->is_online()); }
+
+
+
+    private:
+        /*!
+         *	@brief      Pointer to menge object to run the pedestrian simulations (no ownership).
+         */
+        ped::menge_interface *_menge = nullptr;
+
+        /*!
+         *	@brief      Pointer to the surrogates (no ownership).
+         */
+        ml::machine_learning_interface *_surrogate = nullptr;
+
+        /*!
+         *	@brief      The weight of the evacuation time in the objective value.
+         */
+        double _alpha_objective = 0.5;
+
+        /*!
+         *	@brief      The first timeslot of every timeslot pair of which the travel time is part of the objective value.
+         */
+        std::vector<int> _timeslots_to_calculate_traveltimes;
+
+        /*!
+         *	@brief      Indicates whether common random numbers are used.
+         */
+        bool _common_random_numbers = false;
+
+        /*!
+         *	@brief      Indicates whether the observations of Menge are memorised and reused for re-visited configurations.
+         *
+         *  The evacuation time of a timeslot and the travel time of a timeslot pair only depend on the assignment of the
+         *  events in those timeslots, such that the observations are stored per (Zobrist) hash of that assignment.
+         */
+        bool _evaluation_memo = false;
+
+        /*!
+         *	@brief      Indicates whether the simulations refine the surrogates.
+         */
+        bool _online_refinement = false;
+
+        /*!
+         *	@brief      The evacuation times of all replications, per hash of the timeslot.
+         */
+        std::unordered_map<std::uint64_t, std::vector<double>> _memo_evac;
+
+        /*!
+         *	@brief      The travel times of all replications, per hash of the timeslot pair.
+         */
+        std::unordered_map<std::uint64_t, std::vector<double>> _memo_travels;
+
+        /*!
+         *	@brief      The number of simulations actually run with Menge.
+         */
+        std::size_t _nb_simulations = 0;
+
+        /*!
+         *	@brief      The number of simulations reused from the memo.
+         */
+        std::size_t _nb_reused_simulations = 0;
+    };
+
+}   // namespace timetable
+
+#endif // TIMETABLE_EVALUATOR_H
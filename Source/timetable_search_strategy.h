@@ -0,0 +1,87 @@
+/*
+ *	Code for the surrogate-based tabu search algorithm
+ *  to optimise people flows in a timetable.
+ *
+ *	Code author: Hendrik Vermuyten
+ */
+
+/*!
+ *	@file		timetable_search_strategy.h
+ *  @author     Hendrik Vermuyten
+ *	@brief		The interface of the search strategies (metaheuristics) that optimise a timetable.
+ */
+
+#ifndef TIMETABLE_SEARCH_STRATEGY_H
+#define TIMETABLE_SEARCH_STRATEGY_H
+
+#include <QString>
+#include <functional>
+#include <random>
+
+#include "timetable_evaluator.h"
+#include "timetable_solution.h"
+
+/*!
+ *  @namespace timetable
+ *  @brief	The namespace containing all elements related to the timetable and its optimisation.
+ */
+namespace timetable
+{
+    /*!
+     *	@brief		The search strategies that can explore the solution space.
+     */
+    enum class search_strategy_type
+    {
+        tabu_search,            ///< The surrogate-based tabu search.
+        simulated_annealing     ///< Simulated annealing with surrogate-screened moves.
+    };
+
+
+
+    /*!
+     *	@brief		Everything a search strategy gets from the algorithm that runs it.
+     */
+    struct search_context
+    {
+        evaluator *eval = nullptr;                                  ///< The shared evaluation layer.
+        solution *current_solution = nullptr;                       ///< The current solution, evaluated with Menge (the strategy continues from it and updates it).
+        std::mt19937_64 *generator = nullptr;                       ///< The random number generator of the search.
+        double alpha_objective = 0.5;                               ///< The weight of the evacuation time in the objective value.
+        int nb_replications = 1;                                    ///< The number of replications of Menge to evaluate a (changed part of a) solution.
+        int replication_budget = 0;                                 ///< The number of replications of Menge the strategy can use.
+        std::function<void(const QString&)> report_status;          ///< Report the progress of the search.
+        std::function<void(const solution&)> report_solution;       ///< Report a solution that has been evaluated with Menge as a possible best solution.
+    };
+
+
+
+    /*!
+     *	@brief		The interface of a search strategy.
+     *
+     *  A strategy only contains the search logic (neighbourhood, selection and acceptance). All evaluations go through
+     *  the evaluator of the context, such that the simulations, caching and statistics are shared by all strategies.
+     */
+    class search_strategy
+    {
+    public:
+        /*!
+         *	@brief      Destructor.
+         */
+        virtual ~search_strategy() {}
+
+        /*!
+         *	@brief      The name of the strategy (for the output).
+         *  @returns    The name.
+         */
+        virtual QString strategy_name() const = 0;
+
+        /*!
+         *	@brief      Explore the solution space from the current solution of the context.
+         *  @param      context     The context of the search.
+         */
+        virtual void search(search_context& context) = 0;
+    };
+
+}   // namespace timetable
+
+#endif // TIMETABLE_SEARCH_STRATEGY_H
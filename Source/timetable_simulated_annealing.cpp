@@ -0,0 +1,125 @@
+#include "timetable_simulated_annealing.h"
+#include <cmath>
+
+namespace timetable
+{
+    /////////////////////////////////////////////////////////////////////
+    ///					Implementation of simulated_annealing
+    /////////////////////////////////////////////////////////////////////
+
+    simulated_annealing::simulated_annealing()
+    {
+
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    void simulated_annealing::search(search_context& context)
+    {
+        evaluator& eval = *context.eval;
+        solution& current = *context.current_solution;
+        std::mt19937_64& generator = *context.generator;
+
+        double current_value = current.total_mean_objective_value(context.alpha_objective);
+        double best_value = current_value;
+        double temperature = _initial_temperature * std::abs(current_value);
+
+        std::uniform_int_distribution<int> dist_timeslots(0, nb_timeslots - 1);
+        std::uniform_int_distribution<int> dist_locations(0, nb_locations - 1);
+        std::uniform_real_distribution<double> dist_acceptance(0.0, 1.0);
+
+        // iterations that don't simulate anything (no feasible swap sampled, or all replications reused from the memo)
+        // don't use the budget, so the search also stops when nothing new has been simulated for a while
+        int remaining_budget = context.replication_budget;
+        int iteration = 0;
+        int iterations_without_simulation = 0;
+        while(remaining_budget > 0 && nb_locations > 1 && iterations_without_simulation < _max_iterations_without_simulation)
+        {
+            ++iteration;
+
+            // 1. score random swaps in a random timeslot with the surrogates
+            int timeslot = dist_timeslots(generator);
+            int best_location1 = -1;
+            int best_location2 = -1;
+            double best_prediction = 1e10;
+            for(int k = 0; k < _nb_moves_screened; ++k)
+            {
+                int r1 = dist_locations(generator);
+                int r2 = dist_locations(generator);
+                int event1 = current.timeslot_location(timeslot, r1);
+                int event2 = current.timeslot_location(timeslot, r2);
+                if(r1 == r2 || (event1 < 0 && event2 < 0)
+                        || !get_event_location_possible(event1, r2)
+                        || !get_event_location_possible(event2, r1))
+                    continue;
+
+                current.swap_locations(timeslot, r1, r2);
+                double prediction = eval.predict_objective_value_timeslot(current, timeslot);
+                current.swap_locations(timeslot, r1, r2);
+
+                if(prediction < best_prediction)
+                {
+                    best_prediction = prediction;
+                    best_location1 = r1;
+                    best_location2 = r2;
+                }
+            }
+            if(best_location1 < 0)
+            {
+                ++iterations_without_simulation;
+                continue;
+            }
+
+
+            // 2. simulate the best swap with Menge
+            solution candidate(current);
+            candidate.swap_locations(timeslot, best_location1, best_location2);
+            std::vector<bool> timeslot_changed(nb_timeslots, false);
+            timeslot_changed[timeslot] = true;
+            const std::size_t nb_simulations = eval.nb_simulations();
+            eval.simulate_timeslots(candidate, timeslot_changed, context.nb_replications);
+            if(eval.nb_simulations() > nb_simulations)  // replications that are completely reused from the memo do not use the budget
+            {
+                remaining_budget -= context.nb_replications;
+                iterations_without_simulation = 0;
+            }
+            else
+                ++iterations_without_simulation;
+
+
+            // 3. Metropolis acceptance
+            double candidate_value = candidate.total_mean_objective_value(context.alpha_objective);
+            double deterioration = candidate_value - current_value;
+            if(deterioration < 0
+                    || (temperature > 0 && dist_acceptance(generator) < std::exp(-deterioration / temperature)))
+            {
+                current = candidate;
+                current_value = candidate_value;
+
+                QString output_text = "Iteration ";
+                output_text.append(QString::number(iteration));
+                output_text.append(": move accepted.\nMean objective value: ");
+                output_text.append(QString::number(current_value));
+                context.report_status(output_text);
+
+                if(current_value < best_value)
+                {
+                    best_value = current_value;
+                    context.report_solution(current);
+                }
+            }
+
+            if(iteration % _iterations_per_temperature == 0)
+                temperature *= _cooling_factor;
+        }
+
+        if(iterations_without_simulation >= _max_iterations_without_simulation)
+        {
+            QString output_text = "Simulated annealing stopped: nothing new was simulated in the last ";
+            output_text.append(QString::number(_max_iterations_without_simulation));
+            output_text.append(" iterations.");
+            context.report_status(output_text);
+        }
+    }
+
+}   // namespace timetable
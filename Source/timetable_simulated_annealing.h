@@ -0,0 +1,81 @@
+/*
+ *	Code for the surrogate-based tabu search algorithm
+ *  to optimise people flows in a timetable.
+ *
+ *	Code author: Hendrik Vermuyten
+ */
+
+/*!
+ *	@file		timetable_simulated_annealing.h
+ *  @author     Hendrik Vermuyten
+ *	@brief		Simulated annealing as a search strategy.
+ */
+
+#ifndef TIMETABLE_SIMULATED_ANNEALING_H
+#define TIMETABLE_SIMULATED_ANNEALING_H
+
+#include "timetable_search_strategy.h"
+
+/*!
+ *  @namespace timetable
+ *  @brief	The namespace containing all elements related to the timetable and its optimisation.
+ */
+namespace timetable
+{
+    /*!
+     *	@brief		Simulated annealing with surrogate-screened moves.
+     *
+     *  In every iteration, a number of random swaps in a random timeslot are scored with the surrogates and the best one
+     *  is simulated with Menge. It is accepted if it improves the current solution, or otherwise with a probability that
+     *  decreases with the deterioration and with the temperature.
+     */
+    class simulated_annealing : public search_strategy
+    {
+    public:
+        /*!
+         *	@brief      Default constructor.
+         */
+        simulated_annealing();
+
+        /*!
+         *	@brief      The name of the strategy (for the output).
+         *  @returns    The name.
+         */
+        QString strategy_name() const override { return QStringLiteral("Simulated annealing"); }
+
+        /*!
+         *	@brief      Explore the solution space from the current solution of the context.
+         *  @param      context     The context of the search.
+         */
+        void search(search_context& context) override;
+
+    private:
+        /*!
+         *	@brief      The number of random swaps that are scored with the surrogates in every iteration.
+         */
+        static constexpr int _nb_moves_screened = 20;
+
+        /*!
+         *	@brief      The initial temperature, relative to the objective value of the initial solution.
+         */
+        static constexpr double _initial_temperature = 0.01;
+
+        /*!
+         *	@brief      The factor by which the temperature decreases.
+         */
+        static constexpr double _cooling_factor = 0.95;
+
+        /*!
+         *	@brief      The number of iterations at every temperature.
+         */
+        static constexpr int _iterations_per_temperature = 10;
+
+        /*!
+         *	@brief      The number of consecutive iterations without a new simulation after which the search stops.
+         */
+        static constexpr int _max_iterations_without_simulation = 1000;
+    };
+
+}   // namespace timetable
+
+#endif // TIMETABLE_SIMULATED_ANNEALING_H
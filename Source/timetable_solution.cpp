@@ -6,6 +6,15 @@
 namespace
 {
     const double student_t_values[11] = {0, 12.71, 4.303,  3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228};
+
+    // SplitMix64 mixing function
+    std::uint64_t splitmix64(std::uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
 }
 
 
@@ -30,6 +39,9 @@ namespace timetable
         m_mean_objective_values_travels = other.m_mean_objective_values_travels;
         m_stddev_objective_values_evac = other.m_stddev_objective_values_evac;
         m_stddev_objective_values_travels = other.m_stddev_objective_values_travels;
+
+        m_hash = other.m_hash;
+        m_hash_timeslots = other.m_hash_timeslots;
     }
 
     solution& solution::operator= (const solution& other)
@@ -44,6 +56,9 @@ namespace timetable
         m_stddev_objective_values_evac = other.m_stddev_objective_values_evac;
         m_stddev_objective_values_travels = other.m_stddev_objective_values_travels;
 
+        m_hash = other.m_hash;
+        m_hash_timeslots = other.m_hash_timeslots;
+
         return *this;
     }
 
@@ -102,6 +117,8 @@ namespace timetable
             m_stddev_objective_values_travels.push_back(0);
         }
 
+        calculate_hashes();
+
         m_is_empty = false;
     }
 
@@ -119,6 +136,58 @@ namespace timetable
         m_mean_objective_values_travels.clear();
         m_stddev_objective_values_evac.clear();
         m_stddev_objective_values_travels.clear();
+
+        m_hash = 0;
+        m_hash_timeslots.clear();
+    }
+
+
+
+    void solution::set_event_location(int event, int location)
+    {
+        // Zobrist hashing: remove the key of the old location, add the key of the new location
+        std::uint64_t change = zobrist_key(event, m_events_location[event]) ^ zobrist_key(event, location);
+        m_hash ^= change;
+        int timeslot = m_events_timeslot[event];
+        if(timeslot >= 0 && timeslot < (int)m_hash_timeslots.size())
+            m_hash_timeslots[timeslot] ^= change;
+
+        m_events_location[event] = location;
+    }
+
+    void solution::swap_locations(int timeslot, int location1, int location2)
+    {
+        int event1 = timeslot_location(timeslot, location1);
+        int event2 = timeslot_location(timeslot, location2);
+        if(event1 >= 0)
+            set_event_location(event1, location2);
+        if(event2 >= 0)
+            set_event_location(event2, location1);
+    }
+
+    std::uint64_t solution::hash_timeslot_pair(int first_timeslot) const
+    {
+        // order matters: (t, t+1) differs from (t+1, t)
+        return m_hash_timeslots[first_timeslot] ^ splitmix64(m_hash_timeslots[first_timeslot + 1]);
+    }
+
+    void solution::calculate_hashes()
+    {
+        m_hash = 0;
+        m_hash_timeslots.assign(nb_timeslots, 0);
+        for(int l = 0; l < (int)m_events_location.size(); ++l)
+        {
+            std::uint64_t key = zobrist_key(l, m_events_location[l]);
+            m_hash ^= key;
+            if(m_events_timeslot[l] >= 0 && m_events_timeslot[l] < nb_timeslots)
+                m_hash_timeslots[m_events_timeslot[l]] ^= key;
+        }
+    }
+
+    std::uint64_t solution::zobrist_key(int event, int location)
+    {
+        // the keys are generated on the fly instead of stored in a table of nb_events x nb_locations
+        return splitmix64((static_cast<std::uint64_t>(event) << 32) ^ static_cast<std::uint32_t>(location));
     }
 
 
@@ -16,6 +16,7 @@
 
 #include <QObject>
 #include <vector>
+#include <cstdint>
 #include <QString>
 #include "timetable_global_data.h"
 
@@ -100,10 +101,50 @@ namespace timetable
 
         /*!
          *	@brief		Set the location of a given event.
+         *
+         *  The hashes of the solution and of the timeslot of the event are updated incrementally.
+         *
          *  @param      event       The event for which the location is to be set.
          *  @param      location    The location in which the event will be planned.
          */
-        void set_event_location(int event, int location) { m_events_location[event] = location;}
+        void set_event_location(int event, int location);
+
+        /*!
+         *	@brief		Swap the events (or an event and an empty location) in two locations of a timeslot.
+         *
+         *  A swap is its own inverse.
+         *
+         *  @param      timeslot        The timeslot.
+         *  @param      location1       The first location.
+         *  @param      location2       The second location.
+         */
+        void swap_locations(int timeslot, int location1, int location2);
+
+        /*!
+         *	@brief		Get the (Zobrist) hash of the assignment of all events to locations.
+         *  @returns    The hash of the solution.
+         */
+        std::uint64_t hash() const { return m_hash; }
+
+        /*!
+         *	@brief		Get the (Zobrist) hash of the assignment of the events in a given timeslot to locations.
+         *
+         *  The evacuation time of a timeslot only depends on this assignment.
+         *
+         *  @param      timeslot        The timeslot.
+         *  @returns    The hash of the timeslot.
+         */
+        std::uint64_t hash_timeslot(int timeslot) const { return m_hash_timeslots[timeslot]; }
+
+        /*!
+         *	@brief		Get the hash of the assignment of the events in a given timeslot pair to locations.
+         *
+         *  The travel time between two timeslots only depends on this assignment.
+         *
+         *  @param      first_timeslot        The first timeslot of the timeslot pair.
+         *  @returns    The hash of the timeslot pair.
+         */
+        std::uint64_t hash_timeslot_pair(int first_timeslot) const;
 
         /*!
          *	@brief		Reset the evacuation times for a given timeslot.
@@ -223,6 +264,20 @@ namespace timetable
          */
         const std::vector<double>& stddevs_objective_travels() const { return m_stddev_objective_values_travels; }
 
+        /*!
+         *	@brief		Get the evacuation times of all replications in a given timeslot.
+         *  @param      timeslot     The timeslot.
+         *  @returns    The evacuation times of all replications in the timeslot.
+         */
+        const std::vector<double>& objective_values_evac(int timeslot) const { return m_objective_values_evac[timeslot]; }
+
+        /*!
+         *	@brief		Get the travel times of all replications in a given timeslot pair.
+         *  @param      first_timeslot     The first timeslot of the timeslot pair.
+         *  @returns    The travel times of all replications in the timeslot pair.
+         */
+        const std::vector<double>& objective_values_travels(int first_timeslot) const { return m_objective_values_travels[first_timeslot]; }
+
 
 
     signals:
@@ -282,6 +337,29 @@ namespace timetable
          *  This value is the standard deviation of the predictor for the mean, i.e. s / root(n).
          */
         std::vector<double> m_stddev_objective_values_travels;
+
+        /*!
+         *	@brief		The (Zobrist) hash of the assignment of all events to locations.
+         */
+        std::uint64_t m_hash = 0;
+
+        /*!
+         *	@brief		The (Zobrist) hash of the assignment of the events to locations for every timeslot.
+         */
+        std::vector<std::uint64_t> m_hash_timeslots;
+
+        /*!
+         *	@brief		Calculate the hashes of the solution from scratch.
+         */
+        void calculate_hashes();
+
+        /*!
+         *	@brief		The random key of the assignment of an event to a location.
+         *  @param      event       The event.
+         *  @param      location    The location (-1 if the event is not assigned).
+         *  @returns    The key of the assignment.
+         */
+        static std::uint64_t zobrist_key(int event, int location);
     };
 
 } // namespace timetable
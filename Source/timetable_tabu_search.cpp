@@ -1,14 +1,20 @@
 #include "timetable_tabu_search.h"
+#include "random_streams.h"
 #include <chrono>
 #include <random>
 #include <stdexcept>
+#include <limits>
+#include <queue>
+#include <numeric>
+#include <iterator>
+#include <unordered_set>
+#include <QtConcurrent/QtConcurrent>
+#include <QThread>
 #include <QDebug>
 
 
 namespace
 {
-    std::random_device randdev;
-    std::seed_seq seedseq{ randdev(), randdev(), randdev(), randdev(), randdev(), randdev(), randdev(), randdev() };
     std::mt19937_64 generator;
 
     constexpr double NANO = 1000000000.0;
@@ -160,6 +166,18 @@ namespace
         return stddev;
     }
 
+    // Expected improvement below a reference value of a normally distributed prediction
+    double expected_improvement(double mean, double stddev, double reference)
+    {
+        double improvement = reference - mean;
+        if(stddev < 1e-12)
+            return std::max(improvement, 0.0);
+        double z = improvement / stddev;
+        double pdf = 0.3989422804014327 * std::exp(-0.5 * z * z);
+        double cdf = 0.5 * std::erfc(-z / std::sqrt(2.0));
+        return improvement * cdf + stddev * pdf;
+    }
+
 } // anonymous namespace
 
 
@@ -224,6 +242,19 @@ namespace timetable
         _nb_eval_menge_incremental = _nb_eval_menge_incremental_default;
         _nb_eval_menge_validate = _nb_eval_menge_validate_default;
         _nb_eval_local_minimum = _nb_eval_local_minimum_default;
+        _common_random_numbers = _common_random_numbers_default;
+        _adaptive_timeslot_selection = _adaptive_timeslot_selection_default;
+        _full_neighbourhood_scan = _full_neighbourhood_scan_default;
+        _evaluation_memo = _evaluation_memo_default;
+        _reactive_tabu = _reactive_tabu_default;
+        _pipelined_search = _pipelined_search_default;
+        _online_refinement = _online_refinement_default;
+        _exhaustive_symmetry_pruning = _exhaustive_symmetry_pruning_default;
+        _exhaustive_branch_and_bound = _exhaustive_branch_and_bound_default;
+        _compound_moves = _compound_moves_default;
+        _path_relinking = _path_relinking_default;
+        _search_strategy = _search_strategy_default;
+        _acquisition_function = _acquisition_function_default;
     }
 
 
@@ -238,24 +269,7 @@ namespace timetable
             {
                 size_t nb_possible_moves = 0;
                 for(int t = 0; t < nb_timeslots; ++t)
-                {
-                    for(int r1 = 0; r1 < nb_locations; ++r1)
-                    {
-                        for(int r2 = r1 + 1; r2 < nb_locations; ++r2)
-                        {
-                            // swap room r1 & r2
-                            // get event1 and event2
-                            int event1 = _current_solution.timeslot_location(t, r1);
-                            int event2 = _current_solution.timeslot_location(t, r2);
-
-                            // no empty swap && feasible
-                            if((event1 >= 0 || event2 >= 0)
-                                    && get_event_location_possible(event1, r2)  // is swap feasible?
-                                    && get_event_location_possible(event2, r1))
-                                ++nb_possible_moves;
-                        }
-                    }
-                }
+                    nb_possible_moves += count_feasible_moves(t);
                 if(_tabu_list_length >= nb_possible_moves)
                     throw std::runtime_error("Error in tabu_search. The length of the tabu list ("
                                              + std::to_string(_tabu_list_length) + ") cannot be larger than the number of possible moves("
@@ -266,7 +280,11 @@ namespace timetable
             if(!_surrogate->is_trained())
                 _surrogate->train();
 
-            // 2. Start the tabu search
+            // 2. Seed the random number streams of the search
+            seed_random_streams();
+            initialise_evaluator();
+
+            // 3. Start the tabu search
             tabu_search_method_A();
 
             emit(finished());
@@ -279,6 +297,867 @@ namespace timetable
     }
 
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // RANDOM STREAMS
+    void tabu_search::seed_random_streams()
+    {
+        generator = global::_random_streams.make_generator(global::random_stream::neighbourhood);
+        _menge->reset_replications();
+
+        QString logger_text = "Run-level seed: ";
+        logger_text += QString::number(global::_random_streams.get_seed());
+        if(global::_random_streams.is_random_seed())
+            logger_text += " (randomly drawn)";
+        global::_logger << global::logger::log_type::INFORMATION << logger_text;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // EVALUATION
+    void tabu_search::initialise_evaluator()
+    {
+        _evaluator.set_Menge(_menge);
+        _evaluator.set_surrogate(_surrogate);
+        _evaluator.set_alpha_objective(_alpha_objective);
+        _evaluator.set_timeslots_to_calculate_traveltimes(_timeslots_to_calculate_traveltimes);
+        _evaluator.set_common_random_numbers(_common_random_numbers);
+        _evaluator.set_evaluation_memo(_evaluation_memo);
+        _evaluator.set_online_refinement(_online_refinement);
+        _evaluator.reset();
+    }
+
+    search_context tabu_search::make_search_context()
+    {
+        search_context context;
+        context.eval = &_evaluator;
+        context.current_solution = &_current_solution;
+        context.generator = &generator;
+        context.alpha_objective = _alpha_objective;
+        context.nb_replications = _nb_eval_menge_incremental;
+        context.replication_budget = _replication_budget_tabu_search;
+        context.report_status = [this](const QString& text)
+        {
+            emit(signal_algorithm_status(text));
+            global::_logger << global::logger::log_type::INFORMATION << text;
+        };
+        context.report_solution = [this](const solution& sol)
+        {
+            // a solution of which the confidence interval overlaps with the best solution is a possible best solution
+            if(sol.lower_95_CI_objective_value(_alpha_objective) < _best_solution_upper_95_CI)
+            {
+                _best_solutions.push_back(sol);
+                _best_solution_upper_95_CI = std::min(_best_solution_upper_95_CI, sol.upper_95_CI_objective_value(_alpha_objective));
+
+                QString output_text = "New possible best solution found.\nMean objective value: ";
+                output_text.append(QString::number(sol.total_mean_objective_value(_alpha_objective)));
+                emit(signal_algorithm_status(output_text));
+                emit(new_best_solution_found(sol));
+            }
+        };
+        return context;
+    }
+
+    void tabu_search::search(search_context& context)
+    {
+        // the exploration loop works on the current solution and the generator of the tabu search itself
+        if(context.current_solution != &_current_solution || context.generator != &generator)
+            throw std::runtime_error("Error in function tabu_search::search. \nThe tabu search can only continue from its own current solution and random number generator.");
+        tabu_search_method_A_exploration_loop(context.replication_budget, context.nb_replications);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // PAIRED DIFFERENCES
+    void tabu_search::calculate_paired_difference(const Swap& move, double& mean_difference, double& stddev_mean_difference) const
+    {
+        const int timeslot = move.timeslot;
+        const bool evacuations = (_alpha_objective > 0.01);
+        const bool travels_previous = (_alpha_objective < 0.99 && !move.observations_menge_tt1.empty());
+        const bool travels_current = (_alpha_objective < 0.99 && !move.observations_menge_tt2.empty());
+
+        // number of replications that both solutions have in common
+        size_t nb_pairs = std::numeric_limits<size_t>::max();
+        if(evacuations)
+            nb_pairs = std::min(nb_pairs, std::min(move.observations_menge_evac.size(), _current_solution.objective_values_evac(timeslot).size()));
+        if(travels_previous)
+            nb_pairs = std::min(nb_pairs, std::min(move.observations_menge_tt1.size(), _current_solution.objective_values_travels(timeslot-1).size()));
+        if(travels_current)
+            nb_pairs = std::min(nb_pairs, std::min(move.observations_menge_tt2.size(), _current_solution.objective_values_travels(timeslot).size()));
+        if(nb_pairs == std::numeric_limits<size_t>::max())
+            nb_pairs = 0;
+
+        // difference in objective value (candidate - current) for every replication
+        std::vector<double> differences;
+        differences.reserve(nb_pairs);
+        for(size_t j = 0; j < nb_pairs; ++j)
+        {
+            double difference = 0.0;
+            if(evacuations)
+                difference += _alpha_objective * (move.observations_menge_evac[j] - _current_solution.objective_values_evac(timeslot)[j]);
+            if(travels_previous)
+                difference += (1-_alpha_objective) * (move.observations_menge_tt1[j] - _current_solution.objective_values_travels(timeslot-1)[j]);
+            if(travels_current)
+                difference += (1-_alpha_objective) * (move.observations_menge_tt2[j] - _current_solution.objective_values_travels(timeslot)[j]);
+            differences.push_back(difference);
+        }
+
+        mean_difference = calculate_mean(differences);
+        stddev_mean_difference = calculate_stddev_estimator_observations(differences, mean_difference);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // TIMESLOT SELECTION
+    int tabu_search::count_feasible_moves(int timeslot) const
+    {
+        int nb_moves = 0;
+        for(int r1 = 0; r1 < nb_locations; ++r1)
+        {
+            for(int r2 = r1 + 1; r2 < nb_locations; ++r2)
+            {
+                // swap room r1 & r2
+                // get event1 and event2
+                int event1 = _current_solution.timeslot_location(timeslot, r1);
+                int event2 = _current_solution.timeslot_location(timeslot, r2);
+
+                // no empty swap && feasible
+                if((event1 >= 0 || event2 >= 0)
+                        && get_event_location_possible(event1, r2)  // is swap feasible?
+                        && get_event_location_possible(event2, r1))
+                    ++nb_moves;
+            }
+        }
+        return nb_moves;
+    }
+
+    void tabu_search::initialise_timeslot_selection()
+    {
+        _timeslot_nb_moves.assign(nb_timeslots, 0);
+        _timeslot_nb_moves_hash.assign(nb_timeslots, 0);
+        _timeslot_nb_selected.assign(nb_timeslots, 0);
+        _timeslot_reward.assign(nb_timeslots, 0.0);
+        _timeslot_max_reward = 0.0;
+
+        for(int t = 0; t < nb_timeslots; ++t)
+        {
+            _timeslot_nb_moves[t] = count_feasible_moves(t);
+            _timeslot_nb_moves_hash[t] = _current_solution.hash_timeslot(t);
+        }
+    }
+
+    void tabu_search::refresh_timeslot_nb_moves()
+    {
+        for(int t = 0; t < nb_timeslots; ++t)
+        {
+            if(_timeslot_nb_moves_hash[t] == _current_solution.hash_timeslot(t))
+                continue;
+            _timeslot_nb_moves[t] = count_feasible_moves(t);
+            _timeslot_nb_moves_hash[t] = _current_solution.hash_timeslot(t);
+        }
+    }
+
+    int tabu_search::select_timeslot()
+    {
+        // the current solution may have changed since the last selection (e.g. by the move made while the next timeslot
+        // is selected for the pipelined search, or by a diversification kick)
+        refresh_timeslot_nb_moves();
+
+        // timeslots without feasible moves are never selected
+        std::vector<int> eligible_timeslots;
+        eligible_timeslots.reserve(nb_timeslots);
+        for(int t = 0; t < nb_timeslots; ++t)
+            if(_timeslot_nb_moves[t] > 0)
+                eligible_timeslots.push_back(t);
+
+        if(eligible_timeslots.empty())
+            throw std::runtime_error("Error in tabu_search::select_timeslot. There are no feasible moves in any timeslot.");
+
+        if(!_adaptive_timeslot_selection)
+        {
+            std::uniform_int_distribution<int> dist_timeslots(0, eligible_timeslots.size() - 1);
+            return eligible_timeslots[dist_timeslots(generator)];
+        }
+
+        // every timeslot is tried once first
+        std::vector<int> untried_timeslots;
+        int total_nb_selected = 0;
+        for(int t : eligible_timeslots)
+        {
+            if(_timeslot_nb_selected[t] == 0)
+                untried_timeslots.push_back(t);
+            total_nb_selected += _timeslot_nb_selected[t];
+        }
+        if(!untried_timeslots.empty())
+        {
+            std::uniform_int_distribution<int> dist_timeslots(0, untried_timeslots.size() - 1);
+            return untried_timeslots[dist_timeslots(generator)];
+        }
+
+        // UCB1: (scaled) improvement per replication + exploration bonus
+        int best_timeslot = eligible_timeslots.front();
+        double best_score = -1e10;
+        const double scale = std::max(_timeslot_max_reward, 1e-9);
+        for(int t : eligible_timeslots)
+        {
+            double score = _timeslot_reward[t] / scale
+                    + std::sqrt(2.0 * std::log((double)total_nb_selected) / _timeslot_nb_selected[t]);
+            if(score > best_score)
+            {
+                best_score = score;
+                best_timeslot = t;
+            }
+        }
+        return best_timeslot;
+    }
+
+    void tabu_search::update_timeslot_selection(int timeslot, double improvement, int replications)
+    {
+        refresh_timeslot_nb_moves();
+
+        // recency-weighted mean of the improvement per replication,
+        // since the potential of a timeslot decreases as it is optimised
+        double reward = std::max(improvement, 0.0) / std::max(replications, 1);
+        ++_timeslot_nb_selected[timeslot];
+        double step = 1.0 / _timeslot_nb_selected[timeslot];
+        if(step < _timeslot_reward_step_size)
+            step = _timeslot_reward_step_size;
+        _timeslot_reward[timeslot] += step * (reward - _timeslot_reward[timeslot]);
+        _timeslot_max_reward = std::max(_timeslot_max_reward, reward);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // TABU LIST
+    bool tabu_search::is_tabu(const Swap& move) const
+    {
+        // only the last _tabu_tenure moves are tabu
+        int nb_tabu = std::min((int)_tabu_list.size(), _tabu_tenure);
+        for(auto it = _tabu_list.rbegin(); it != _tabu_list.rbegin() + nb_tabu; ++it)
+        {
+            if(*it == move)
+                return true;
+        }
+        return false;
+    }
+
+    void tabu_search::add_tabu_move(const Swap& move)
+    {
+        _tabu_list.push_back(move);
+
+        // moves older than the maximum tenure can never become tabu again
+        while((int)_tabu_list.size() > std::max(_tabu_tenure, _tabu_tenure_max))
+            _tabu_list.pop_front();
+    }
+
+    void tabu_search::apply_move(solution& sol, const Swap& move) const
+    {
+        if(move.location3 < 0)
+        {
+            sol.swap_locations(move.timeslot, move.location1, move.location2);
+        }
+        else
+        {
+            int event1 = sol.timeslot_location(move.timeslot, move.location1);
+            int event2 = sol.timeslot_location(move.timeslot, move.location2);
+            int event3 = sol.timeslot_location(move.timeslot, move.location3);
+            if(event1 >= 0)
+                sol.set_event_location(event1, move.location2);
+            if(event2 >= 0)
+                sol.set_event_location(event2, move.location3);
+            if(event3 >= 0)
+                sol.set_event_location(event3, move.location1);
+        }
+    }
+
+    void tabu_search::undo_move(solution& sol, const Swap& move) const
+    {
+        // a swap is its own inverse
+        if(move.location3 < 0)
+        {
+            apply_move(sol, move);
+            return;
+        }
+
+        // rotate the events back
+        int event1 = sol.timeslot_location(move.timeslot, move.location2);
+        int event2 = sol.timeslot_location(move.timeslot, move.location3);
+        int event3 = sol.timeslot_location(move.timeslot, move.location1);
+        if(event1 >= 0)
+            sol.set_event_location(event1, move.location1);
+        if(event2 >= 0)
+            sol.set_event_location(event2, move.location2);
+        if(event3 >= 0)
+            sol.set_event_location(event3, move.location3);
+    }
+
+    void tabu_search::initialise_tabu_tenure(int nb_possible_moves)
+    {
+        _tabu_list.clear();
+        _tabu_tenure = _tabu_list_length;
+        _tabu_tenure_max = _tabu_list_length;
+
+        if(_reactive_tabu)
+        {
+            // the tenure is bounded such that there are always moves that are not tabu
+            _tabu_tenure_max = std::max(_tabu_list_length, nb_possible_moves / 2);
+            _visited_solutions.clear();
+            _visited_solutions[_current_solution.hash()].nb_visits = 1;
+            _last_tenure_change = 0;
+            _mean_cycle_length = _tabu_list_length;
+            _nb_chaotic_solutions = 0;
+        }
+    }
+
+    bool tabu_search::update_reactive_tabu_tenure(int iteration)
+    {
+        auto it = _visited_solutions.find(_current_solution.hash());
+        if(it != _visited_solutions.end())
+        {
+            // the solution is repeated: a cycle of length cycle_length
+            int cycle_length = iteration - it->second.last_iteration;
+            it->second.last_iteration = iteration;
+            ++it->second.nb_visits;
+
+            // escape if too many solutions are repeated often
+            if(it->second.nb_visits > _reactive_max_repetitions)
+            {
+                ++_nb_chaotic_solutions;
+                if(_nb_chaotic_solutions > _reactive_max_chaotic_solutions)
+                {
+                    _nb_chaotic_solutions = 0;
+                    _visited_solutions.clear();
+                    return true;
+                }
+            }
+
+            // short cycle: increase the tenure
+            if(cycle_length < 2 * _tabu_tenure_max)
+            {
+                _mean_cycle_length = 0.1 * cycle_length + 0.9 * _mean_cycle_length;
+                _tabu_tenure = std::min(_tabu_tenure_max, std::max(_tabu_tenure + 1, (int)(_tabu_tenure * _tabu_tenure_increase)));
+                _last_tenure_change = iteration;
+            }
+        }
+        else
+        {
+            visited_solution& visit = _visited_solutions[_current_solution.hash()];
+            visit.last_iteration = iteration;
+            visit.nb_visits = 1;
+
+            // no cycles for a while: decrease the tenure
+            if(iteration - _last_tenure_change > _mean_cycle_length)
+            {
+                _tabu_tenure = std::max(1, std::min(_tabu_tenure - 1, (int)(_tabu_tenure * _tabu_tenure_decrease)));
+                _last_tenure_change = iteration;
+            }
+        }
+
+        return false;
+    }
+
+    bool tabu_search::diversification_kick(int& remaining_budget, int nb_replications)
+    {
+        // random walk with a length proportional to the mean cycle length
+        int nb_steps = 1 + (int)(_mean_cycle_length / 2);
+        std::vector<bool> timeslot_changed(nb_timeslots, false);
+        std::uniform_int_distribution<int> dist_timeslots(0, nb_timeslots - 1);
+        for(int step = 0; step < nb_steps; ++step)
+        {
+            std::vector<Swap> moves;
+            int timeslot = dist_timeslots(generator);
+            for(int r1 = 0; r1 < nb_locations; ++r1)
+            {
+                for(int r2 = r1 + 1; r2 < nb_locations; ++r2)
+                {
+                    int event1 = _current_solution.timeslot_location(timeslot, r1);
+                    int event2 = _current_solution.timeslot_location(timeslot, r2);
+                    if((event1 >= 0 || event2 >= 0)
+                            && get_event_location_possible(event1, r2)
+                            && get_event_location_possible(event2, r1))
+                    {
+                        Swap swap;
+                        swap.timeslot = timeslot;
+                        swap.location1 = r1;
+                        swap.location2 = r2;
+                        moves.push_back(swap);
+                    }
+                }
+            }
+            if(moves.empty())
+                continue;
+
+            std::uniform_int_distribution<int> dist_moves(0, moves.size() - 1);
+            const Swap& move = moves[dist_moves(generator)];
+            apply_move(_current_solution, move);
+
+            // the moves of the random walk are tabu as well
+            add_tabu_move(move);
+            timeslot_changed[timeslot] = true;
+        }
+
+
+        // evaluate the changed timeslots (and timeslot pairs) with Menge
+        std::vector<bool> evac_changed(nb_timeslots, false);
+        std::vector<bool> travels_changed(nb_timeslots, false);
+        for(int t = 0; t < nb_timeslots; ++t)
+            evac_changed[t] = (_alpha_objective > 0.01 && timeslot_changed[t]);
+        if(_alpha_objective < 0.99)
+        {
+            for(int t : _timeslots_to_calculate_traveltimes)
+                travels_changed[t] = (timeslot_changed[t] || timeslot_changed[t+1]);
+        }
+
+        for(int t = 0; t < nb_timeslots; ++t)
+        {
+            if(evac_changed[t])
+                _current_solution.reset_objective_values_evac(t);
+            if(travels_changed[t])
+                _current_solution.reset_objective_values_travels(t);
+        }
+        for(int j = 0; j < nb_replications; ++j)
+        {
+            const std::size_t nb_simulations_replication = _evaluator.nb_simulations();
+
+            for(int t = 0; t < nb_timeslots; ++t)
+            {
+                if(evac_changed[t])
+                    _current_solution.add_objective_value_evac(t, _evaluator.simulate_evacuation(_current_solution, t, j));
+                if(travels_changed[t])
+                    _current_solution.add_objective_value_travels(t, _evaluator.simulate_travels(_current_solution, t, j));
+            }
+
+            if(_evaluator.nb_simulations() > nb_simulations_replication)
+                --remaining_budget;
+            if(remaining_budget <= 0)
+                return false;
+        }
+        for(int t = 0; t < nb_timeslots; ++t)
+        {
+            if(evac_changed[t])
+                _current_solution.calculate_means_and_stddevs_evac(t);
+            if(travels_changed[t])
+                _current_solution.calculate_means_and_stddevs_travels(t);
+        }
+
+        return true;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // NEIGHBOURHOOD EVALUATION WITH THE SURROGATES
+    void tabu_search::score_moves_timeslot(solution& sol, int timeslot, bool keep_all_moves, size_t nb_moves_kept, std::vector<Swap>& moves) const
+    {
+        std::priority_queue<double> objective_values_kept; // max-heap: top is the worst objective value that is kept
+
+        // with an acquisition function, more moves are preselected on the surrogate prediction and then reranked
+        const bool use_acquisition = (_acquisition_function != acquisition_function::surrogate_prediction);
+        const size_t nb_moves_preselected = use_acquisition ? nb_moves_kept * _acquisition_preselection_factor : nb_moves_kept;
+
+        // the evacuation time after each swap is updated from the prediction for the current solution
+        ml::swap_prediction_cache swap_cache;
+        if(_alpha_objective > 0.01)
+            swap_cache = _surrogate->prepare_evacuation_time_swaps(sol, timeslot);
+
+        // lower bound on the travel terms, so that a swap that cannot be kept is discarded without predicting its travel times
+        double lower_bound_travels = 0.0;
+        if(_alpha_objective < 0.99)
+        {
+            int nb_travel_terms = (timeslot > 0 ? 1 : 0) + (timeslot < nb_timeslots - 1 ? 1 : 0);
+            if(nb_travel_terms > 0)
+                lower_bound_travels = (1-_alpha_objective) * nb_travel_terms * _surrogate->lower_bound_travel_time();
+        }
+
+        // keep track of the objective values of the moves that are kept
+        auto keep_objective_value = [&](double value)
+        {
+            if(keep_all_moves)
+                return;
+            if(objective_values_kept.size() < nb_moves_preselected)
+                objective_values_kept.push(value);
+            else if(value < objective_values_kept.top())
+            {
+                objective_values_kept.pop();
+                objective_values_kept.push(value);
+            }
+        };
+
+        const size_t first_move = moves.size();
+        for(int r1 = 0; r1 < nb_locations; ++r1)
+        {
+            for(int r2 = r1 + 1; r2 < nb_locations; ++r2)
+            {
+                // swap room r1 & r2
+                // get event1 and event2
+                int event1 = sol.timeslot_location(timeslot, r1);
+                int event2 = sol.timeslot_location(timeslot, r2);
+
+                // no empty swap && feasible
+                if((event1 >= 0 || event2 >= 0)
+                        && get_event_location_possible(event1, r2)  // is swap feasible?
+                        && get_event_location_possible(event2, r1))
+                {
+                    Swap swap;
+                    swap.timeslot = timeslot;
+                    swap.location1 = r1;
+                    swap.location2 = r2;
+                    swap.obj_value_surrogate = 0.0;
+
+                    // calculate the objective value
+                    {
+                        // evacuations
+                        if(_alpha_objective > 0.01)
+                        {
+                            swap.obj_value_surrogate += _alpha_objective * _surrogate->predict_evacuation_time_swap(swap_cache, r1, r2);
+                        }
+                        // travels
+                        if(_alpha_objective < 0.99)
+                        {
+                            // discard the swap if it cannot be better than the moves that are kept
+                            if(!keep_all_moves && objective_values_kept.size() >= nb_moves_preselected
+                                    && swap.obj_value_surrogate + lower_bound_travels >= objective_values_kept.top())
+                                continue;
+
+                            // do the swap
+                            if(event1 >= 0)
+                                sol.set_event_location(event1, r2);
+                            if(event2 >= 0)
+                                sol.set_event_location(event2, r1);
+
+                            // from t-1 to t
+                            if(timeslot > 0)
+                            {
+                                swap.obj_value_surrogate += (1-_alpha_objective) * _surrogate->predict_travel_time(sol, timeslot - 1);
+                            }
+
+                            // from t to t+1
+                            if(timeslot < nb_timeslots - 1)
+                            {
+                                swap.obj_value_surrogate += (1-_alpha_objective) * _surrogate->predict_travel_time(sol, timeslot);
+                            }
+
+                            // reverse the swap
+                            if(event1 >= 0)
+                                sol.set_event_location(event1, r1);
+                            if(event2 >= 0)
+                                sol.set_event_location(event2, r2);
+                        }
+
+                    }
+
+
+                    // keep track of the objective values of the moves that are kept
+                    keep_objective_value(swap.obj_value_surrogate);
+
+
+                    // put candidate swap in vector
+                    swap.acquisition = swap.obj_value_surrogate;
+                    moves.push_back(swap);
+                }
+
+
+            }
+        }
+
+
+        // compound moves: the best swaps are extended with a third location (ejection chains)
+        if(_compound_moves && moves.size() > first_move)
+        {
+            std::vector<Swap> seeds(moves.begin() + first_move, moves.end());
+            size_t nb_seeds = std::min(seeds.size(), static_cast<size_t>(_compound_moves_nb_seeds));
+            std::partial_sort(seeds.begin(), seeds.begin() + nb_seeds, seeds.end(),
+                              [](const Swap& s1, const Swap& s2) { return s1.obj_value_surrogate < s2.obj_value_surrogate; });
+
+            // the same rotation can be reached from several swaps: identify it by its rotation that starts in the smallest location
+            std::unordered_set<long long> cycles_scored;
+            auto cycle_key = [](int a, int b, int c)
+            {
+                while(a > b || a > c)
+                {
+                    int tmp = a; a = b; b = c; c = tmp;
+                }
+                return ((long long)a * nb_locations + b) * nb_locations + c;
+            };
+
+            for(size_t s = 0; s < nb_seeds; ++s)
+            {
+                for(int direction = 0; direction < 2; ++direction)
+                {
+                    int r1 = (direction == 0) ? seeds[s].location1 : seeds[s].location2;
+                    int r2 = (direction == 0) ? seeds[s].location2 : seeds[s].location1;
+                    for(int r3 = 0; r3 < nb_locations; ++r3)
+                    {
+                        if(r3 == r1 || r3 == r2)
+                            continue;
+
+                        // the event in r1 moves to r2, the one in r2 to r3 and the one in r3 to r1
+                        // at least two events have to move, otherwise the move is a swap
+                        int event1 = sol.timeslot_location(timeslot, r1);
+                        int event2 = sol.timeslot_location(timeslot, r2);
+                        int event3 = sol.timeslot_location(timeslot, r3);
+                        if((event1 >= 0) + (event2 >= 0) + (event3 >= 0) < 2
+                                || !get_event_location_possible(event1, r2)
+                                || !get_event_location_possible(event2, r3)
+                                || !get_event_location_possible(event3, r1))
+                            continue;
+                        if(!cycles_scored.insert(cycle_key(r1, r2, r3)).second)
+                            continue;
+
+                        Swap cycle;
+                        cycle.timeslot = timeslot;
+                        cycle.location1 = r1;
+                        cycle.location2 = r2;
+                        cycle.location3 = r3;
+                        cycle.obj_value_surrogate = 0.0;
+
+                        // evacuations
+                        if(_alpha_objective > 0.01)
+                            cycle.obj_value_surrogate += _alpha_objective * _surrogate->predict_evacuation_time_cycle(swap_cache, r1, r2, r3);
+
+                        // travels
+                        if(_alpha_objective < 0.99)
+                        {
+                            if(!keep_all_moves && objective_values_kept.size() >= nb_moves_preselected
+                                    && cycle.obj_value_surrogate + lower_bound_travels >= objective_values_kept.top())
+                                continue;
+
+                            apply_move(sol, cycle);
+                            if(timeslot > 0)
+                                cycle.obj_value_surrogate += (1-_alpha_objective) * _surrogate->predict_travel_time(sol, timeslot - 1);
+                            if(timeslot < nb_timeslots - 1)
+                                cycle.obj_value_surrogate += (1-_alpha_objective) * _surrogate->predict_travel_time(sol, timeslot);
+                            undo_move(sol, cycle);
+                        }
+
+                        keep_objective_value(cycle.obj_value_surrogate);
+                        cycle.acquisition = cycle.obj_value_surrogate;
+                        moves.push_back(cycle);
+                    }
+                }
+            }
+        }
+
+
+        // select the best moves only
+        if(!keep_all_moves && moves.size() > nb_moves_preselected)
+        {
+            std::nth_element(moves.begin(), moves.begin() + nb_moves_preselected, moves.end());
+            moves.resize(nb_moves_preselected);
+        }
+
+        // surrogate objective value of the timeslot(s) in the current solution
+        double current_value = 0.0;
+        if(!moves.empty())
+        {
+            if(_alpha_objective > 0.01)
+                current_value += _alpha_objective * swap_cache.prediction;
+            if(_alpha_objective < 0.99)
+            {
+                if(timeslot > 0)
+                    current_value += (1-_alpha_objective) * _surrogate->predict_travel_time(sol, timeslot - 1);
+                if(timeslot < nb_timeslots - 1)
+                    current_value += (1-_alpha_objective) * _surrogate->predict_travel_time(sol, timeslot);
+            }
+        }
+        for(auto&& swap : moves)
+            swap.delta_obj_value_surrogate = swap.obj_value_surrogate - current_value;
+
+        // rerank the preselected moves with the predictive variance of the surrogates
+        if(use_acquisition && !moves.empty())
+        {
+            for(auto&& swap : moves)
+                swap.acquisition = acquisition_value(sol, swap, current_value);
+
+            if(!keep_all_moves && moves.size() > nb_moves_kept)
+            {
+                std::nth_element(moves.begin(), moves.begin() + nb_moves_kept, moves.end());
+                moves.resize(nb_moves_kept);
+            }
+        }
+
+        // rank the moves on their change of the objective value, such that the moves of different timeslots
+        // (full neighbourhood scan) are compared on their improvement instead of the value of their own timeslot
+        // (the expected improvement is relative to the current value already)
+        if(_acquisition_function != acquisition_function::expected_improvement)
+            for(auto&& swap : moves)
+                swap.acquisition -= current_value;
+    }
+
+    double tabu_search::acquisition_value(solution& sol, const Swap& swap, double current_value) const
+    {
+        // do the move
+        apply_move(sol, swap);
+
+        // the predictions of the evacuation time and the travel times are treated as independent
+        double variance = 0.0;
+        if(_alpha_objective > 0.01)
+            variance += _alpha_objective * _alpha_objective * _surrogate->predictive_variance_evacuation_time(sol, swap.timeslot);
+        if(_alpha_objective < 0.99)
+        {
+            if(swap.timeslot > 0)
+                variance += (1-_alpha_objective) * (1-_alpha_objective) * _surrogate->predictive_variance_travel_time(sol, swap.timeslot - 1);
+            if(swap.timeslot < nb_timeslots - 1)
+                variance += (1-_alpha_objective) * (1-_alpha_objective) * _surrogate->predictive_variance_travel_time(sol, swap.timeslot);
+        }
+
+        // reverse the move
+        undo_move(sol, swap);
+
+        double stddev = std::sqrt(variance);
+        if(_acquisition_function == acquisition_function::lower_confidence_bound)
+            return swap.obj_value_surrogate - _lower_confidence_bound_kappa * stddev;
+        else if(_acquisition_function == acquisition_function::expected_improvement)
+            return -expected_improvement(swap.obj_value_surrogate, stddev, current_value);
+        return swap.obj_value_surrogate;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // PIPELINED SEARCH
+    std::uint64_t tabu_search::neighbourhood_hash(const solution& sol, int timeslot) const
+    {
+        // the evacuation time depends on timeslot t, the travel times on the timeslot pairs (t-1,t) and (t,t+1)
+        std::uint64_t hash = sol.hash_timeslot(timeslot);
+        if(timeslot > 0)
+            hash ^= sol.hash_timeslot(timeslot - 1) * 0x9E3779B97F4A7C15ULL;
+        if(timeslot < nb_timeslots - 1)
+            hash ^= sol.hash_timeslot(timeslot + 1) * 0xC2B2AE3D27D4EB4FULL;
+        return hash;
+    }
+
+    bool tabu_search::take_scored_timeslot(int timeslot, bool keep_all_moves, size_t nb_moves_kept, std::vector<Swap>& moves)
+    {
+        std::uint64_t hash = neighbourhood_hash(_current_solution, timeslot);
+        for(auto&& scored : _scored_timeslots)
+        {
+            if(scored.timeslot == timeslot && scored.hash == hash && scored.surrogate_version == _surrogate->surrogate_version()
+                    && scored.keep_all_moves == keep_all_moves && scored.nb_moves_kept == nb_moves_kept)
+            {
+                if(scored.pending)
+                {
+                    scored.moves = scored.future.result();
+                    scored.future = QFuture<std::vector<Swap>>();
+                    scored.pending = false;
+                }
+                moves = scored.moves;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void tabu_search::store_scored_timeslot(int timeslot, bool keep_all_moves, size_t nb_moves_kept, const std::vector<Swap>& moves)
+    {
+        std::uint64_t hash = neighbourhood_hash(_current_solution, timeslot);
+        for(auto&& scored : _scored_timeslots)
+        {
+            if(scored.timeslot == timeslot && scored.hash == hash && scored.surrogate_version == _surrogate->surrogate_version()
+                    && scored.keep_all_moves == keep_all_moves && scored.nb_moves_kept == nb_moves_kept)
+                return;
+        }
+
+        scored_timeslot scored;
+        scored.timeslot = timeslot;
+        scored.hash = hash;
+        scored.surrogate_version = _surrogate->surrogate_version();
+        scored.keep_all_moves = keep_all_moves;
+        scored.nb_moves_kept = nb_moves_kept;
+        scored.moves = moves;
+        _scored_timeslots.push_back(scored);
+    }
+
+    void tabu_search::speculate_scored_timeslot(int timeslot, bool keep_all_moves, size_t nb_moves_kept)
+    {
+        std::uint64_t hash = neighbourhood_hash(_current_solution, timeslot);
+        for(auto&& scored : _scored_timeslots)
+        {
+            if(scored.timeslot == timeslot && scored.hash == hash && scored.surrogate_version == _surrogate->surrogate_version()
+                    && scored.keep_all_moves == keep_all_moves && scored.nb_moves_kept == nb_moves_kept)
+                return; // already scored (or being scored)
+        }
+
+        scored_timeslot scored;
+        scored.timeslot = timeslot;
+        scored.hash = hash;
+        scored.surrogate_version = _surrogate->surrogate_version();
+        scored.keep_all_moves = keep_all_moves;
+        scored.nb_moves_kept = nb_moves_kept;
+        scored.pending = true;
+
+        // the scoring works on its own copy of the solution after the move
+        solution sol = _current_solution;
+        scored.future = QtConcurrent::run([this, sol, timeslot, keep_all_moves, nb_moves_kept]()
+        {
+            solution sol_scoring = sol;
+            std::vector<Swap> moves;
+            score_moves_timeslot(sol_scoring, timeslot, keep_all_moves, nb_moves_kept, moves);
+            return moves;
+        });
+        _scored_timeslots.push_back(scored);
+    }
+
+    void tabu_search::prune_scored_timeslots()
+    {
+        // speculative scorings of moves that were not accepted, or with surrogates that were replaced since (online
+        // learning), are left to finish in the background
+        std::vector<scored_timeslot> scored_timeslots;
+        for(auto&& scored : _scored_timeslots)
+        {
+            if(scored.hash == neighbourhood_hash(_current_solution, scored.timeslot)
+                    && scored.surrogate_version == _surrogate->surrogate_version())
+                scored_timeslots.push_back(scored);
+            else if(scored.pending)
+                _discarded_scorings.push_back(scored.future);
+        }
+        _scored_timeslots.swap(scored_timeslots);
+
+        _discarded_scorings.erase(std::remove_if(_discarded_scorings.begin(), _discarded_scorings.end(),
+                                                 [](const QFuture<std::vector<Swap>>& future) { return future.isFinished(); }),
+                                  _discarded_scorings.end());
+    }
+
+    void tabu_search::clear_scored_timeslots()
+    {
+        // the scorings use the surrogates, so they must be finished before the surrogates can change
+        for(auto&& scored : _scored_timeslots)
+            if(scored.pending)
+                scored.future.waitForFinished();
+        for(auto&& future : _discarded_scorings)
+            future.waitForFinished();
+
+        _scored_timeslots.clear();
+        _discarded_scorings.clear();
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // ONLINE REFINEMENT
+    bool tabu_search::update_online_refinement()
+    {
+        bool installed = false;
+        if(_surrogate->is_refinement_finished())
+        {
+            // no scorings may use the surrogates while they are replaced, and the old scores are outdated
+            clear_scored_timeslots();
+            _surrogate->install_refinement();
+            installed = true;
+        }
+
+        if(!_surrogate->is_refinement_running()
+                && _surrogate->nb_observations_added() >= (size_t)_online_refinement_min_observations)
+            _surrogate->start_refinement();
+
+        return installed;
+    }
+
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     // RESET
@@ -326,40 +1205,7 @@ namespace timetable
         emit(signal_algorithm_status(output_text));
 
         // 1. analyze start solution
-        if(_alpha_objective > 0.01) // evacuations
-        {
-            for(int t = 0; t < nb_timeslots; ++t)
-            {
-                for(int replication = 0; replication < _nb_eval_menge_incremental; ++replication)
-                {
-                    double evactt = _menge->max_sim_duration();
-                    int again = 0;
-                    do { // if simulation gets stuck, recalculate
-                        evactt = _menge->calculate_evacuation_time(_current_solution, t);
-                        ++again;
-                    } while (evactt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
-                    _current_solution.add_objective_value_evac(t,evactt);
-                }
-                _current_solution.calculate_means_and_stddevs_evac(t);
-            }
-        }
-        if(_alpha_objective < 0.99) // travel times
-        {
-            for(int t : _timeslots_to_calculate_traveltimes)
-            {
-                for(int replication = 0; replication < _nb_eval_menge_incremental; ++replication)
-                {
-                    double traveltt = _menge->max_sim_duration();
-                    int again = 0;
-                    do { // if simulation gets stuck, recalculate
-                        traveltt = _menge->calculate_flows_time(_current_solution, t);
-                        ++again;
-                    } while (traveltt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
-                    _current_solution.add_objective_value_travels(t,traveltt);
-                }
-                _current_solution.calculate_means_and_stddevs_travels(t);
-            }
-        }
+        _evaluator.simulate_solution(_current_solution, _nb_eval_menge_incremental);
 
         _best_solutions.push_back(_current_solution);
         _best_solution_upper_95_CI = _current_solution.upper_95_CI_objective_value(_alpha_objective);
@@ -381,8 +1227,34 @@ namespace timetable
 
 
 
-        // Tabu Search (exploration step)
-        tabu_search_method_A_exploration_loop();
+        // Exploration step with the selected search strategy
+        {
+            search_strategy *strategy = this;
+            if(_search_strategy == search_strategy_type::simulated_annealing)
+                strategy = &_simulated_annealing;
+
+            output_text = "Exploration with strategy: ";
+            output_text.append(strategy->strategy_name());
+            emit(signal_algorithm_status(output_text));
+            global::_logger << global::logger::log_type::INFORMATION << output_text;
+
+            search_context context = make_search_context();
+            strategy->search(context);
+
+            logger_text = "Simulations with Menge,";
+            logger_text += QString::number(_evaluator.nb_simulations());
+            logger_text += ",Simulations reused from the memo,";
+            logger_text += QString::number(_evaluator.nb_reused_simulations());
+            global::_logger << global::logger::log_type::INFORMATION << logger_text;
+        }
+        clear_scored_timeslots();
+        if(_online_refinement)
+            _surrogate->install_refinement();
+
+
+        // Path relinking (intensification step)
+        if(_path_relinking)
+            path_relinking();
 
 
 
@@ -672,7 +1544,7 @@ namespace timetable
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    void tabu_search::tabu_search_method_A_exploration_loop()
+    void tabu_search::tabu_search_method_A_exploration_loop(int replication_budget, int nb_replications)
     {
         constexpr int iterations_analyze_performance[3] = { 1, 10, 100 };
         QString output_text;
@@ -681,13 +1553,23 @@ namespace timetable
         std::vector<Swap> candidate_moves;
         candidate_moves.reserve(nb_locations*(nb_locations-1)/2);
 
-        _tabu_list.clear();
-        _tabu_list.reserve(_tabu_list_length);
-        for(int i = 0; i < _tabu_list_length; ++i)
-            _tabu_list.push_back(Swap());
-
         int iteration = 0;
-        int remaining_budget_tabu_search = _replication_budget_tabu_search;
+        int remaining_budget_tabu_search = replication_budget;
+        int next_timeslot = -1; // timeslot of the next iteration if already selected for speculative scoring
+
+        // all moves are kept in the iterations in which the performance of the surrogates is analysed
+        auto keep_all_moves_iteration = [&](int it) {
+            return _analyze_performance
+                    && (it == iterations_analyze_performance[0]
+                        || it == iterations_analyze_performance[1]
+                        || it == iterations_analyze_performance[2]);
+        };
+
+        clear_scored_timeslots();
+        initialise_timeslot_selection();
+        initialise_tabu_tenure(std::accumulate(_timeslot_nb_moves.begin(), _timeslot_nb_moves.end(), 0));
+        if(_acquisition_function != acquisition_function::surrogate_prediction)
+            _surrogate->prepare_predictive_variance();
 
 
         global::_logger << global::logger::log_type::INFORMATION;
@@ -703,77 +1585,72 @@ namespace timetable
 
             // select a timeslot and generate all possible moves for that timeslot
             candidate_moves.clear();
-            std::uniform_int_distribution<int> dist_timeslots(0,nb_timeslots-1);
-            int timeslot = dist_timeslots(generator);
-            for(int r1 = 0; r1 < nb_locations; ++r1)
+            int timeslot = -1;
+            if(!_full_neighbourhood_scan)
+                timeslot = (next_timeslot >= 0) ? next_timeslot : select_timeslot();
+            next_timeslot = -1;
+            const int remaining_budget_start_iteration = remaining_budget_tabu_search;
+            const double obj_start_iteration = _current_solution.total_mean_objective_value(_alpha_objective);
+
+            // only the best moves are kept: enough to evaluate the best candidates and still find a move that is not tabu
+            // (all moves are needed if the performance of the surrogates is analysed in this iteration)
+            const bool keep_all_moves = keep_all_moves_iteration(iteration);
+            const size_t nb_moves_kept = _nb_eval_local_minimum + _tabu_tenure;
+
+            // online refinement: switch to the refined surrogates as soon as they are ready
+            if(_online_refinement && update_online_refinement())
+                logger_text += ",Surrogates refined";
+
             {
-                for(int r2 = r1 + 1; r2 < nb_locations; ++r2)
+                std::vector<int> timeslots;
+                if(!_full_neighbourhood_scan)
+                    timeslots.push_back(timeslot);
+                else
+                    for(int t = 0; t < nb_timeslots; ++t)
+                        timeslots.push_back(t);
+                std::vector<std::vector<Swap>> moves_timeslots(timeslots.size());
+
+                // pipelined search: reuse the scores of timeslots that have not changed (possibly scored speculatively)
+                std::vector<int> timeslots_to_score;
+                if(_pipelined_search)
+                    prune_scored_timeslots();
+                for(int k = 0; k < timeslots.size(); ++k)
                 {
-                    // swap room r1 & r2
-                    // get event1 and event2
-                    int event1 = _current_solution.timeslot_location(timeslot, r1);
-                    int event2 = _current_solution.timeslot_location(timeslot, r2);
+                    if(!_pipelined_search || !take_scored_timeslot(timeslots[k], keep_all_moves, nb_moves_kept, moves_timeslots[k]))
+                        timeslots_to_score.push_back(k);
+                }
 
-                    // no empty swap && feasible
-                    if((event1 >= 0 || event2 >= 0)
-                            && get_event_location_possible(event1, r2)  // is swap feasible?
-                            && get_event_location_possible(event2, r1))
+                if(timeslots_to_score.size() == 1)
+                {
+                    int k = timeslots_to_score.front();
+                    score_moves_timeslot(_current_solution, timeslots[k], keep_all_moves, nb_moves_kept, moves_timeslots[k]);
+                }
+                else if(timeslots_to_score.size() > 1)
+                {
+                    // the timeslots are scored in parallel, each on its own copy of the current solution (the surrogates are read-only)
+                    QtConcurrent::blockingMap(timeslots_to_score, [this, keep_all_moves, nb_moves_kept, &timeslots, &moves_timeslots](int& k)
                     {
-                        Swap swap;
-                        swap.timeslot = timeslot;
-                        swap.location1 = r1;
-                        swap.location2 = r2;
-                        swap.obj_value_surrogate = 0.0;
-
-                        // do the swap
-                        if(event1 >= 0)
-                            _current_solution.set_event_location(event1, r2);
-                        if(event2 >= 0)
-                            _current_solution.set_event_location(event2, r1);
-
-                        // calculate the objective value
-                        {
-                            // evacuations
-                            if(_alpha_objective > 0.01)
-                            {
-                                swap.obj_value_surrogate += _alpha_objective * _surrogate->predict_evacuation_time(_current_solution, timeslot);
-                            }
-                            // travels
-                            if(_alpha_objective < 0.99)
-                            {
-                                // from t-1 to t
-                                if(timeslot > 0)
-                                {
-                                    swap.obj_value_surrogate += (1-_alpha_objective) * _surrogate->predict_travel_time(_current_solution, timeslot - 1);
-                                }
-
-                                // from t to t+1
-                                if(timeslot < nb_timeslots - 1)
-                                {
-                                    swap.obj_value_surrogate += (1-_alpha_objective) * _surrogate->predict_travel_time(_current_solution, timeslot);
-                                }
-                            }
-
-                        }
-
-
-                        // reverse the swap
-                        if(event1 >= 0)
-                            _current_solution.set_event_location(event1, r1);
-                        if(event2 >= 0)
-                            _current_solution.set_event_location(event2, r2);
-
-
-                        // put candidate swap in vector
-                        candidate_moves.push_back(swap);
-                    }
-
+                        solution sol = _current_solution;
+                        score_moves_timeslot(sol, timeslots[k], keep_all_moves, nb_moves_kept, moves_timeslots[k]);
+                    });
+                }
 
+                // the global best moves are among the best moves of every timeslot
+                for(int k = 0; k < timeslots.size(); ++k)
+                {
+                    if(_pipelined_search)
+                        store_scored_timeslot(timeslots[k], keep_all_moves, nb_moves_kept, moves_timeslots[k]);
+                    candidate_moves.insert(candidate_moves.end(), moves_timeslots[k].begin(), moves_timeslots[k].end());
                 }
             }
 
 
-            // sort all moves
+            // select and sort the best moves only
+            if(!keep_all_moves && candidate_moves.size() > nb_moves_kept)
+            {
+                std::nth_element(candidate_moves.begin(), candidate_moves.begin() + nb_moves_kept, candidate_moves.end());
+                candidate_moves.resize(nb_moves_kept);
+            }
             std::sort(candidate_moves.begin(), candidate_moves.end());
             for(int i = 0; i < std::min(_nb_eval_local_minimum, (int)candidate_moves.size()); ++i) {
                 output_text = "Objective value surrogate best move ";
@@ -812,24 +1689,15 @@ namespace timetable
                     // reevaluate all candidate moves
                     for(int i = 0; i < candidate_moves.size(); ++i)
                     {
-                        int r1 = candidate_moves[i].location1;
-                        int r2 = candidate_moves[i].location2;
-
                         int timeslot = candidate_moves[i].timeslot;
 
-                        int event1 = _current_solution.timeslot_location(timeslot, r1);
-                        int event2 = _current_solution.timeslot_location(timeslot, r2);
-
 
                         // store values calculated by surrogates
                         surrogate_values.push_back(candidate_moves[i].obj_value_surrogate);
 
 
-                        // do the swap
-                        if(event1 >= 0)
-                            _current_solution.set_event_location(event1, r2);
-                        if(event2 >= 0)
-                            _current_solution.set_event_location(event2, r1);
+                        // do the move
+                        apply_move(_current_solution, candidate_moves[i]);
 
                         std::vector<double> observations_evac, observations_tt1, observations_tt2;
                         observations_evac.reserve(_nb_eval_menge_validate);
@@ -875,11 +1743,8 @@ namespace timetable
                         }
 
 
-                        // reverse the swap
-                        if(event1 >= 0)
-                            _current_solution.set_event_location(event1, r1);
-                        if(event2 >= 0)
-                            _current_solution.set_event_location(event2, r2);
+                        // reverse the move
+                        undo_move(_current_solution, candidate_moves[i]);
 
 
                         // objective value
@@ -941,17 +1806,9 @@ namespace timetable
             bool move_found = false;
             for(int i = 0; i < std::min((int)candidate_moves.size(), _nb_eval_local_minimum); ++i) // start with best candidate, then second, etc. MAX nb_eval_local_minimum
             {
-                // iterate over tabu list to check whether move is tabu
-                for(int j = 0; j < _tabu_list.size(); ++j)
-                {
-                    if(_tabu_list[j] == candidate_moves[i]) // if tabu
-                    {
-                        candidate_moves[i].tabu = true;
-
-                        // stop searching tabu list
-                        break;
-                    }
-                }
+                // check whether move is tabu
+                if(is_tabu(candidate_moves[i]))
+                    candidate_moves[i].tabu = true;
 
 
                 // no aspiration criterion
@@ -960,32 +1817,38 @@ namespace timetable
                 {
                     // evaluate move 'i' with Menge
                     {
-                        int r1 = candidate_moves[i].location1;
-                        int r2 = candidate_moves[i].location2;
-
                         int timeslot = candidate_moves[i].timeslot;
 
-                        int event1 = _current_solution.timeslot_location(timeslot, r1);
-                        int event2 = _current_solution.timeslot_location(timeslot, r2);
+                        // do the move
+                        apply_move(_current_solution, candidate_moves[i]);
 
-                        // do the swap
-                        if(event1 >= 0)
-                            _current_solution.set_event_location(event1, r2);
-                        if(event2 >= 0)
-                            _current_solution.set_event_location(event2, r1);
+
+                        // pipelined search: score the next neighbourhood on the solution after this move while it is simulated
+                        if(_pipelined_search)
+                        {
+                            if(!_full_neighbourhood_scan)
+                            {
+                                if(next_timeslot < 0)
+                                    next_timeslot = select_timeslot();
+                                speculate_scored_timeslot(next_timeslot, keep_all_moves_iteration(iteration + 1), nb_moves_kept);
+                            }
+                            else
+                            {
+                                // only the scores of this timeslot and its neighbouring timeslots change
+                                for(int t = std::max(timeslot - 1, 0); t <= std::min(timeslot + 1, nb_timeslots - 1); ++t)
+                                    speculate_scored_timeslot(t, keep_all_moves_iteration(iteration + 1), nb_moves_kept);
+                            }
+                        }
 
 
-                        for(int j = 0; j < _nb_eval_menge_incremental; ++j)
+                        for(int j = 0; j < nb_replications; ++j)
                         {
+                            const std::size_t nb_simulations_replication = _evaluator.nb_simulations();
+
                             // evacuations
                             if(_alpha_objective > 0.01)
                             {
-                                double evactt = _menge->max_sim_duration();
-                                int again = 0;
-                                do { // if simulation gets stuck, recalculate
-                                   evactt = _menge->calculate_evacuation_time(_current_solution, timeslot);
-                                   ++again;
-                                } while(evactt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
+                                double evactt = _evaluator.simulate_evacuation(_current_solution, timeslot, j);
                                 candidate_moves[i].observations_menge_evac.push_back(evactt);
                             }
 
@@ -998,29 +1861,21 @@ namespace timetable
                                 {
                                     if(timeslot - 1 == ts) // only previous if previous timeslot in vector
                                     {
-                                        double traveltt = _menge->max_sim_duration();
-                                        int again = 0;
-                                        do { // if simulation gets stuck, recalculate
-                                            traveltt = _menge->calculate_flows_time(_current_solution, timeslot-1);
-                                            ++again;
-                                        } while(traveltt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
+                                        double traveltt = _evaluator.simulate_travels(_current_solution, timeslot-1, j);
                                         candidate_moves[i].observations_menge_tt1.push_back(traveltt);
                                     }
                                     if(timeslot == ts) // only current if current timeslot in vector
                                     {
-                                        double traveltt = _menge->max_sim_duration();
-                                        int again = 0;
-                                        do { // if simulation gets stuck, recalculate
-                                            traveltt = _menge->calculate_flows_time(_current_solution, timeslot);
-                                            ++again;
-                                        } while(traveltt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
+                                        double traveltt = _evaluator.simulate_travels(_current_solution, timeslot, j);
                                         candidate_moves[i].observations_menge_tt2.push_back(traveltt);
                                     }
                                 }
                             }
 
 
-                            --remaining_budget_tabu_search;
+                            // a replication that is completely reused from the memo does not use the budget
+                            if(_evaluator.nb_simulations() > nb_simulations_replication)
+                                --remaining_budget_tabu_search;
                             if(remaining_budget_tabu_search <= 0)
                             {
                                 std::chrono::nanoseconds elapsed_time = std::chrono::system_clock::now() - _start_time;
@@ -1033,15 +1888,21 @@ namespace timetable
 
                                 return;
                             }
+
+                            // common random numbers: stop as soon as the candidate is significantly worse than the current solution
+                            if(_common_random_numbers && j + 1 >= _common_random_numbers_min_replications)
+                            {
+                                double mean_difference, stddev_mean_difference;
+                                calculate_paired_difference(candidate_moves[i], mean_difference, stddev_mean_difference);
+                                if(mean_difference - student_t_values(j) * stddev_mean_difference > 0)
+                                    break;
+                            }
                         }
 
 
 
-                        // reverse the swap
-                        if(event1 >= 0)
-                            _current_solution.set_event_location(event1, r1);
-                        if(event2 >= 0)
-                            _current_solution.set_event_location(event2, r2);
+                        // reverse the move
+                        undo_move(_current_solution, candidate_moves[i]);
 
                     }
 
@@ -1051,6 +1912,8 @@ namespace timetable
                     double candidate_solution_upper_95_CI = 0.0;
                     double candidate_solution_mean_obj_val = 0.0;
                     {
+                        int timeslot = candidate_moves[i].timeslot;
+
                         std::vector<double> means_evac, stddevs_evac;
                         std::vector<double> means_travels, stddevs_travels;
                         if(_alpha_objective > 0.01)
@@ -1093,22 +1956,26 @@ namespace timetable
                     }
 
 
+                    // with common random numbers, compare on the paired differences with the current solution
+                    bool candidate_is_better = (candidate_solution_mean_obj_val < obj_current_solution);
+                    if(_common_random_numbers)
+                    {
+                        double mean_difference, stddev_mean_difference;
+                        calculate_paired_difference(candidate_moves[i], mean_difference, stddev_mean_difference);
+                        candidate_is_better = (mean_difference < 0);
+
+                        logger_text += ",Paired difference candidate,";
+                        logger_text += QString::number(mean_difference);
+                    }
+
+
                     // if move is not tabu
                     // calculate objective value current solution
-                    if(candidate_solution_mean_obj_val < obj_current_solution)
+                    if(candidate_is_better)
                     {
-                        // do swap
-                        int r1 = candidate_moves[i].location1;
-                        int r2 = candidate_moves[i].location2;
+                        // do the move
                         int timeslot = candidate_moves[i].timeslot;
-
-                        int event1 = _current_solution.timeslot_location(timeslot, r1);
-                        int event2 = _current_solution.timeslot_location(timeslot, r2);
-
-                        if(event1 >= 0)
-                            _current_solution.set_event_location(event1, r2);
-                        if(event2 >= 0)
-                            _current_solution.set_event_location(event2, r1);
+                        apply_move(_current_solution, candidate_moves[i]);
 
 
                         // put objective of candidate in current_solution
@@ -1163,7 +2030,7 @@ namespace timetable
 
 
                         // put move in tabu list
-                        _tabu_list[iteration % _tabu_list_length] = candidate_moves[i];
+                        add_tabu_move(candidate_moves[i]);
 
 
                         move_found = true;
@@ -1194,36 +2061,26 @@ namespace timetable
                 {
                     if(!candidate_moves[i].tabu)
                     {
-                        // do swap
-                        int r1 = candidate_moves[i].location1;
-                        int r2 = candidate_moves[i].location2;
+                        // do the move
                         int timeslot = candidate_moves[i].timeslot;
-
-                        int event1 = _current_solution.timeslot_location(timeslot, r1);
-                        int event2 = _current_solution.timeslot_location(timeslot, r2);
-
-                        if(event1 >= 0)
-                            _current_solution.set_event_location(event1, r2);
-                        if(event2 >= 0)
-                            _current_solution.set_event_location(event2, r1);
+                        apply_move(_current_solution, candidate_moves[i]);
 
 
                         // if not yet simulated with Menge (but instead only surrogate), use Menge for real evaluation
-                        if(candidate_moves[i].observations_menge_evac.size() <= 0
-                                && candidate_moves[i].observations_menge_tt1.size() <= 0
-                                && candidate_moves[i].observations_menge_tt2.size() <= 0)
+                        // with common random numbers, also complete the replications of candidates that were rejected early
+                        int replications_done = (int)std::max(candidate_moves[i].observations_menge_evac.size(),
+                                                         std::max(candidate_moves[i].observations_menge_tt1.size(), candidate_moves[i].observations_menge_tt2.size()));
+                        if(replications_done <= 0
+                                || (_common_random_numbers && replications_done < nb_replications))
                         {
-                            for(int j = 0; j < _nb_eval_menge_incremental; ++j)
+                            for(int j = replications_done; j < nb_replications; ++j)
                             {
+                                const std::size_t nb_simulations_replication = _evaluator.nb_simulations();
+
                                 // evacuations
                                 if(_alpha_objective > 0.01)
                                 {
-                                    double evactt = _menge->max_sim_duration();
-                                    int again = 0;
-                                    do { // if simulation gets stuck, recalculate
-                                       evactt = _menge->calculate_evacuation_time(_current_solution, timeslot);
-                                       ++again;
-                                    } while(evactt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
+                                    double evactt = _evaluator.simulate_evacuation(_current_solution, timeslot, j);
                                     candidate_moves[i].observations_menge_evac.push_back(evactt);
                                 }
 
@@ -1235,35 +2092,29 @@ namespace timetable
                                     if(timeslot > 0) // only previous if not first ts
                                     {
                                         double traveltt = _menge->max_sim_duration();
-                                        int again = 0;
-                                        do { // if simulation gets stuck, recalculate
-                                            try {
-                                                traveltt = _menge->calculate_flows_time(_current_solution, timeslot-1);
-                                            } catch(const std::exception& ex) {
-
-                                            }
-                                            ++again;
-                                        } while(traveltt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
+                                        try {
+                                            traveltt = _evaluator.simulate_travels(_current_solution, timeslot-1, j);
+                                        } catch(const std::exception& ex) {
+
+                                        }
                                         candidate_moves[i].observations_menge_tt1.push_back(traveltt);
                                     }
                                     if(timeslot < nb_timeslots - 1) // only current if not last ts
                                     {
                                         double traveltt = _menge->max_sim_duration();
-                                        int again = 0;
-                                        do { // if simulation gets stuck, recalculate
-                                            try {
-                                                traveltt = _menge->calculate_flows_time(_current_solution, timeslot);
-                                            } catch(const std::exception& ex) {
-
-                                            }
-                                            ++again;
-                                        } while(traveltt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
+                                        try {
+                                            traveltt = _evaluator.simulate_travels(_current_solution, timeslot, j);
+                                        } catch(const std::exception& ex) {
+
+                                        }
                                         candidate_moves[i].observations_menge_tt2.push_back(traveltt);
                                     }
                                 }
 
 
-                                --remaining_budget_tabu_search;
+                                // a replication that is completely reused from the memo does not use the budget
+                                if(_evaluator.nb_simulations() > nb_simulations_replication)
+                                    --remaining_budget_tabu_search;
                                 if(remaining_budget_tabu_search <= 0)
                                 {
                                     std::chrono::nanoseconds elapsed_time = std::chrono::system_clock::now() - _start_time;
@@ -1336,7 +2187,7 @@ namespace timetable
 
 
                         // put move in tabu list
-                        _tabu_list[iteration % _tabu_list_length] = candidate_moves[i];
+                        add_tabu_move(candidate_moves[i]);
 
                         move_found = true;
                         break;
@@ -1345,6 +2196,43 @@ namespace timetable
             }
 
 
+            // reward the timeslot with the realised improvement per replication
+            if(!_full_neighbourhood_scan)
+                update_timeslot_selection(timeslot,
+                                          obj_start_iteration - _current_solution.total_mean_objective_value(_alpha_objective),
+                                          remaining_budget_start_iteration - remaining_budget_tabu_search);
+
+
+            // reactive tabu search: adapt the tenure to the repetitions of solutions, escape if the search is trapped
+            if(_reactive_tabu && move_found)
+            {
+                if(update_reactive_tabu_tenure(iteration))
+                {
+                    output_text = "Solutions are repeated too often. Diversification kick ...";
+                    emit(signal_algorithm_status(output_text));
+                    logger_text += ",Diversification kick";
+
+                    if(!diversification_kick(remaining_budget_tabu_search, nb_replications))
+                    {
+                        std::chrono::nanoseconds elapsed_time = std::chrono::system_clock::now() - _start_time;
+                        output_text = "\n\n\n\nStopping criterion tabu search reached.\nElapsed time (seconds): ";
+                        output_text.append(QString::number(elapsed_time.count() / NANO));
+                        emit(signal_algorithm_status(output_text));
+                        logger_text = "Stopping criterion tabu search reached.\nElapsed time (seconds): ";
+                        logger_text.append(QString::number(elapsed_time.count() / NANO));
+                        global::_logger << global::logger::log_type::INFORMATION << logger_text;
+
+                        return;
+                    }
+
+                    logger_text += ",Mean objective value,";
+                    logger_text += QString::number(_current_solution.total_mean_objective_value(_alpha_objective));
+                }
+                logger_text += ",Tabu tenure,";
+                logger_text += QString::number(_tabu_tenure);
+            }
+
+
             global::_logger << logger_text;
         }
 
@@ -1356,6 +2244,238 @@ namespace timetable
 
 
 
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // PATH RELINKING
+    void tabu_search::path_relinking()
+    {
+        QString output_text;
+        QString logger_text;
+        std::chrono::system_clock::time_point start_time = std::chrono::system_clock::now();
+
+        // 1. the elite solutions are the best distinct solutions found
+        std::vector<int> elites;
+        {
+            std::vector<int> order(_best_solutions.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [this](int i, int j) {
+                return _best_solutions[i].total_mean_objective_value(_alpha_objective) < _best_solutions[j].total_mean_objective_value(_alpha_objective);
+            });
+
+            std::unordered_set<std::uint64_t> hashes;
+            for(int i : order)
+            {
+                if(hashes.insert(_best_solutions[i].hash()).second)
+                    elites.push_back(i);
+                if((int)elites.size() >= _path_relinking_nb_elites)
+                    break;
+            }
+        }
+        if(elites.size() < 2)
+        {
+            logger_text = "Path relinking skipped: fewer than two distinct elite solutions.";
+            global::_logger << global::logger::log_type::INFORMATION << logger_text;
+            return;
+        }
+
+        output_text = "\n\nStarting Path Relinking between ";
+        output_text.append(QString::number(elites.size()));
+        output_text.append(" elite solutions ...");
+        emit(signal_algorithm_status(output_text));
+        logger_text = "Starting Path Relinking ...";
+        global::_logger << global::logger::log_type::INFORMATION << logger_text;
+
+
+        // 2. walk between every (ordered) pair of elite solutions in parallel, scoring the intermediate solutions with the surrogates
+        std::vector<relinking_path> paths;
+        for(int initiating : elites)
+        {
+            for(int guiding : elites)
+            {
+                if(initiating == guiding)
+                    continue;
+                relinking_path path;
+                path.initiating = initiating;
+                path.guiding = guiding;
+                paths.push_back(path);
+            }
+        }
+        QtConcurrent::blockingMap(paths, [this](relinking_path& path)
+        {
+            relink(path);
+        });
+
+
+        // 3. simulate the most promising intermediate solutions of all paths
+        std::vector<const relinking_intermediate*> intermediates;
+        for(auto&& path : paths)
+            for(auto&& intermediate : path.intermediates)
+                intermediates.push_back(&intermediate);
+        std::sort(intermediates.begin(), intermediates.end(), [](const relinking_intermediate* i1, const relinking_intermediate* i2) {
+            return i1->obj_value_surrogate < i2->obj_value_surrogate;
+        });
+
+        std::unordered_set<std::uint64_t> hashes_simulated;
+        for(int i : elites)
+            hashes_simulated.insert(_best_solutions[i].hash());
+
+        int nb_simulated = 0;
+        int nb_new_best = 0;
+        for(const relinking_intermediate* intermediate : intermediates)
+        {
+            if(nb_simulated >= _path_relinking_nb_simulated)
+                break;
+            if(!hashes_simulated.insert(intermediate->sol.hash()).second)
+                continue;
+            ++nb_simulated;
+
+            // only the timeslots (and timeslot pairs) that differ from the initiating solution are simulated
+            solution sol = intermediate->sol;
+            std::vector<bool> timeslot_changed(nb_timeslots, false);
+            for(int t = 0; t < nb_timeslots; ++t)
+                timeslot_changed[t] = (sol.hash_timeslot(t) != _best_solutions[intermediate->initiating].hash_timeslot(t));
+            _evaluator.simulate_timeslots(sol, timeslot_changed, _nb_eval_menge_incremental);
+
+
+            // if the solution can be better than the best solution, put it in the list best_solutions
+            double mean_obj_val = sol.total_mean_objective_value(_alpha_objective);
+            logger_text = "Path relinking,Intermediate solution,";
+            logger_text += QString::number(nb_simulated);
+            logger_text += ",Surrogate value,";
+            logger_text += QString::number(intermediate->obj_value_surrogate);
+            logger_text += ",Mean objective value,";
+            logger_text += QString::number(mean_obj_val);
+            if(sol.lower_95_CI_objective_value(_alpha_objective) < _best_solution_upper_95_CI)
+            {
+                double upper_95_CI = sol.upper_95_CI_objective_value(_alpha_objective);
+                if(upper_95_CI < _best_solution_upper_95_CI)
+                    _best_solution_upper_95_CI = upper_95_CI;
+                _best_solutions.push_back(sol);
+                ++nb_new_best;
+
+                output_text = "New possible best solution found by path relinking.\nMean objective value: ";
+                output_text.append(QString::number(mean_obj_val));
+                emit(signal_algorithm_status(output_text));
+                emit(new_best_solution_found(sol));
+                logger_text += ",New possible best solution found";
+            }
+            global::_logger << global::logger::log_type::INFORMATION << logger_text;
+        }
+
+        std::chrono::nanoseconds elapsed_time = std::chrono::system_clock::now() - start_time;
+        output_text = "Path relinking completed.\nIntermediate solutions simulated: ";
+        output_text.append(QString::number(nb_simulated));
+        output_text.append("\nNew possible best solutions: ");
+        output_text.append(QString::number(nb_new_best));
+        output_text.append("\nElapsed time (seconds): ");
+        output_text.append(QString::number(elapsed_time.count() / NANO));
+        emit(signal_algorithm_status(output_text));
+        logger_text = output_text;
+        global::_logger << global::logger::log_type::INFORMATION << logger_text;
+    }
+
+    void tabu_search::relink(relinking_path& path) const
+    {
+        const solution& guiding = _best_solutions[path.guiding];
+        solution sol = _best_solutions[path.initiating];
+
+        // surrogate predictions of all terms of the objective value of the intermediate solution
+        // (the travel time of timeslot pair (t,t+1) is stored at t, the last element is not used)
+        std::vector<double> predictions_evac(nb_timeslots, 0.0);
+        std::vector<double> predictions_travels(nb_timeslots, 0.0);
+        auto predict_timeslot = [this, &sol, &predictions_evac, &predictions_travels](int timeslot)
+        {
+            if(_alpha_objective > 0.01)
+                predictions_evac[timeslot] = _surrogate->predict_evacuation_time(sol, timeslot);
+            if(_alpha_objective < 0.99)
+            {
+                if(timeslot > 0)
+                    predictions_travels[timeslot-1] = _surrogate->predict_travel_time(sol, timeslot - 1);
+                if(timeslot < nb_timeslots - 1)
+                    predictions_travels[timeslot] = _surrogate->predict_travel_time(sol, timeslot);
+            }
+        };
+        auto objective_value = [this, &predictions_evac, &predictions_travels]()
+        {
+            return calculate_mean(predictions_evac, predictions_travels, _alpha_objective);
+        };
+        for(int t = 0; t < nb_timeslots; ++t)
+            predict_timeslot(t);
+
+        int distance = 0;
+        for(int e = 0; e < nb_events; ++e)
+            if(sol.event_location(e) != guiding.event_location(e))
+                ++distance;
+
+        while(distance > 1)
+        {
+            // move the event to its location in the guiding solution that leads to the best intermediate solution
+            Swap best_step;
+            double best_obj_value = 1e10;
+            for(int e = 0; e < nb_events; ++e)
+            {
+                if(sol.event_location(e) == guiding.event_location(e))
+                    continue;
+
+                // the event that is planned in the new location takes the old location of the event
+                Swap step;
+                step.timeslot = sol.event_timeslot(e);
+                step.location1 = sol.event_location(e);
+                step.location2 = guiding.event_location(e);
+                if(!get_event_location_possible(sol.timeslot_location(step.timeslot, step.location2), step.location1))
+                    continue;
+
+                const int t = step.timeslot;
+                const double old_evac = predictions_evac[t];
+                const double old_travels1 = (t > 0) ? predictions_travels[t-1] : 0.0;
+                const double old_travels2 = predictions_travels[t];
+                apply_move(sol, step);
+                predict_timeslot(t);
+                double obj_value = objective_value();
+                undo_move(sol, step);
+                predictions_evac[t] = old_evac;
+                if(t > 0)
+                    predictions_travels[t-1] = old_travels1;
+                predictions_travels[t] = old_travels2;
+
+                if(obj_value < best_obj_value)
+                {
+                    best_obj_value = obj_value;
+                    best_step = step;
+                }
+            }
+            if(best_step.timeslot < 0)
+                break;
+
+            // the event that is moved away was not in its location of the guiding solution either, so the distance decreases
+            int displaced_event = sol.timeslot_location(best_step.timeslot, best_step.location2);
+            apply_move(sol, best_step);
+            predict_timeslot(best_step.timeslot);
+            --distance;
+            if(displaced_event >= 0 && sol.event_location(displaced_event) == guiding.event_location(displaced_event))
+                --distance;
+
+            // the guiding solution itself is not an intermediate solution
+            if(distance <= 0)
+                break;
+
+            // keep the best intermediate solutions
+            relinking_intermediate intermediate;
+            intermediate.obj_value_surrogate = best_obj_value;
+            intermediate.initiating = path.initiating;
+            intermediate.sol = sol;
+            path.intermediates.push_back(intermediate);
+            if((int)path.intermediates.size() > _path_relinking_nb_simulated)
+            {
+                auto worst = std::max_element(path.intermediates.begin(), path.intermediates.end(), [](const relinking_intermediate& i1, const relinking_intermediate& i2) {
+                    return i1.obj_value_surrogate < i2.obj_value_surrogate;
+                });
+                path.intermediates.erase(worst);
+            }
+        }
+    }
+
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     // EXHAUSTIVE SEARCH
@@ -1373,8 +2493,20 @@ namespace timetable
 
         try
         {
-            // reset counter
+            // reset counters
             exhaustive_search_solutions_number = 0;
+            exhaustive_search_simulations_number = 0;
+            exhaustive_search_reused_number = 0;
+            exhaustive_search_pruned_number = 0;
+            seed_random_streams();
+            initialise_interchangeable_locations();
+
+            // the branch and bound needs the surrogate of the simulated objective
+            if(_exhaustive_branch_and_bound
+                    && (_surrogate == nullptr
+                        || (_alpha_objective > 0.99 && !_surrogate->is_trained_evacuations())
+                        || (_alpha_objective <= 0.99 && !_surrogate->is_trained_travels())))
+                throw std::runtime_error("Error in function timetable::tabu_search::run_exhaustive_search. \nThe surrogates have not been trained.");
 
             // clear room assignments
             for(int e = 0; e < nb_events; ++e)
@@ -1386,15 +2518,22 @@ namespace timetable
                 // every timeslot is independent of all others
                 for(int t = 0; t < nb_timeslots; ++t)
                 {
-                    generate_all_possible_solutions_independently(t, 0);
+                    run_exhaustive_search_subtrees(t);
                 }
             }
             // travels between consecutive timeslots only
             else
             {
-                generate_all_possible_solutions(0);
+                run_exhaustive_search_subtrees(-1);
             }
 
+            logger_text = "\nExhaustive search finished,Solutions," + QString::number(exhaustive_search_solutions_number)
+                    + ",Simulations," + QString::number(exhaustive_search_simulations_number)
+                    + ",Reused timeslot pairs," + QString::number(exhaustive_search_reused_number);
+            if(_exhaustive_branch_and_bound)
+                logger_text += ",Bounded subtrees," + QString::number(exhaustive_search_pruned_number);
+            global::_logger << logger_text;
+
             // If done
             emit(finished());
         }
@@ -1407,59 +2546,178 @@ namespace timetable
 
 
 
-    // RECURSIVE FUNCTION TO GENERATE ALL SOLUTIONS (for travels)
-    void tabu_search::generate_all_possible_solutions(int current_event)
+    void tabu_search::initialise_interchangeable_locations()
     {
-        // solution has been generated entirely
-        if(current_event >= nb_events)
+        _previous_interchangeable_location.assign(nb_locations, -1);
+        if(!_exhaustive_symmetry_pruning)
+            return;
+        if(_surrogate_paths == nullptr || !_surrogate_paths->data_exist())
         {
-            // evaluate the objective value for every timeslot
-            for(int t = 0; t < nb_timeslots; ++t)
+            global::_logger << global::logger::log_type::WARNING << "No surrogate paths available: the exhaustive search does not skip permutations of interchangeable locations.";
+            return;
+        }
+
+        int nb_interchangeable = 0;
+        for(int l = 0; l < nb_locations; ++l)
+        {
+            for(int prev = l - 1; prev >= 0; --prev)
             {
-                // reset values
-                _current_solution.reset_objective_values_evac(t);
-                for(int replication = 0; replication < _nb_eval_menge_incremental; ++replication)
+                if(_surrogate_paths->room_node(prev) != _surrogate_paths->room_node(l))
+                    continue;
+
+                bool same_events = true;
+                for(int e = 0; e < nb_events && same_events; ++e)
+                    same_events = (get_event_location_possible(e, prev) == get_event_location_possible(e, l));
+
+                if(same_events)
                 {
-                    double traveltt = _menge->max_sim_duration();
-                    int again = 0;
-                    do { // if simulation gets stuck, recalculate
-                        traveltt = _menge->calculate_flows_time(_current_solution, t);
-                        ++again;
-                    } while (traveltt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
-                    _current_solution.add_objective_value_travels(t, traveltt);
+                    _previous_interchangeable_location[l] = prev;
+                    ++nb_interchangeable;
+                    break;
                 }
-                _current_solution.calculate_means_and_stddevs_travels(t);
             }
+        }
 
-            // print the objective value
-            ++exhaustive_search_solutions_number;
-            QString output_text;
-            output_text = "Solution \t" + QString::number(exhaustive_search_solutions_number)
-                    + "\tMean objective value \t" + QString::number(_current_solution.total_mean_objective_value(_alpha_objective))
-                    + "\tStddev objective value \t" + QString::number(_current_solution.total_stddev_objective_value(_alpha_objective));
-            emit(signal_algorithm_status(output_text));
-            output_text = "\nSolutiont" + QString::number(exhaustive_search_solutions_number) + ","
-                    + "Mean objective value," + QString::number(_current_solution.total_mean_objective_value(_alpha_objective)) + ","
-                    + "Stddev objective value," + QString::number(_current_solution.total_stddev_objective_value(_alpha_objective));
-            global::_logger << output_text;
+        QString logger_text = "Symmetry pruning: ";
+        logger_text += QString::number(nb_interchangeable);
+        logger_text += " locations are interchangeable with a previous location";
+        global::_logger << global::logger::log_type::INFORMATION << logger_text;
+    }
+
+
+
+    bool tabu_search::exhaustive_search_location_allowed(const solution& sol, int event, int location) const
+    {
+        int timeslot = sol.event_timeslot(event);
+
+        // check if location available and feasible
+        if(sol.timeslot_location(timeslot, location) != -1 || !get_event_location_possible(event, location))
+            return false;
+
+        // interchangeable locations are filled in order (the events are planned in order as well),
+        // such that every permutation of the events over these locations is generated once
+        int previous = _previous_interchangeable_location[location];
+        return (previous < 0 || sol.timeslot_location(timeslot, previous) != -1);
+    }
+
+
+
+    std::vector<std::vector<int>> tabu_search::split_exhaustive_search(int timeslot) const
+    {
+        // enough subtrees to keep all threads busy when the subtrees are unbalanced
+        const size_t nb_subtrees_min = 8 * static_cast<size_t>(std::max(QThread::idealThreadCount(), 1));
+
+        std::vector<std::vector<int>> subtrees(1);
+        solution sol = _current_solution;
+        for(int event = 0; event < nb_events && subtrees.size() < nb_subtrees_min; ++event)
+        {
+            std::vector<std::vector<int>> next_subtrees;
+            bool enumerated = (timeslot < 0 || sol.event_timeslot(event) == timeslot);
+            for(auto&& subtree : subtrees)
+            {
+                if(!enumerated)
+                {
+                    subtree.push_back(-1);
+                    next_subtrees.push_back(subtree);
+                    continue;
+                }
+
+                for(int e = 0; e < event; ++e)
+                    sol.set_event_location(e, subtree[e]);
+                for(int l = 0; l < nb_locations; ++l)
+                {
+                    if(exhaustive_search_location_allowed(sol, event, l))
+                    {
+                        next_subtrees.push_back(subtree);
+                        next_subtrees.back().push_back(l);
+                    }
+                }
+                for(int e = 0; e < event; ++e)
+                    sol.set_event_location(e, -1);
+            }
+            subtrees.swap(next_subtrees);
+        }
+        return subtrees;
+    }
+
+
+
+    void tabu_search::run_exhaustive_search_subtrees(int timeslot)
+    {
+        std::vector<std::vector<int>> subtrees = split_exhaustive_search(timeslot);
+        if(_exhaustive_branch_and_bound)
+        {
+            run_exhaustive_branch_and_bound(timeslot, subtrees);
+            return;
+        }
+
+        // the subtrees are distributed dynamically over the thread pool; the simulations of the workers run concurrently,
+        // each in a Menge worker process of its own (see ped::menge_interface)
+        QtConcurrent::blockingMap(subtrees, [this, timeslot](std::vector<int>& subtree)
+        {
+            exhaustive_search_worker worker;
+            worker.sol = _current_solution;
+            for(int e = 0; e < subtree.size(); ++e)
+                worker.sol.set_event_location(e, subtree[e]);
+            if(timeslot < 0)
+            {
+                worker.cached_timeslots.resize(std::max(nb_timeslots - 1, 0));
+                worker.cached_travels.resize(std::max(nb_timeslots - 1, 0));
+            }
+
+            generate_all_possible_solutions(worker, timeslot, (int)subtree.size());
+
+            QMutexLocker locker(&_exhaustive_search_mutex);
+            exhaustive_search_simulations_number += worker.nb_simulations;
+            exhaustive_search_reused_number += worker.nb_reused;
+        });
+    }
+
+
+
+    // RECURSIVE FUNCTION TO GENERATE ALL SOLUTIONS
+    void tabu_search::generate_all_possible_solutions(exhaustive_search_worker& worker, int timeslot, int current_event)
+    {
+        // solution has been generated entirely
+        if(current_event >= nb_events)
+        {
+            if(_exhaustive_branch_and_bound)
+                screen_exhaustive_search_solution(worker, timeslot);
+            else
+                evaluate_exhaustive_search_solution(worker, timeslot);
+        }
+        // only generate all possible rooms if the event is planned in the enumerated timeslot(s)
+        else if(timeslot >= 0 && worker.sol.event_timeslot(current_event) != timeslot)
+        {
+            generate_all_possible_solutions(worker, timeslot, current_event + 1);
         }
         else
         {
-            int current_timeslot = _current_solution.event_timeslot(current_event);
             for(int l = 0; l < nb_locations; ++l)
             {
-                // check if location available and feasible
-                if(_current_solution.timeslot_location(current_timeslot, l) == -1
-                        && get_event_location_possible(current_event, l))
+                if(exhaustive_search_location_allowed(worker.sol, current_event, l))
                 {
                     // set the event in that location
-                    _current_solution.set_event_location(current_event, l);
+                    worker.sol.set_event_location(current_event, l);
 
-                    // go to the next event
-                    generate_all_possible_solutions(current_event + 1);
+                    if(!_exhaustive_branch_and_bound)
+                    {
+                        // go to the next event
+                        generate_all_possible_solutions(worker, timeslot, current_event + 1);
+                    }
+                    else
+                    {
+                        // go to the next event, unless no solution in the subtree can be within the error margin of the best one
+                        update_exhaustive_bounds(worker, current_event, true);
+                        if(exhaustive_lower_bound(worker, timeslot) > _exhaustive_incumbent.load() + _exhaustive_margin)
+                            ++worker.nb_pruned;
+                        else
+                            generate_all_possible_solutions(worker, timeslot, current_event + 1);
+                        update_exhaustive_bounds(worker, current_event, false);
+                    }
 
                     // when returning, reset the last assignment
-                    _current_solution.set_event_location(current_event, -1);
+                    worker.sol.set_event_location(current_event, -1);
                 }
             }
         }
@@ -1467,72 +2725,298 @@ namespace timetable
 
 
 
-    // RECURSIVE FUNCTION TO GENERATE ALL SOLUTIONS FOR EACH TIMESLOT INDEPENDENTLY (for evacuations)
-    void tabu_search::generate_all_possible_solutions_independently(int timeslot, int current_event)
+    void tabu_search::evaluate_exhaustive_search_solution(exhaustive_search_worker& worker, int timeslot)
     {
-        // solution has been generated entirely
-        if(current_event >= nb_events)
+        solution& sol = worker.sol;
+
+        // the replications use the common random number stream, such that the results do not depend on the order
+        // in which the workers simulate, and such that the solutions are compared with the same random numbers
+        auto simulate = [this, &worker](const solution& s, bool travels, int t, int replication)
         {
-            // evaluate the objective value for this timeslot
-            _current_solution.reset_objective_values_evac(timeslot); // first reset values
+            double tt = _menge->max_sim_duration();
+            int again = 0;
+            do { // if simulation gets stuck, recalculate
+                std::uint64_t index = evaluator::common_random_number_index(travels, t, replication, again);
+                tt = travels ? _menge->calculate_flows_time(s, t, index) : _menge->calculate_evacuation_time(s, t, index);
+                ++again;
+            } while (tt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
+            ++worker.nb_simulations;
+            return tt;
+        };
+
+        // evacuations: evaluate the objective value for this timeslot
+        if(timeslot >= 0)
+        {
+            sol.reset_objective_values_evac(timeslot);
             for(int replication = 0; replication < _nb_eval_menge_incremental; ++replication)
+                sol.add_objective_value_evac(timeslot, simulate(sol, false, timeslot, replication));
+            sol.calculate_means_and_stddevs_evac(timeslot);
+        }
+        // travels: evaluate the objective value for every timeslot pair, reusing the pairs that did not change
+        else
+        {
+            for(int t = 0; t < nb_timeslots - 1; ++t)
             {
-                double evactt = _menge->max_sim_duration();
-                int again = 0;
-                do { // if simulation gets stuck, recalculate
-                    evactt = _menge->calculate_evacuation_time(_current_solution, timeslot);
-                    ++again;
-                } while (evactt > _menge->max_sim_duration() - 1.f && again < 3); // recalculate max 3 times
-                _current_solution.add_objective_value_evac(timeslot, evactt);
+                std::pair<std::uint64_t, std::uint64_t> hashes(sol.hash_timeslot(t), sol.hash_timeslot(t + 1));
+                if(worker.cached_travels[t].empty() || worker.cached_timeslots[t] != hashes)
+                {
+                    worker.cached_travels[t].clear();
+                    for(int replication = 0; replication < _nb_eval_menge_incremental; ++replication)
+                        worker.cached_travels[t].push_back(simulate(sol, true, t, replication));
+                    worker.cached_timeslots[t] = hashes;
+                }
+                else
+                {
+                    ++worker.nb_reused;
+                }
+
+                sol.reset_objective_values_travels(t);
+                for(auto&& traveltt : worker.cached_travels[t])
+                    sol.add_objective_value_travels(t, traveltt);
+                sol.calculate_means_and_stddevs_travels(t);
             }
-            _current_solution.calculate_means_and_stddevs_evac(timeslot);
+        }
 
-            // print the objective value
-            ++exhaustive_search_solutions_number;
-            QString sol;
+
+        // print the objective value
+        QMutexLocker locker(&_exhaustive_search_mutex);
+        ++exhaustive_search_solutions_number;
+        QString output_text;
+        if(timeslot >= 0)
+        {
+            QString sol_text;
             for(int e = 0; e < nb_events; ++e)
             {
-                sol.append(QString::number(_current_solution.event_location(e)));
-                sol.append("|");
+                sol_text.append(QString::number(sol.event_location(e)));
+                sol_text.append("|");
             }
-            QString output_text;
             output_text = "Solution \t" + QString::number(exhaustive_search_solutions_number)
                     + "\ttimeslot \t" + QString::number(timeslot + 1)
-                    + "\t" + sol
-                    + "\tMean objective value \t" + QString::number(_current_solution.mean_objective_value_evac(timeslot))
-                    + "\tStddev objective value \t" + QString::number(_current_solution.stddev_estimator_obj_val_evac(timeslot));
+                    + "\t" + sol_text
+                    + "\tMean objective value \t" + QString::number(sol.mean_objective_value_evac(timeslot))
+                    + "\tStddev objective value \t" + QString::number(sol.stddev_estimator_obj_val_evac(timeslot));
             emit(signal_algorithm_status(output_text));
             output_text = "\nSolution," + QString::number(exhaustive_search_solutions_number) + ","
                     + "timeslot," + QString::number(timeslot + 1) + ","
-                    + sol + ","
-                    + "Mean objective value," + QString::number(_current_solution.mean_objective_value_evac(timeslot)) + ","
-                    + "Stddev objective value," + QString::number(_current_solution.stddev_estimator_obj_val_evac(timeslot));
+                    + sol_text + ","
+                    + "Mean objective value," + QString::number(sol.mean_objective_value_evac(timeslot)) + ","
+                    + "Stddev objective value," + QString::number(sol.stddev_estimator_obj_val_evac(timeslot));
             global::_logger << output_text;
         }
         else
         {
-            // only if the event is planned in this timeslot, generate all possible rooms
-            if(_current_solution.event_timeslot(current_event) == timeslot)
+            output_text = "Solution \t" + QString::number(exhaustive_search_solutions_number)
+                    + "\tMean objective value \t" + QString::number(sol.total_mean_objective_value(_alpha_objective))
+                    + "\tStddev objective value \t" + QString::number(sol.total_stddev_objective_value(_alpha_objective));
+            emit(signal_algorithm_status(output_text));
+            output_text = "\nSolutiont" + QString::number(exhaustive_search_solutions_number) + ","
+                    + "Mean objective value," + QString::number(sol.total_mean_objective_value(_alpha_objective)) + ","
+                    + "Stddev objective value," + QString::number(sol.total_stddev_objective_value(_alpha_objective));
+            global::_logger << output_text;
+        }
+    }
+
+
+
+    // BRANCH AND BOUND ON THE SURROGATES
+    void tabu_search::run_exhaustive_branch_and_bound(int timeslot, std::vector<std::vector<int>>& subtrees)
+    {
+        // error margin of the difference between two surrogate objective values (independent errors for every term)
+        double rmse = (timeslot >= 0) ? _surrogate->cross_validation_rmse_evacuation_time() : _surrogate->cross_validation_rmse_travel_time();
+        int nb_terms = (timeslot >= 0) ? 1 : std::max(nb_timeslots - 1, 1);
+        _exhaustive_margin = _branch_and_bound_confidence * rmse * std::sqrt(2.0 * nb_terms);
+        _exhaustive_lower_bound_travels = (timeslot >= 0) ? -std::numeric_limits<double>::infinity() : _surrogate->lower_bound_travel_time();
+        _exhaustive_incumbent = std::numeric_limits<double>::infinity();
+        if(rmse <= 0.0)
+            global::_logger << global::logger::log_type::WARNING << "No cross-validated error of the surrogates to calibrate the error margin: only the best solutions according to the surrogates are simulated.";
+
+
+        // 1. score all (partial) solutions with the surrogates
+        std::vector<std::pair<double, std::vector<int>>> screened_solutions;
+        int nb_pruned = 0;
+        QtConcurrent::blockingMap(subtrees, [this, timeslot, &screened_solutions, &nb_pruned](std::vector<int>& subtree)
+        {
+            exhaustive_search_worker worker;
+            worker.sol = _current_solution;
+            for(int e = 0; e < subtree.size(); ++e)
+                worker.sol.set_event_location(e, subtree[e]);
+            initialise_exhaustive_bounds(worker, timeslot);
+
+            if(exhaustive_lower_bound(worker, timeslot) > _exhaustive_incumbent.load() + _exhaustive_margin)
+                ++worker.nb_pruned;
+            else
+                generate_all_possible_solutions(worker, timeslot, (int)subtree.size());
+
+            QMutexLocker locker(&_exhaustive_search_mutex);
+            nb_pruned += worker.nb_pruned;
+            screened_solutions.insert(screened_solutions.end(),
+                                      std::make_move_iterator(worker.screened_solutions.begin()),
+                                      std::make_move_iterator(worker.screened_solutions.end()));
+        });
+
+
+        // 2. only the solutions within the error margin of the best one are simulated
+        const double threshold = _exhaustive_incumbent.load() + _exhaustive_margin;
+        std::vector<std::vector<int>> solutions;
+        for(auto&& screened : screened_solutions)
+        {
+            if(screened.first <= threshold)
+                solutions.push_back(std::move(screened.second));
+        }
+        std::sort(solutions.begin(), solutions.end()); // consecutive solutions share most timeslots, such that their simulations are reused
+        exhaustive_search_pruned_number += nb_pruned;
+
+        QString output_text = "Branch and bound: " + QString::number(solutions.size()) + " solutions to simulate (best surrogate value "
+                + QString::number(_exhaustive_incumbent.load()) + ", error margin " + QString::number(_exhaustive_margin) + ")";
+        emit(signal_algorithm_status(output_text));
+        QString logger_text = "\nBranch and bound,Timeslot," + (timeslot >= 0 ? QString::number(timeslot + 1) : QString("all"))
+                + ",Best surrogate value," + QString::number(_exhaustive_incumbent.load())
+                + ",Error margin," + QString::number(_exhaustive_margin)
+                + ",Bounded subtrees," + QString::number(nb_pruned)
+                + ",Screened solutions," + QString::number(screened_solutions.size())
+                + ",Simulated solutions," + QString::number(solutions.size());
+        global::_logger << logger_text;
+
+
+        // 3. simulate the remaining solutions with Menge, in contiguous chunks distributed over the thread pool (the simulations of
+        //    the chunks run concurrently in Menge worker processes, the simulations within a chunk reuse the unchanged timeslots)
+        const size_t nb_chunks = std::min(solutions.size(), 4 * static_cast<size_t>(std::max(QThread::idealThreadCount(), 1)));
+        std::vector<std::pair<size_t, size_t>> chunks;
+        for(size_t c = 0; c < nb_chunks; ++c)
+            chunks.push_back(std::make_pair(c * solutions.size() / nb_chunks, (c + 1) * solutions.size() / nb_chunks));
+
+        QtConcurrent::blockingMap(chunks, [this, timeslot, &solutions](std::pair<size_t, size_t>& chunk)
+        {
+            exhaustive_search_worker worker;
+            worker.sol = _current_solution;
+            if(timeslot < 0)
             {
-                for(int l = 0; l < nb_locations; ++l)
+                worker.cached_timeslots.resize(std::max(nb_timeslots - 1, 0));
+                worker.cached_travels.resize(std::max(nb_timeslots - 1, 0));
+            }
+
+            for(size_t i = chunk.first; i < chunk.second; ++i)
+            {
+                for(int e = 0; e < nb_events; ++e)
+                    worker.sol.set_event_location(e, -1);
+                for(int e = 0; e < nb_events; ++e)
                 {
-                    // check if location available and feasible
-                    if(_current_solution.timeslot_location(timeslot, l) == -1
-                            && get_event_location_possible(current_event, l))
-                    {
-                        // set the event in that location
-                        _current_solution.set_event_location(current_event, l);
+                    if(solutions[i][e] >= 0)
+                        worker.sol.set_event_location(e, solutions[i][e]);
+                }
+                evaluate_exhaustive_search_solution(worker, timeslot);
+            }
 
-                        // go to the next event
-                        generate_all_possible_solutions_independently(timeslot, current_event + 1);
+            QMutexLocker locker(&_exhaustive_search_mutex);
+            exhaustive_search_simulations_number += worker.nb_simulations;
+            exhaustive_search_reused_number += worker.nb_reused;
+        });
+    }
 
-                        // when returning, reset the last assignment
-                        _current_solution.set_event_location(current_event, -1);
-                    }
+
+
+    void tabu_search::initialise_exhaustive_bounds(exhaustive_search_worker& worker, int timeslot)
+    {
+        // evacuations: a timeslot is only scored when it is complete
+        if(timeslot >= 0)
+            return;
+
+        worker.nb_unplanned_events.assign(nb_timeslots, 0);
+        worker.predictions_travels.assign(std::max(nb_timeslots - 1, 0), 0.0);
+        worker.predicted_travels.assign(std::max(nb_timeslots - 1, 0), false);
+        for(int e = 0; e < nb_events; ++e)
+        {
+            if(worker.sol.event_location(e) < 0)
+                ++worker.nb_unplanned_events[worker.sol.event_timeslot(e)];
+        }
+        for(int t = 0; t < nb_timeslots - 1; ++t)
+        {
+            if(worker.nb_unplanned_events[t] == 0 && worker.nb_unplanned_events[t + 1] == 0)
+            {
+                worker.predictions_travels[t] = _surrogate->predict_travel_time(worker.sol, t);
+                worker.predicted_travels[t] = true;
+            }
+        }
+    }
+
+
+
+    void tabu_search::update_exhaustive_bounds(exhaustive_search_worker& worker, int event, bool planned)
+    {
+        if(worker.nb_unplanned_events.empty())
+            return;
+
+        int t = worker.sol.event_timeslot(event);
+        if(planned)
+        {
+            --worker.nb_unplanned_events[t];
+
+            // the timeslot pairs of a completed timeslot are predicted if the other timeslot is complete as well
+            if(worker.nb_unplanned_events[t] == 0)
+            {
+                if(t > 0 && worker.nb_unplanned_events[t - 1] == 0)
+                {
+                    worker.predictions_travels[t - 1] = _surrogate->predict_travel_time(worker.sol, t - 1);
+                    worker.predicted_travels[t - 1] = true;
+                }
+                if(t < nb_timeslots - 1 && worker.nb_unplanned_events[t + 1] == 0)
+                {
+                    worker.predictions_travels[t] = _surrogate->predict_travel_time(worker.sol, t);
+                    worker.predicted_travels[t] = true;
                 }
             }
+        }
+        else
+        {
+            if(worker.nb_unplanned_events[t] == 0)
+            {
+                if(t > 0)
+                    worker.predicted_travels[t - 1] = false;
+                if(t < nb_timeslots - 1)
+                    worker.predicted_travels[t] = false;
+            }
+            ++worker.nb_unplanned_events[t];
+        }
+    }
+
+
+
+    double tabu_search::exhaustive_lower_bound(const exhaustive_search_worker& worker, int timeslot) const
+    {
+        if(timeslot >= 0 || worker.nb_unplanned_events.empty())
+            return -std::numeric_limits<double>::infinity();
+
+        // predictions of the complete timeslot pairs, lower bound of the surrogate for the others
+        double bound = 0.0;
+        for(int t = 0; t < nb_timeslots - 1; ++t)
+            bound += worker.predicted_travels[t] ? worker.predictions_travels[t] : _exhaustive_lower_bound_travels;
+        return bound;
+    }
 
+
+
+    void tabu_search::screen_exhaustive_search_solution(exhaustive_search_worker& worker, int timeslot)
+    {
+        double obj_value_surrogate = 0.0;
+        if(timeslot >= 0)
+            obj_value_surrogate = _surrogate->predict_evacuation_time(worker.sol, timeslot);
+        else
+            obj_value_surrogate = exhaustive_lower_bound(worker, timeslot); // all timeslot pairs are complete
+
+        if(obj_value_surrogate > _exhaustive_incumbent.load() + _exhaustive_margin)
+        {
+            ++worker.nb_pruned;
+            return;
         }
+
+        std::vector<int> locations(nb_events);
+        for(int e = 0; e < nb_events; ++e)
+            locations[e] = worker.sol.event_location(e);
+        worker.screened_solutions.push_back(std::make_pair(obj_value_surrogate, locations));
+
+        // update the best surrogate objective value
+        double incumbent = _exhaustive_incumbent.load();
+        while(obj_value_surrogate < incumbent && !_exhaustive_incumbent.compare_exchange_weak(incumbent, obj_value_surrogate)) {}
     }
 
 } // namespace timetable
@@ -15,16 +15,25 @@
 #define TIMETABLE_TABU_SEARCH_H
 
 #include <QObject>
+#include <QFuture>
+#include <QMutex>
 #include <vector>
 #include <algorithm>
 #include <random>
 #include <cmath>
 #include <chrono>
+#include <cstdint>
+#include <deque>
+#include <atomic>
+#include <unordered_map>
 
 #include "menge_interface.h"
 #include "machine_learning_interface.h"
 #include "timetable_global_data.h"
 #include "timetable_solution.h"
+#include "timetable_evaluator.h"
+#include "timetable_search_strategy.h"
+#include "timetable_simulated_annealing.h"
 
 /*!
  *  @namespace timetable
@@ -32,10 +41,25 @@
  */
 namespace timetable
 {
+    /*!
+     *	@brief		The criteria to rank the candidate moves that are scored with the surrogates.
+     */
+    enum class acquisition_function
+    {
+        surrogate_prediction,       ///< The prediction of the surrogates (predictive mean).
+        lower_confidence_bound,     ///< The predictive mean minus a multiple of the predictive standard deviation.
+        expected_improvement        ///< The expected improvement over the current solution (highest first).
+    };
+
+
+
     /*!
      *	@brief		The Surrogate-Based Tabu Search algorithm.
+     *
+     *  The class runs the whole optimisation (initial evaluation, exploration, path relinking and reporting of the best
+     *  solution). The exploration is done by a search strategy, which is the tabu search itself by default.
      */
-    class tabu_search : public QObject
+    class tabu_search : public QObject, public search_strategy
     {
         Q_OBJECT
 
@@ -62,6 +86,12 @@ namespace timetable
          */
         void set_machine_learning_interface(ml::machine_learning_interface *ml_interface) { _surrogate = ml_interface; }
 
+        /*!
+         *	@brief      Set the surrogate paths (used to find interchangeable locations in the exhaustive search).
+         *  @param      paths       A pointer to a surrogate_paths instance.
+         */
+        void set_surrogate_paths(const ml::surrogate_paths *paths) { _surrogate_paths = paths; }
+
         /*!
          *	@brief      Set the initial solution to the algorithm.
          *  @param      startsol    An initial solution from which the Tabu Search algorithm starts.
@@ -84,6 +114,21 @@ namespace timetable
          */
         void run_exhaustive_search();
 
+        /*!
+         *	@brief      The name of the strategy (for the output).
+         *  @returns    The name.
+         */
+        QString strategy_name() const override { return QStringLiteral("Tabu search"); }
+
+        /*!
+         *	@brief      Explore the solution space with the tabu search.
+         *
+         *  The tabu search works directly on the current solution and the evaluator of this class, to which the context refers.
+         *
+         *  @param      context     The context of the search.
+         */
+        void search(search_context& context) override;
+
 
 
 
@@ -186,6 +231,162 @@ namespace timetable
          */
         bool get_analyze_performance() const { return _analyze_performance; }
 
+        /*!
+         *	@brief      Set whether candidate solutions and the current solution are simulated with common random numbers.
+         *  @param      common_random_numbers      True if common random numbers are used, false if all replications are independent.
+         */
+        void set_common_random_numbers(bool common_random_numbers) { _common_random_numbers = common_random_numbers; }
+
+        /*!
+         *	@brief      Get whether candidate solutions and the current solution are simulated with common random numbers.
+         *  @returns    True if common random numbers are used, false if all replications are independent.
+         */
+        bool get_common_random_numbers() const { return _common_random_numbers; }
+
+        /*!
+         *	@brief      Set whether the timeslot of each iteration is selected adaptively instead of uniformly at random.
+         *  @param      adaptive      True if the timeslot is selected adaptively.
+         */
+        void set_adaptive_timeslot_selection(bool adaptive) { _adaptive_timeslot_selection = adaptive; }
+
+        /*!
+         *	@brief      Get whether the timeslot of each iteration is selected adaptively instead of uniformly at random.
+         *  @returns    True if the timeslot is selected adaptively.
+         */
+        bool get_adaptive_timeslot_selection() const { return _adaptive_timeslot_selection; }
+
+        /*!
+         *	@brief      Set whether the moves of all timeslots are scored by the surrogates in every iteration (in parallel).
+         *  @param      full_scan      True if the moves of all timeslots are scored.
+         */
+        void set_full_neighbourhood_scan(bool full_scan) { _full_neighbourhood_scan = full_scan; }
+
+        /*!
+         *	@brief      Get whether the moves of all timeslots are scored by the surrogates in every iteration (in parallel).
+         *  @returns    True if the moves of all timeslots are scored.
+         */
+        bool get_full_neighbourhood_scan() const { return _full_neighbourhood_scan; }
+
+        /*!
+         *	@brief      Set whether the observations of Menge are memorised and reused for re-visited (timeslot) configurations.
+         *  @param      memo      True if the observations are reused.
+         */
+        void set_evaluation_memo(bool memo) { _evaluation_memo = memo; }
+
+        /*!
+         *	@brief      Get whether the observations of Menge are memorised and reused for re-visited (timeslot) configurations.
+         *  @returns    True if the observations are reused.
+         */
+        bool get_evaluation_memo() const { return _evaluation_memo; }
+
+        /*!
+         *	@brief      Set whether the tabu tenure reacts to repetitions of solutions (reactive tabu search).
+         *  @param      reactive      True if the tabu tenure is reactive, false if it is fixed to the length of the tabu list.
+         */
+        void set_reactive_tabu(bool reactive) { _reactive_tabu = reactive; }
+
+        /*!
+         *	@brief      Get whether the tabu tenure reacts to repetitions of solutions (reactive tabu search).
+         *  @returns    True if the tabu tenure is reactive.
+         */
+        bool get_reactive_tabu() const { return _reactive_tabu; }
+
+        /*!
+         *	@brief      Set whether the next neighbourhood is scored speculatively while the candidates are simulated.
+         *  @param      pipelined      True if the surrogate scoring and the simulations are pipelined.
+         */
+        void set_pipelined_search(bool pipelined) { _pipelined_search = pipelined; }
+
+        /*!
+         *	@brief      Get whether the next neighbourhood is scored speculatively while the candidates are simulated.
+         *  @returns    True if the surrogate scoring and the simulations are pipelined.
+         */
+        bool get_pipelined_search() const { return _pipelined_search; }
+
+        /*!
+         *	@brief      Set whether the surrogates are refined with the simulations of the search.
+         *  @param      refinement      True if the surrogates are refined during the search.
+         */
+        void set_online_refinement(bool refinement) { _online_refinement = refinement; }
+
+        /*!
+         *	@brief      Get whether the surrogates are refined with the simulations of the search.
+         *  @returns    True if the surrogates are refined during the search.
+         */
+        bool get_online_refinement() const { return _online_refinement; }
+
+        /*!
+         *	@brief      Set whether the exhaustive search skips permutations of interchangeable locations.
+         *  @param      pruning      True if permutations of interchangeable locations are skipped.
+         */
+        void set_exhaustive_symmetry_pruning(bool pruning) { _exhaustive_symmetry_pruning = pruning; }
+
+        /*!
+         *	@brief      Get whether the exhaustive search skips permutations of interchangeable locations.
+         *  @returns    True if permutations of interchangeable locations are skipped.
+         */
+        bool get_exhaustive_symmetry_pruning() const { return _exhaustive_symmetry_pruning; }
+
+        /*!
+         *	@brief      Set whether the exhaustive search bounds the enumeration with the surrogates.
+         *  @param      branch_and_bound      True if the enumeration is bounded with the surrogates.
+         */
+        void set_exhaustive_branch_and_bound(bool branch_and_bound) { _exhaustive_branch_and_bound = branch_and_bound; }
+
+        /*!
+         *	@brief      Get whether the exhaustive search bounds the enumeration with the surrogates.
+         *  @returns    True if the enumeration is bounded with the surrogates.
+         */
+        bool get_exhaustive_branch_and_bound() const { return _exhaustive_branch_and_bound; }
+
+        /*!
+         *	@brief      Set whether compound moves (rotations of the events in three locations) are added to the neighbourhood.
+         *  @param      compound      True if compound moves are added to the neighbourhood.
+         */
+        void set_compound_moves(bool compound) { _compound_moves = compound; }
+
+        /*!
+         *	@brief      Get whether compound moves (rotations of the events in three locations) are added to the neighbourhood.
+         *  @returns    True if compound moves are added to the neighbourhood.
+         */
+        bool get_compound_moves() const { return _compound_moves; }
+
+        /*!
+         *	@brief      Set whether the search ends with path relinking between the elite solutions.
+         *  @param      relinking      True if path relinking is executed after the exploration.
+         */
+        void set_path_relinking(bool relinking) { _path_relinking = relinking; }
+
+        /*!
+         *	@brief      Get whether the search ends with path relinking between the elite solutions.
+         *  @returns    True if path relinking is executed after the exploration.
+         */
+        bool get_path_relinking() const { return _path_relinking; }
+
+        /*!
+         *	@brief      Set the search strategy of the exploration.
+         *  @param      strategy      The search strategy.
+         */
+        void set_search_strategy(search_strategy_type strategy) { _search_strategy = strategy; }
+
+        /*!
+         *	@brief      Get the search strategy of the exploration.
+         *  @returns    The search strategy.
+         */
+        search_strategy_type get_search_strategy() const { return _search_strategy; }
+
+        /*!
+         *	@brief      Set the criterion to rank the candidate moves.
+         *  @param      af      The acquisition function.
+         */
+        void set_acquisition_function(acquisition_function af) { _acquisition_function = af; }
+
+        /*!
+         *	@brief      Get the criterion to rank the candidate moves.
+         *  @returns    The acquisition function.
+         */
+        acquisition_function get_acquisition_function() const { return _acquisition_function; }
+
         /*!
          *	@brief      Reset the values for the parameters of the Tabu Search.
          */
@@ -242,6 +443,71 @@ namespace timetable
          */
         static constexpr int _nb_eval_local_minimum_default = 10;
 
+        /*!
+         *	@brief      Default value for the use of common random numbers.
+         */
+        static constexpr bool _common_random_numbers_default = false;
+
+        /*!
+         *	@brief      Default value for the adaptive selection of timeslots.
+         */
+        static constexpr bool _adaptive_timeslot_selection_default = false;
+
+        /*!
+         *	@brief      Default value for scoring the moves of all timeslots in every iteration.
+         */
+        static constexpr bool _full_neighbourhood_scan_default = false;
+
+        /*!
+         *	@brief      Default value for reusing the observations of Menge for re-visited configurations.
+         */
+        static constexpr bool _evaluation_memo_default = false;
+
+        /*!
+         *	@brief      Default value for the reactive tabu tenure.
+         */
+        static constexpr bool _reactive_tabu_default = false;
+
+        /*!
+         *	@brief      Default value for pipelining the surrogate scoring and the simulations.
+         */
+        static constexpr bool _pipelined_search_default = false;
+
+        /*!
+         *	@brief      Default value for the online refinement of the surrogates.
+         */
+        static constexpr bool _online_refinement_default = false;
+
+        /*!
+         *	@brief      Default value for skipping permutations of interchangeable locations in the exhaustive search.
+         */
+        static constexpr bool _exhaustive_symmetry_pruning_default = false;
+
+        /*!
+         *	@brief      Default value for bounding the exhaustive search with the surrogates.
+         */
+        static constexpr bool _exhaustive_branch_and_bound_default = false;
+
+        /*!
+         *	@brief      Default value for adding compound moves to the neighbourhood.
+         */
+        static constexpr bool _compound_moves_default = false;
+
+        /*!
+         *	@brief      Default value for path relinking between the elite solutions.
+         */
+        static constexpr bool _path_relinking_default = false;
+
+        /*!
+         *	@brief      Default value for the search strategy of the exploration.
+         */
+        static constexpr search_strategy_type _search_strategy_default = search_strategy_type::tabu_search;
+
+        /*!
+         *	@brief      Default value for the criterion to rank the candidate moves.
+         */
+        static constexpr acquisition_function _acquisition_function_default = acquisition_function::surrogate_prediction;
+
 
 
 
@@ -283,21 +549,30 @@ namespace timetable
             int timeslot = -1;                  ///< The timeslot in which the swap is executed.
             int location1 = -1;                 ///< The first location that is changed.
             int location2 = -1;                 ///< The second location that is changed.
+            int location3 = -1;                 ///< The third location of a compound move (-1 for a swap): the event in location1 moves to location2, the one in location2 to location3 and the one in location3 to location1.
             double obj_value_surrogate = 1e9;   ///< The objective value for the timeslot(s) of the swap of the new candidate solution evaluated by the surrogate.
+            double delta_obj_value_surrogate = 1e9; ///< The change of the surrogate objective value for the timeslot(s) of the swap with respect to the current solution (negative is an improvement).
+            double acquisition = 1e9;           ///< The value of the acquisition function by which the candidates are ranked, relative to the current solution (lower is better).
             bool tabu = false;                  ///< Is the swap tabu?
 
             std::vector<double> observations_menge_evac;
             std::vector<double> observations_menge_tt1;
             std::vector<double> observations_menge_tt2;
 
-            bool operator==(const Swap& other)
+            bool operator==(const Swap& other) const
             {
-                if(timeslot == other.timeslot
-                        && ((location1 == other.location1 && location2 == other.location2)
-                            || (location2 == other.location1 && location1 == other.location2)))
-                    return true;
-                else
+                if(timeslot != other.timeslot || (location3 < 0) != (other.location3 < 0))
                     return false;
+                if(location3 < 0)
+                    return ((location1 == other.location1 && location2 == other.location2)
+                            || (location2 == other.location1 && location1 == other.location2));
+
+                // compound moves on the same three locations (in either direction)
+                int locations[3] = {location1, location2, location3};
+                int other_locations[3] = {other.location1, other.location2, other.location3};
+                std::sort(locations, locations + 3);
+                std::sort(other_locations, other_locations + 3);
+                return std::equal(locations, locations + 3, other_locations);
             }
 
             Swap operator=(const Swap& other)
@@ -307,7 +582,10 @@ namespace timetable
                     timeslot = other.timeslot;
                     location1 = other.location1;
                     location2 = other.location2;
+                    location3 = other.location3;
                     obj_value_surrogate = other.obj_value_surrogate;
+                    delta_obj_value_surrogate = other.delta_obj_value_surrogate;
+                    acquisition = other.acquisition;
                     tabu = other.tabu;
 
                     observations_menge_evac = other.observations_menge_evac;
@@ -318,7 +596,9 @@ namespace timetable
             }
             bool operator<(const Swap& other)
             {
-                return (this->obj_value_surrogate < other.obj_value_surrogate);
+                if(this->acquisition != other.acquisition)
+                    return (this->acquisition < other.acquisition);
+                return (this->delta_obj_value_surrogate < other.delta_obj_value_surrogate);
             }
         };
 
@@ -343,6 +623,11 @@ namespace timetable
          */
         ml::machine_learning_interface *_surrogate;
 
+        /*!
+         *	@brief      Pointer to the surrogate paths (no ownership).
+         */
+        const ml::surrogate_paths *_surrogate_paths = nullptr;
+
 
 
         /*!
@@ -370,9 +655,9 @@ namespace timetable
 
 
         /*!
-         *	@brief      Stores all swaps that are tabu.
+         *	@brief      Stores the most recent swaps (most recent last), of which the last _tabu_tenure are tabu.
          */
-        std::vector<Swap> _tabu_list;
+        std::deque<Swap> _tabu_list;
 
         /*!
          *	@brief      The length of the tabu list.
@@ -424,6 +709,257 @@ namespace timetable
          */
         bool _analyze_performance = false;
 
+        /*!
+         *	@brief      Indicates whether candidate solutions and the current solution are simulated with common random numbers.
+         *
+         *  With common random numbers, replication j of every solution uses the same random numbers. A candidate is then
+         *  compared with the current solution based on the paired differences of the replications, and its evaluation is
+         *  stopped early as soon as it is significantly worse than the current solution.
+         */
+        bool _common_random_numbers = _common_random_numbers_default;
+
+        /*!
+         *	@brief      The minimum number of replications of a candidate before it can be rejected early with common random numbers.
+         */
+        static constexpr int _common_random_numbers_min_replications = 3;
+
+        /*!
+         *	@brief      Indicates whether the timeslot of each iteration is selected adaptively instead of uniformly at random.
+         *
+         *  The selection is a multi-armed bandit (UCB1) over the timeslots, rewarded by the realised improvement
+         *  of the objective value per replication of Menge spent in the iteration.
+         */
+        bool _adaptive_timeslot_selection = _adaptive_timeslot_selection_default;
+
+        /*!
+         *	@brief      The minimum step size of the recency-weighted mean reward of a timeslot.
+         */
+        static constexpr double _timeslot_reward_step_size = 0.1;
+
+        /*!
+         *	@brief      The number of feasible moves in every timeslot of the current solution.
+         */
+        std::vector<int> _timeslot_nb_moves;
+
+        /*!
+         *	@brief      The hash of every timeslot of the current solution when its feasible moves were counted.
+         */
+        std::vector<std::uint64_t> _timeslot_nb_moves_hash;
+
+        /*!
+         *	@brief      The number of times every timeslot has been selected.
+         */
+        std::vector<int> _timeslot_nb_selected;
+
+        /*!
+         *	@brief      The (recency-weighted) mean improvement per replication of every timeslot.
+         */
+        std::vector<double> _timeslot_reward;
+
+        /*!
+         *	@brief      The largest improvement per replication observed so far (to scale the rewards).
+         */
+        double _timeslot_max_reward = 0.0;
+
+        /*!
+         *	@brief      Indicates whether the moves of all timeslots are scored by the surrogates in every iteration.
+         *
+         *  The timeslots are scored in parallel and the best moves over all timeslots are evaluated with Menge,
+         *  instead of the best moves of a single selected timeslot.
+         */
+        bool _full_neighbourhood_scan = _full_neighbourhood_scan_default;
+
+        /*!
+         *	@brief      Indicates whether the observations of Menge are memorised and reused for re-visited configurations.
+         *
+         *  The evacuation time of a timeslot and the travel time of a timeslot pair only depend on the assignment of the
+         *  events in those timeslots, such that the observations are stored per (Zobrist) hash of that assignment.
+         */
+        bool _evaluation_memo = _evaluation_memo_default;
+
+        /*!
+         *	@brief      The evaluation layer: surrogate scores, simulations with Menge, memo and statistics.
+         */
+        evaluator _evaluator;
+
+        /*!
+         *	@brief      The search strategy of the exploration.
+         */
+        search_strategy_type _search_strategy = _search_strategy_default;
+
+        /*!
+         *	@brief      The simulated annealing strategy.
+         */
+        simulated_annealing _simulated_annealing;
+
+        /*!
+         *	@brief      Indicates whether the tabu tenure reacts to repetitions of solutions.
+         *
+         *  The tenure is increased when the search returns to a solution it has visited before (a cycle) and decreased
+         *  when no cycles occur for a while. When several solutions are repeated often, the search escapes with a
+         *  random walk (diversification kick).
+         */
+        bool _reactive_tabu = _reactive_tabu_default;
+
+        /*!
+         *	@brief      The current tabu tenure, i.e. the number of most recent moves that are tabu.
+         */
+        int _tabu_tenure = _tabu_list_length_default;
+
+        /*!
+         *	@brief      The maximum tabu tenure of the reactive tabu search.
+         */
+        int _tabu_tenure_max = _tabu_list_length_default;
+
+        /*!
+         *	@brief      The factor with which the tabu tenure is increased when a cycle is detected.
+         */
+        static constexpr double _tabu_tenure_increase = 1.1;
+
+        /*!
+         *	@brief      The factor with which the tabu tenure is decreased when no cycles occur.
+         */
+        static constexpr double _tabu_tenure_decrease = 0.9;
+
+        /*!
+         *	@brief      The number of visits after which a solution is considered to be repeated often.
+         */
+        static constexpr int _reactive_max_repetitions = 3;
+
+        /*!
+         *	@brief      The number of often repeated solutions after which a diversification kick is executed.
+         */
+        static constexpr int _reactive_max_chaotic_solutions = 3;
+
+        /*!
+         *	@brief      A solution visited by the search (the last iteration in which it was visited and the number of visits).
+         */
+        struct visited_solution
+        {
+            int last_iteration = 0;
+            int nb_visits = 0;
+        };
+
+        /*!
+         *	@brief      All solutions visited by the search, per hash of the solution.
+         */
+        std::unordered_map<std::uint64_t, visited_solution> _visited_solutions;
+
+        /*!
+         *	@brief      The last iteration in which the tabu tenure was changed.
+         */
+        int _last_tenure_change = 0;
+
+        /*!
+         *	@brief      The moving average of the length of the detected cycles.
+         */
+        double _mean_cycle_length = 0.0;
+
+        /*!
+         *	@brief      The number of often repeated solutions since the last diversification kick.
+         */
+        int _nb_chaotic_solutions = 0;
+
+        /*!
+         *	@brief      Indicates whether the surrogate scoring and the simulations with Menge are pipelined.
+         *
+         *  While a candidate move is simulated, the neighbourhood of the next iteration is scored in the background
+         *  on the solution after that move. The scores of a timeslot are reused as long as the timeslot and its
+         *  neighbouring timeslots and the surrogates are unchanged, and discarded otherwise.
+         */
+        bool _pipelined_search = _pipelined_search_default;
+
+        /*!
+         *	@brief      The moves of a timeslot scored by the surrogates (ready or still being scored in the background).
+         */
+        struct scored_timeslot
+        {
+            int timeslot = -1;                      ///< The timeslot.
+            std::uint64_t hash = 0;                 ///< The hash of the timeslot and its neighbouring timeslots of the scored solution.
+            std::uint64_t surrogate_version = 0;    ///< The version of the surrogates with which the moves are scored.
+            bool keep_all_moves = false;            ///< Are all moves kept?
+            std::size_t nb_moves_kept = 0;          ///< The number of best moves that are kept.
+            bool pending = false;                   ///< Is the timeslot still being scored in the background?
+            std::vector<Swap> moves;                ///< The scored moves (if not pending).
+            QFuture<std::vector<Swap>> future;      ///< The background scoring (if pending).
+        };
+
+        /*!
+         *	@brief      The timeslots scored by the surrogates that can be reused (pipelined search).
+         */
+        std::vector<scored_timeslot> _scored_timeslots;
+
+        /*!
+         *	@brief      Speculative scorings of which the results are not needed anymore, but which may still be running.
+         */
+        std::vector<QFuture<std::vector<Swap>>> _discarded_scorings;
+
+        /*!
+         *	@brief      Indicates whether the surrogates are refined with the simulations of the search.
+         *
+         *  Every simulation with Menge is added to the training data of the surrogates. The surrogates are retrained
+         *  in the background and the refined surrogates replace the current ones at the start of an iteration.
+         */
+        bool _online_refinement = _online_refinement_default;
+
+        /*!
+         *	@brief      The number of new observations after which the surrogates are retrained.
+         */
+        static constexpr int _online_refinement_min_observations = 50;
+
+        /*!
+         *	@brief      The criterion to rank the candidate moves.
+         *
+         *  With an acquisition function other than the surrogate prediction, the best moves according to the surrogates are
+         *  preselected and then reranked with the predictive variance, such that the simulations go to moves that are either
+         *  promising or uncertain.
+         */
+        acquisition_function _acquisition_function = _acquisition_function_default;
+
+        /*!
+         *	@brief      The weight of the predictive standard deviation in the lower confidence bound.
+         */
+        static constexpr double _lower_confidence_bound_kappa = 2.0;
+
+        /*!
+         *	@brief      The number of moves preselected on the surrogate prediction, relative to the number of moves kept.
+         */
+        static constexpr int _acquisition_preselection_factor = 3;
+
+        /*!
+         *	@brief      Add compound moves to the neighbourhood?
+         *
+         *  A compound move rotates the events in three locations of a timeslot. Such a move is built as an ejection
+         *  chain from one of the best swaps of the timeslot: the event that is moved out of the second location is
+         *  moved on to a third location instead of back to the first. The compound moves are scored with the
+         *  surrogates together with the swaps, such that only the best ones are simulated.
+         */
+        bool _compound_moves = _compound_moves_default;
+
+        /*!
+         *	@brief      The number of best swaps of a timeslot that are extended to compound moves.
+         */
+        static constexpr int _compound_moves_nb_seeds = 10;
+
+        /*!
+         *	@brief      Execute path relinking between the elite solutions after the exploration?
+         *
+         *  Path relinking walks from one elite solution toward another by moving the events one by one to their location
+         *  in the guiding solution. The intermediate solutions are scored with the surrogates only, and only the most
+         *  promising ones are simulated with Menge.
+         */
+        bool _path_relinking = _path_relinking_default;
+
+        /*!
+         *	@brief      The number of best (distinct) solutions of _best_solutions between which paths are relinked.
+         */
+        static constexpr int _path_relinking_nb_elites = 5;
+
+        /*!
+         *	@brief      The number of intermediate solutions of all paths that are simulated with Menge.
+         */
+        static constexpr int _path_relinking_nb_simulated = 10;
+
 
         /*!
          *	@brief      Vector containing the timeslots in which the traveltimes are to be calculated.
@@ -436,6 +972,190 @@ namespace timetable
 
 
 
+        /*!
+         *	@brief      Seed the random number streams of the search from the run-level seed, such that a run can be reproduced.
+         */
+        void seed_random_streams();
+
+        /*!
+         *	@brief      Check whether a move is tabu.
+         *  @param      move        The move.
+         *  @returns    True if the move is one of the last _tabu_tenure moves.
+         */
+        bool is_tabu(const Swap& move) const;
+
+        /*!
+         *	@brief      Put a move in the tabu list.
+         *  @param      move        The move.
+         */
+        void add_tabu_move(const Swap& move);
+
+        /*!
+         *	@brief      Execute a move (a swap or a compound move) on a solution.
+         *  @param      sol         The solution.
+         *  @param      move        The move.
+         */
+        void apply_move(solution& sol, const Swap& move) const;
+
+        /*!
+         *	@brief      Reverse a move that has been executed with apply_move.
+         *  @param      sol         The solution.
+         *  @param      move        The move.
+         */
+        void undo_move(solution& sol, const Swap& move) const;
+
+        /*!
+         *	@brief      Initialise the tabu list and (reactive) tabu tenure at the start of the search.
+         *  @param      nb_possible_moves       The total number of feasible moves of the current solution.
+         */
+        void initialise_tabu_tenure(int nb_possible_moves);
+
+        /*!
+         *	@brief      Update the reactive tabu tenure with the current solution after a move.
+         *  @param      iteration       The iteration.
+         *  @returns    True if the search should escape with a diversification kick.
+         */
+        bool update_reactive_tabu_tenure(int iteration);
+
+        /*!
+         *	@brief      Execute a random walk from the current solution and evaluate the changed timeslots with Menge.
+         *  @param      remaining_budget        The remaining replication budget, which is decreased by the replications used.
+         *  @param      nb_replications         The number of replications of Menge to evaluate the changed timeslots.
+         *  @returns    False if the replication budget is exhausted.
+         */
+        bool diversification_kick(int& remaining_budget, int nb_replications);
+
+        /*!
+         *	@brief      Count the number of feasible moves in a timeslot of the current solution.
+         *  @param      timeslot    The timeslot.
+         *  @returns    The number of feasible moves.
+         */
+        int count_feasible_moves(int timeslot) const;
+
+        /*!
+         *	@brief      Initialise the selection of timeslots at the start of the search.
+         */
+        void initialise_timeslot_selection();
+
+        /*!
+         *	@brief      Recount the feasible moves of the timeslots of the current solution that changed since they were counted.
+         *
+         *  The current solution is changed by the moves of the search, the diversification kicks and the pipelined
+         *  search, so the timeslots are compared by their hash instead of being tracked at every change.
+         */
+        void refresh_timeslot_nb_moves();
+
+        /*!
+         *	@brief      Select the timeslot in which the moves of the next iteration are made.
+         *
+         *  Timeslots without feasible moves (in the current solution) are skipped.
+         *
+         *  @returns    The selected timeslot.
+         */
+        int select_timeslot();
+
+        /*!
+         *	@brief      Update the selection of timeslots after an iteration.
+         *  @param      timeslot        The timeslot of the iteration.
+         *  @param      improvement     The improvement of the objective value of the current solution in the iteration.
+         *  @param      replications    The number of replications of Menge spent in the iteration.
+         */
+        void update_timeslot_selection(int timeslot, double improvement, int replications);
+
+        /*!
+         *	@brief      Score all feasible moves in a timeslot with the surrogates.
+         *
+         *  With compound moves, the best swaps are extended to rotations of three locations, which are scored as well.
+         *  The moves are ranked relative to the surrogate objective value of the timeslot(s) in the current solution, such
+         *  that the moves of different timeslots can be compared on their improvement. Only reads the surrogates, such that different timeslots can be scored in parallel on different copies of the solution.
+         *
+         *  @param      sol                 The solution from which the moves are made (unchanged on return).
+         *  @param      timeslot            The timeslot.
+         *  @param      keep_all_moves      If false, only the best moves are kept.
+         *  @param      nb_moves_kept       The number of best moves that are kept.
+         *  @param      moves               The vector to which the (unsorted) moves are added.
+         */
+        void score_moves_timeslot(solution& sol, int timeslot, bool keep_all_moves, size_t nb_moves_kept, std::vector<Swap>& moves) const;
+
+        /*!
+         *	@brief      Evaluate the acquisition function for a move that has been scored with the surrogates.
+         *  @param      sol                 The solution from which the move is made (unchanged on return).
+         *  @param      swap                The move (with its surrogate prediction).
+         *  @param      current_value       The surrogate prediction of the timeslot(s) of the move without the move.
+         *  @returns    The value of the acquisition function (lower is better).
+         */
+        double acquisition_value(solution& sol, const Swap& swap, double current_value) const;
+
+        /*!
+         *	@brief      The hash of a timeslot and its neighbouring timeslots, on which the surrogate scores of the timeslot depend.
+         *  @param      sol             The solution.
+         *  @param      timeslot        The timeslot.
+         *  @returns    The hash.
+         */
+        std::uint64_t neighbourhood_hash(const solution& sol, int timeslot) const;
+
+        /*!
+         *	@brief      Get the moves of a timeslot of the current solution if they have been scored before (waits if still being scored).
+         *  @param      timeslot            The timeslot.
+         *  @param      keep_all_moves      If false, only the best moves are kept.
+         *  @param      nb_moves_kept       The number of best moves that are kept.
+         *  @param      moves               The vector in which the moves are put.
+         *  @returns    True if the moves were scored before.
+         */
+        bool take_scored_timeslot(int timeslot, bool keep_all_moves, size_t nb_moves_kept, std::vector<Swap>& moves);
+
+        /*!
+         *	@brief      Store the moves of a timeslot of the current solution, such that they can be reused.
+         *  @param      timeslot            The timeslot.
+         *  @param      keep_all_moves      If false, only the best moves are kept.
+         *  @param      nb_moves_kept       The number of best moves that are kept.
+         *  @param      moves               The scored moves.
+         */
+        void store_scored_timeslot(int timeslot, bool keep_all_moves, size_t nb_moves_kept, const std::vector<Swap>& moves);
+
+        /*!
+         *	@brief      Start scoring the moves of a timeslot of the current solution in the background.
+         *  @param      timeslot            The timeslot.
+         *  @param      keep_all_moves      If false, only the best moves are kept.
+         *  @param      nb_moves_kept       The number of best moves that are kept.
+         */
+        void speculate_scored_timeslot(int timeslot, bool keep_all_moves, size_t nb_moves_kept);
+
+        /*!
+         *	@brief      Discard the scored timeslots that do not match the current solution anymore.
+         */
+        void prune_scored_timeslots();
+
+        /*!
+         *	@brief      Wait for all background scorings to finish and discard all scored timeslots.
+         */
+        void clear_scored_timeslots();
+
+        /*!
+         *	@brief      Install the refined surrogates if they are ready, and start a new refinement if enough observations were added.
+         *  @returns    True if refined surrogates were installed.
+         */
+        bool update_online_refinement();
+
+        /*!
+         *	@brief      Configure the evaluator with the settings of the search.
+         */
+        void initialise_evaluator();
+
+        /*!
+         *	@brief      Build the context in which a search strategy explores the solution space.
+         *  @returns    The context.
+         */
+        search_context make_search_context();
+
+        /*!
+         *	@brief      Calculate the mean paired difference in objective value between a candidate move and the current solution.
+         *  @param      move                    The candidate move, with its Menge observations.
+         *  @param      mean_difference         The mean difference (candidate - current solution).
+         *  @param      stddev_mean_difference  The standard error of the mean difference.
+         */
+        void calculate_paired_difference(const Swap& move, double& mean_difference, double& stddev_mean_difference) const;
+
         /*!
          *	@brief      Tabu Search where we take the best surrogate solution to re-evaluate.
          */
@@ -443,30 +1163,229 @@ namespace timetable
 
         /*!
          *	@brief      Exploration loop for the Tabu Search.
+         *  @param      replication_budget      The number of replications of Menge the exploration can use.
+         *  @param      nb_replications         The number of replications of Menge to evaluate a (changed part of a) solution.
          */
-        void tabu_search_method_A_exploration_loop();
+        void tabu_search_method_A_exploration_loop(int replication_budget, int nb_replications);
 
 
 
 
         /*!
-         *	@brief      Recursive function that generates all possible solutions (for travels).
-         *  @param      current_event   The current event that needs to be scheduled (i.e., the current iteration).
+         *	@brief      An intermediate solution of path relinking.
+         */
+        struct relinking_intermediate
+        {
+            double obj_value_surrogate = 1e9;   ///< The objective value of the solution evaluated by the surrogates.
+            int initiating = -1;                ///< The index in _best_solutions of the solution from which the path started.
+            solution sol;                       ///< The solution (with the Menge observations of the initiating solution).
+        };
+
+        /*!
+         *	@brief      A path between two elite solutions.
+         */
+        struct relinking_path
+        {
+            int initiating = -1;                                ///< The index in _best_solutions of the solution from which the path starts.
+            int guiding = -1;                                   ///< The index in _best_solutions of the solution toward which the path walks.
+            std::vector<relinking_intermediate> intermediates;  ///< The best intermediate solutions on the path according to the surrogates.
+        };
+
+        /*!
+         *	@brief      Relink the best distinct solutions found and simulate the most promising intermediate solutions with Menge.
+         *
+         *  An intermediate solution of which the confidence interval overlaps with the best solution is added to _best_solutions.
+         */
+        void path_relinking();
+
+        /*!
+         *	@brief      Walk from the initiating toward the guiding solution of a path.
+         *
+         *  In every step, the event of which the move to its location in the guiding solution leads to the best objective
+         *  value according to the surrogates is moved (swapped with the event that is planned there).
+         *  Only reads the surrogates, such that different paths can be relinked in parallel.
+         *
+         *  @param      path        The path, to which the best intermediate solutions are added.
+         */
+        void relink(relinking_path& path) const;
+
+
+
+
+        /*!
+         *	@brief      The state of a worker of the exhaustive search, which enumerates one subtree of the solutions.
+         */
+        struct exhaustive_search_worker
+        {
+            solution sol;                                                           ///< The (partial) solution that is enumerated.
+            std::vector<std::pair<std::uint64_t, std::uint64_t>> cached_timeslots;  ///< The hashes of both timeslots of every timeslot pair in the last evaluated solution.
+            std::vector<std::vector<double>> cached_travels;                        ///< The simulated travel times of every timeslot pair in the last evaluated solution.
+            int nb_simulations = 0;                                                 ///< The number of simulations with Menge.
+            int nb_reused = 0;                                                      ///< The number of timeslot pairs of which the travel times were reused.
+
+            // branch and bound on the surrogates
+            std::vector<int> nb_unplanned_events;                                   ///< The number of events of every timeslot that are not planned yet.
+            std::vector<double> predictions_travels;                                ///< The surrogate prediction of the travel time of every complete timeslot pair.
+            std::vector<bool> predicted_travels;                                    ///< Indicates whether both timeslots of a timeslot pair are complete.
+            std::vector<std::pair<double, std::vector<int>>> screened_solutions;    ///< The surrogate objective value and the locations of the events of the solutions that were not bounded.
+            int nb_pruned = 0;                                                      ///< The number of subtrees that were bounded.
+        };
+
+        /*!
+         *	@brief      Find the interchangeable locations for the symmetry pruning of the exhaustive search.
+         *
+         *  Two locations are interchangeable if they belong to the same node of the surrogate paths and if the same events can be planned in them.
+         */
+        void initialise_interchangeable_locations();
+
+        /*!
+         *	@brief      Check whether the exhaustive search plans an event in a location.
+         *
+         *  With symmetry pruning, interchangeable locations are filled in order, such that only one of their permutations is enumerated.
+         *
+         *  @param      sol         The partial solution.
+         *  @param      event       The event.
+         *  @param      location    The location.
+         *  @returns    True if the event is planned in the location.
+         */
+        bool exhaustive_search_location_allowed(const solution& sol, int event, int location) const;
+
+        /*!
+         *	@brief      Split the enumeration of the exhaustive search into independent subtrees.
+         *  @param      timeslot    The timeslot that is enumerated (evacuations), or -1 if all timeslots are enumerated (travels).
+         *  @returns    The locations of the first events (-1 if not enumerated) for every subtree.
+         */
+        std::vector<std::vector<int>> split_exhaustive_search(int timeslot) const;
+
+        /*!
+         *	@brief      Enumerate all subtrees of the exhaustive search in parallel.
+         *  @param      timeslot    The timeslot that is enumerated (evacuations), or -1 if all timeslots are enumerated (travels).
          */
-        void generate_all_possible_solutions(int current_event);
+        void run_exhaustive_search_subtrees(int timeslot);
 
         /*!
-         *	@brief      Recursive function that generates all possible solutions for each timeslot independently (for evacuations).
-         *  @param      timeslot    The timeslot for which we generate all possible solutions
+         *	@brief      Recursive function that generates all possible solutions.
+         *  @param      worker          The worker that enumerates the subtree.
+         *  @param      timeslot        The timeslot for which we generate all possible solutions (evacuations), or -1 for all timeslots (travels).
          *  @param      current_event   The current event that needs to be scheduled (i.e., the current iteration).
          */
-        void generate_all_possible_solutions_independently(int timeslot, int current_event);
+        void generate_all_possible_solutions(exhaustive_search_worker& worker, int timeslot, int current_event);
+
+        /*!
+         *	@brief      Simulate and report a solution generated by the exhaustive search.
+         *
+         *  For travels, only the timeslot pairs that changed since the last solution of the worker are simulated.
+         *
+         *  @param      worker          The worker that enumerates the subtree.
+         *  @param      timeslot        The timeslot for which we generate all possible solutions (evacuations), or -1 for all timeslots (travels).
+         */
+        void evaluate_exhaustive_search_solution(exhaustive_search_worker& worker, int timeslot);
+
+        /*!
+         *	@brief      Exhaustive search in which the enumeration is bounded with the surrogates.
+         *
+         *  The (partial) solutions are scored with the surrogates first. A subtree is bounded if its surrogate lower bound exceeds the
+         *  best surrogate objective value plus the error margin of the surrogates. Only the solutions within the error margin of the
+         *  best one are simulated with Menge, by the threads of the pool concurrently (every simulation runs in a Menge worker process
+         *  of its own).
+         *
+         *  @param      timeslot    The timeslot that is enumerated (evacuations), or -1 if all timeslots are enumerated (travels).
+         *  @param      subtrees    The independent subtrees of the enumeration.
+         */
+        void run_exhaustive_branch_and_bound(int timeslot, std::vector<std::vector<int>>& subtrees);
+
+        /*!
+         *	@brief      Initialise the surrogate predictions of a worker of the branch and bound for its (partial) solution.
+         *  @param      worker          The worker that enumerates the subtree.
+         *  @param      timeslot        The timeslot for which we generate all possible solutions (evacuations), or -1 for all timeslots (travels).
+         */
+        void initialise_exhaustive_bounds(exhaustive_search_worker& worker, int timeslot);
+
+        /*!
+         *	@brief      Update the surrogate predictions of a worker of the branch and bound after planning or unplanning an event.
+         *  @param      worker          The worker that enumerates the subtree.
+         *  @param      event           The event.
+         *  @param      planned         True if the event has been planned, false if it has been unplanned.
+         */
+        void update_exhaustive_bounds(exhaustive_search_worker& worker, int event, bool planned);
+
+        /*!
+         *	@brief      The surrogate lower bound on the objective value of all solutions in the subtree of a worker.
+         *  @param      worker          The worker that enumerates the subtree.
+         *  @param      timeslot        The timeslot for which we generate all possible solutions (evacuations), or -1 for all timeslots (travels).
+         *  @returns    The lower bound.
+         */
+        double exhaustive_lower_bound(const exhaustive_search_worker& worker, int timeslot) const;
+
+        /*!
+         *	@brief      Score a solution generated by the branch and bound with the surrogates, and keep it if it is not bounded.
+         *  @param      worker          The worker that enumerates the subtree.
+         *  @param      timeslot        The timeslot for which we generate all possible solutions (evacuations), or -1 for all timeslots (travels).
+         */
+        void screen_exhaustive_search_solution(exhaustive_search_worker& worker, int timeslot);
+
+        /*!
+         *	@brief      Indicates whether the exhaustive search skips permutations of interchangeable locations.
+         *
+         *  The simulations of the skipped permutations are assumed to be equal to those of the enumerated one.
+         */
+        bool _exhaustive_symmetry_pruning = _exhaustive_symmetry_pruning_default;
+
+        /*!
+         *	@brief      Indicates whether the exhaustive search bounds the enumeration with the surrogates.
+         */
+        bool _exhaustive_branch_and_bound = _exhaustive_branch_and_bound_default;
+
+        /*!
+         *	@brief      The number of standard errors of the difference between two surrogate objective values in the error margin of the branch and bound.
+         */
+        static constexpr double _branch_and_bound_confidence = 2.0;
+
+        /*!
+         *	@brief      The best surrogate objective value found by the branch and bound.
+         */
+        std::atomic<double> _exhaustive_incumbent;
+
+        /*!
+         *	@brief      The error margin of the surrogates in the branch and bound (from their errors in the cross-validation).
+         */
+        double _exhaustive_margin = 0.0;
+
+        /*!
+         *	@brief      The lower bound on the surrogate prediction of the travel time of an incomplete timeslot pair.
+         */
+        double _exhaustive_lower_bound_travels = 0.0;
+
+        /*!
+         *	@brief      For every location, the previous interchangeable location (-1 if none).
+         */
+        std::vector<int> _previous_interchangeable_location;
+
+        /*!
+         *	@brief      Synchronises the reporting of the workers of the exhaustive search.
+         */
+        QMutex _exhaustive_search_mutex;
 
         /*!
          *	@brief      The number of the current solution evaluated by exhaustive search.
          */
         int exhaustive_search_solutions_number = 0;
 
+        /*!
+         *	@brief      The number of simulations with Menge of the exhaustive search.
+         */
+        int exhaustive_search_simulations_number = 0;
+
+        /*!
+         *	@brief      The number of timeslot pairs of which the travel times were reused by the exhaustive search.
+         */
+        int exhaustive_search_reused_number = 0;
+
+        /*!
+         *	@brief      The number of subtrees that were bounded by the branch and bound.
+         */
+        int exhaustive_search_pruned_number = 0;
+
     };
 
 } // namespace timetable
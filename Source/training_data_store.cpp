@@ -0,0 +1,132 @@
+#include "training_data_store.h"
+
+#include <QFile>
+#include <QDataStream>
+#include <stdexcept>
+
+namespace
+{
+    // All data are written in the same binary format, independent of the platform
+    void configure_stream(QDataStream& stream)
+    {
+        stream.setVersion(QDataStream::Qt_5_0);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+    }
+}
+
+
+
+namespace ml
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    training_data_store::training_data_store(const QString& filename, std::uint64_t key, int nb_features)
+        : _filename(filename), _key(key), _nb_features(nb_features)
+    {
+
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    QString training_data_store::file_name(const QString& prefix, std::uint64_t key)
+    {
+        return prefix + "_" + QString("%1").arg(static_cast<qulonglong>(key), 16, 16, QChar('0')) + ".bin";
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    int training_data_store::load(std::vector<dlib::matrix<double,0,1>>& x_obs, std::vector<double>& y_obs)
+    {
+        _checked = true;
+        _header_valid = false;
+        _valid_size = 0;
+
+        QFile file(_filename);
+        if(!file.open(QIODevice::ReadOnly))
+            return 0;
+
+        QDataStream stream(&file);
+        configure_stream(stream);
+
+        // 1. header
+        quint32 magic_number = 0, format_version = 0;
+        quint64 key = 0;
+        qint32 nb_features = 0;
+        stream >> magic_number >> format_version >> key >> nb_features;
+        if(stream.status() != QDataStream::Ok || magic_number != _magic_number || format_version != _format_version
+                || key != _key || nb_features != _nb_features)
+            return 0;
+        _header_valid = true;
+        _valid_size = file.pos();
+
+        // 2. observations (an incomplete observation at the end is ignored)
+        int nb_read = 0;
+        while(!stream.atEnd())
+        {
+            double y = 0.0;
+            dlib::matrix<double,0,1> x;
+            x.set_size(_nb_features);
+            stream >> y;
+            for(int j = 0; j < _nb_features; ++j)
+                stream >> x(j);
+            if(stream.status() != QDataStream::Ok)
+                break;
+
+            x_obs.push_back(x);
+            y_obs.push_back(y);
+            _valid_size = file.pos();
+            ++nb_read;
+        }
+
+        return nb_read;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void training_data_store::append(const dlib::matrix<double,0,1>& x, double y)
+    {
+        if(x.size() != _nb_features)
+            throw std::runtime_error("Error in function ml::training_data_store::append. \nThe sample has the wrong number of features.");
+
+        if(!_checked)
+        {
+            std::vector<dlib::matrix<double,0,1>> x_obs;
+            std::vector<double> y_obs;
+            load(x_obs, y_obs);
+        }
+
+        QFile file(_filename);
+        if(_header_valid)
+        {
+            // drop an incomplete observation at the end of the file
+            if(file.size() > _valid_size)
+                file.resize(_valid_size);
+            if(!file.open(QIODevice::WriteOnly | QIODevice::Append))
+                throw std::runtime_error("Error in function ml::training_data_store::append. \nCouldn't open file.");
+        }
+        else
+        {
+            if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+                throw std::runtime_error("Error in function ml::training_data_store::append. \nCouldn't open file.");
+        }
+
+        QDataStream stream(&file);
+        configure_stream(stream);
+
+        if(!_header_valid)
+            stream << _magic_number << _format_version << static_cast<quint64>(_key) << static_cast<qint32>(_nb_features);
+
+        stream << y;
+        for(int j = 0; j < _nb_features; ++j)
+            stream << x(j);
+
+        file.flush();
+        if(stream.status() != QDataStream::Ok)
+            throw std::runtime_error("Error in function ml::training_data_store::append. \nCouldn't write to file.");
+
+        _header_valid = true;
+        _valid_size = file.size();
+    }
+
+} // namespace ml
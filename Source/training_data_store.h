@@ -0,0 +1,120 @@
+/*
+ *	Code for the surrogate-based tabu search algorithm
+ *  to optimise people flows in a timetable.
+ *
+ *	Code author: Hendrik Vermuyten
+ */
+
+/*!
+ *	@file		training_data_store.h
+ *  @author     Hendrik Vermuyten
+ *	@brief		A binary, append-only file that stores the simulated training data of a surrogate between runs.
+ */
+
+#ifndef TRAINING_DATA_STORE_H
+#define TRAINING_DATA_STORE_H
+
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+#include <cstdint>
+
+#include <dlib/matrix.h>
+
+/*!
+ *  @namespace ml
+ *  @brief	The namespace containing all machine learning elements.
+ */
+namespace ml
+{
+    /*!
+     *	@brief		A binary, append-only file with the observations (samples and simulated values) of a surrogate.
+     *
+     *  The file starts with a header that contains a format version, the key of the data and the number of features.
+     *  The key is a hash of everything the simulated values depend on (building, pedestrian model, ...), such that
+     *  observations are only reused for the same simulation set-up. Every observation is appended (and flushed) as soon
+     *  as it has been simulated, so a run that is halted or crashes keeps the observations simulated so far.
+     *  An incomplete observation at the end of the file (e.g. after a crash) is ignored and overwritten.
+     */
+    class training_data_store
+    {
+    public:
+        /*!
+         *	@brief      Constructor.
+         *  @param      filename        The name of the file.
+         *  @param      key             The key (hash of the simulation set-up) of the data.
+         *  @param      nb_features     The number of features of a sample.
+         */
+        training_data_store(const QString& filename, std::uint64_t key, int nb_features);
+
+        /*!
+         *	@brief      The default name of the file for a type of training data and a key.
+         *  @param      prefix      The type of training data (e.g. "training_data_evac").
+         *  @param      key         The key of the data.
+         *  @returns    The name of the file.
+         */
+        static QString file_name(const QString& prefix, std::uint64_t key);
+
+        /*!
+         *	@brief      Read all observations stored in the file, if its version, key and number of features match.
+         *  @param      x_obs       Vector to which the samples are added.
+         *  @param      y_obs       Vector to which the simulated values are added.
+         *  @returns    The number of observations read.
+         */
+        int load(std::vector<dlib::matrix<double,0,1>>& x_obs, std::vector<double>& y_obs);
+
+        /*!
+         *	@brief      Append an observation to the file.
+         *
+         *  If the file does not exist or does not match (see load), it is recreated.
+         *
+         *  @param      x       The sample.
+         *  @param      y       The simulated value.
+         */
+        void append(const dlib::matrix<double,0,1>& x, double y);
+
+    private:
+        /*!
+         *	@brief      Identifies a training data file.
+         */
+        static constexpr quint32 _magic_number = 0x54445354; // "TDST"
+
+        /*!
+         *	@brief      The version of the file format.
+         */
+        static constexpr quint32 _format_version = 1;
+
+        /*!
+         *	@brief      The name of the file.
+         */
+        QString _filename;
+
+        /*!
+         *	@brief      The key of the data.
+         */
+        std::uint64_t _key;
+
+        /*!
+         *	@brief      The number of features of a sample.
+         */
+        int _nb_features;
+
+        /*!
+         *	@brief      Indicates whether the file has been checked (by load).
+         */
+        bool _checked = false;
+
+        /*!
+         *	@brief      Indicates whether the file exists and has a matching header.
+         */
+        bool _header_valid = false;
+
+        /*!
+         *	@brief      The size in bytes of the header and all complete observations in the file.
+         */
+        qint64 _valid_size = 0;
+    };
+
+} // namespace ml
+
+#endif // TRAINING_DATA_STORE_H